@@ -31,17 +31,20 @@ SOFTWARE.
 
 #include "example.h"
 #include <stdlib.h>
+#include <limits.h>
 
 static int test_buffer[8];
 
+static int cli_example_number(const char *text, int *value);
+
 /**
 * @brief 	Command: Example function in CLI init.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
 */
 int cli_example_init(cli_t *cli) {
-	cli_add(cli, "example", cli_function_example, "Example command");
-	cli_add(cli, "read_buffer", cli_function_read_buffer, "Read from test buffer");
-	cli_add(cli, "write_buffer", cli_function_write_buffer, "Write to test buffer");
+	CLI_COMMAND_DEFINE(cli, "example", cli_function_example, "Example command");
+	CLI_COMPLETE_DEFINE(cli, "read_buffer", cli_function_read_buffer, "Read from test buffer", cli_complete_read_buffer);
+	CLI_COMPLETE_DEFINE(cli, "write_buffer", cli_function_write_buffer, "Write to test buffer", cli_complete_write_buffer);
 	return 0;
 }
 
@@ -56,41 +59,42 @@ int cli_example_init(cli_t *cli) {
 */
 int cli_function_read_buffer(cli_t *cli, int argc, char *argv[]) {
 	/* Default */
-	int start_address = 0;
+	int start_address = -1;
 	int count = 1;
 
 
 	/* Parse */
-	for (int i = 0; i < argc; i++) {
+	for (int i = 1; i < argc; i++) {
 		if ((!strcmp(argv[i], "-h")) | (!strcmp(argv[i], "--help"))) {
 
 			goto label_help;
 		}
 
 		if ((!strcmp(argv[i], "-c")) | (!strcmp(argv[i], "--count"))) {
-			if (i > argc - 1) {
+			if (i + 1 >= argc) {
 				cli_printf(cli, "Need more argument for -c (--count)\r\n");
 				return EXIT_FAILURE;
 			}
-			count = (int)(strtol(argv[i + 1], NULL, 10));
-		}
-
-		if ((!strcmp(argv[i], "-a")) | (!strcmp(argv[i], "--all"))) {
+			if (cli_example_number(argv[++i], &count) || (count < 1)) {
+				cli_printf(cli, "Invalid count '%s'\r\n", argv[i]);
+				return EXIT_FAILURE;
+			}
+		} else if ((!strcmp(argv[i], "-a")) | (!strcmp(argv[i], "--all"))) {
 			start_address = 0;
 			count = 8;
 			goto label_read;
+		} else if (cli_example_number(argv[i], &start_address)) {
+			cli_printf(cli, "Invalid address '%s'\r\n", argv[i]);
+			return EXIT_FAILURE;
 		}
 	}
 
-	for (int i = 1; i < argc; i++) {
-		if (argv[i][0] != '-') {
-			start_address = (int)(strtol(argv[i + 1], NULL, 10));
-			if (start_address + count > 8) {
-				cli_printf(cli, "Invalid buffer address. Value must be [0 .. 7] and '--count' [8 .. 1]\r\n");
-				return EXIT_FAILURE;
-			}
-			goto label_read;
+	if (start_address >= 0) {
+		if (start_address + count > 8) {
+			cli_printf(cli, "Invalid buffer address. Value must be [0 .. 7] and '--count' [8 .. 1]\r\n");
+			return EXIT_FAILURE;
 		}
+		goto label_read;
 	}
 
 label_help:
@@ -104,10 +108,24 @@ label_help:
 	return EXIT_SUCCESS;
 
 label_read:
+#if (CLI_ENABLE_EMIT == TRUE)
+	/* Text: 'buffer[3]=0x0001', JSON: '{"address":3,"buffer":[1]}' */
+	cli_emit_begin_object(cli, NULL);
+	if (cli_emit_format(cli) != CLI_FORMAT_TEXT) {
+		cli_emit_kv_int(cli, "address", start_address);
+	}
+	cli_emit_begin_array(cli, "buffer", start_address);
+	for (int i = 0; i < count; i++) {
+		cli_emit_kv_hex(cli, NULL, test_buffer[start_address + i], 4);
+	}
+	cli_emit_end_array(cli);
+	cli_emit_end_object(cli);
+#else
 	for (int i = 0; i < count; i++) {
 		int index = start_address + i;
 		cli_printf(cli, "buffer[%d]=0x%.4x\r\n", index, test_buffer[index]);
 	}
+#endif
 	return EXIT_SUCCESS;
 }
 
@@ -123,7 +141,6 @@ label_read:
 int cli_function_write_buffer(cli_t *cli, int argc, char *argv[]) {
 	/* Default */
 	int start_address = 0;
-	int index_address = 0;
 
 	/* Parse */
 	for (int i = 0; i < argc; i++) {
@@ -136,13 +153,11 @@ int cli_function_write_buffer(cli_t *cli, int argc, char *argv[]) {
 		}
 	}
 
-	for (int i = 1; i < argc; i++) {
-		start_address = (int) (strtol(argv[i], NULL, 10));
-		if (start_address > 8) {
+	if (argc > 1) {
+		if (cli_example_number(argv[1], &start_address) || (start_address < 0) || (start_address > 7)) {
 			cli_printf(cli,	"Invalid address. Value must be [0 .. 7]\r\n");
 			return EXIT_FAILURE;
 		}
-		index_address = i;
 		goto label_write;
 	}
 
@@ -162,22 +177,110 @@ label_clear:
 	return EXIT_SUCCESS;
 
 label_write:
-	int count = 0;
-	for (int i = index_address; i < argc; i++) {
-		if ((start_address + count) > 8 ){
-			cli_printf(cli,	"Invalid value for address.\r\n");
+	/* All the values are checked before the buffer is changed */
+	if (start_address + (argc - 2) > 8) {
+		cli_printf(cli,	"Invalid value for address.\r\n");
+		return EXIT_FAILURE;
+	}
+	for (int i = 2; i < argc; i++) {
+		int value;
+		if (cli_example_number(argv[i], &value)) {
+			cli_printf(cli, "Invalid value '%s'\r\n", argv[i]);
 			return EXIT_FAILURE;
 		}
-		if (argv[i][0] != '-') {
-			test_buffer[start_address + count] = (int)(strtol(argv[i + 1], NULL, 10));
-			count++;
-		}
+	}
+	for (int i = 2; i < argc; i++) {
+		cli_example_number(argv[i], &test_buffer[start_address + i - 2]);
 	}
 	return EXIT_SUCCESS;
 }
 
+/**
+* @brief 	Parse the decimal number of the argument.
+* @param	text The argument.
+* @param	value Returns the number.
+* @retval 	(0) if success.
+* @retval   (!0) if the argument is not a number.
+*/
+static int cli_example_number(const char *text, int *value) {
+	char *end;
+	long number = strtol(text, &end, 10);
+	if ((end == text) || (*end != '\0') || (number < INT_MIN) || (number > INT_MAX)) {
+		return 1;
+	}
+	*value = (int)number;
+	return 0;
+}
+
 
 
+#if (CLI_ENABLE_COMPLETION == TRUE)
+/**
+* @brief 	Add the digits to the candidates.
+* @param	complete The candidates.
+* @param	from The first digit.
+* @param	to The last digit.
+*/
+static void cli_example_numbers(cli_complete_t *complete, int from, int to) {
+	for (int i = from; i <= to; i++) {
+		const char text[] = {'0' + i, 0};
+		cli_complete_add(complete, text);
+	}
+}
+
+/**
+* @brief 	Add the options to the candidates.
+* @param	complete The candidates.
+* @param	options The options, the list ends with NULL.
+*/
+static void cli_example_options(cli_complete_t *complete, const char *const options[]) {
+	for (int i = 0; options[i] != NULL; i++) {
+		cli_complete_add(complete, options[i]);
+	}
+}
+
+/**
+* @brief 	Completion of the arguments of `read_buffer`: the options, the
+*       	addresses and the counts after '-c'.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of the words, the last one is under the cursor.
+* @param 	argv[] Array of the words.
+* @param	complete The candidates.
+* @retval 	(0) if success.
+*/
+int cli_complete_read_buffer(cli_t *cli, int argc, char *argv[], cli_complete_t *complete) {
+	static const char *const options[] = {"-h", "--help", "-c", "--count", "-a", "--all", NULL};
+	const char *previous = argv[argc - 2];
+	if (argv[argc - 1][0] == '-') {
+		cli_example_options(complete, options);
+	} else if (!strcmp(previous, "-c") || !strcmp(previous, "--count")) {
+		cli_example_numbers(complete, 1, 8);
+	} else {
+		cli_example_numbers(complete, 0, 7);
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Completion of the arguments of `write_buffer`: the options and
+*       	the address, the values are not completed.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of the words, the last one is under the cursor.
+* @param 	argv[] Array of the words.
+* @param	complete The candidates.
+* @retval 	(0) if success.
+*/
+int cli_complete_write_buffer(cli_t *cli, int argc, char *argv[], cli_complete_t *complete) {
+	static const char *const options[] = {"-h", "--help", "-c", "--clear", NULL};
+	if (argv[argc - 1][0] == '-') {
+		cli_example_options(complete, options);
+	} else if (argc == 2) {
+		cli_example_numbers(complete, 0, 7);
+	}
+	return EXIT_SUCCESS;
+}
+#endif
+
 /**
 * @brief 	Command: Example function in CLI. Print all argv.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
@@ -188,9 +291,21 @@ label_write:
 * @retval   Error code (!0) if error.
 */
 int cli_function_example(cli_t *cli, int argc, char* argv[]) {
+#if (CLI_ENABLE_EMIT == TRUE)
+	cli_emit_begin_object(cli, NULL);
+	cli_emit_kv_str(cli, "command", "example");
+	cli_emit_kv_int(cli, "argc", argc);
+	cli_emit_begin_array(cli, "argv", 0);
+	for (int i = 0; i < argc; i++) {
+		cli_emit_kv_str(cli, NULL, argv[i]);
+	}
+	cli_emit_end_array(cli);
+	cli_emit_end_object(cli);
+#else
 	cli_printf(cli, "Example command\r\n");
 	for (int i = 0; i < argc; i++) {
 		cli_printf(cli, "\targv[%d] - '%s'\r\n", i, argv[i]);
 	}
+#endif
 	return EXIT_SUCCESS;
 }
@@ -39,5 +39,9 @@ int cli_example_init(cli_t *cli);
 int cli_function_read_buffer(cli_t *cli, int argc, char *argv[]);
 int cli_function_write_buffer(cli_t *cli, int argc, char *argv[]);
 int cli_function_example(cli_t *cli, int argc, char* argv[]);
+#if (CLI_ENABLE_COMPLETION == TRUE)
+int cli_complete_read_buffer(cli_t *cli, int argc, char *argv[], cli_complete_t *complete);
+int cli_complete_write_buffer(cli_t *cli, int argc, char *argv[], cli_complete_t *complete);
+#endif
 
 #endif /* CLI_FUNCTION_EXAMPLE_H_ */
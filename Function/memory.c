@@ -0,0 +1,478 @@
+/*
+*******************************************************************************
+@file	memory.c
+@brief	Commands for inspecting and changing memory: md, mw, mfill, mcmp.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "memory.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+#if (CLI_MEMORY_ENABLE == TRUE)
+
+/* Bytes in one row of the dump */
+#define CLI_MEMORY_ROW            16
+/* Bytes in one line of base64 (64 characters) */
+#define CLI_MEMORY_BASE64_LINE    48
+/* Number of hex digits in the address */
+#define CLI_MEMORY_ADDRESS_DIGITS ((int)sizeof(uintptr_t) * 2)
+
+/* Table of the hex representation of every byte */
+#define CLI_HEX_DIGIT(n)  (((n) < 10) ? ('0' + (n)) : ('a' - 10 + (n)))
+#define CLI_HEX1(n)       { CLI_HEX_DIGIT((n) >> 4), CLI_HEX_DIGIT((n) & 15) }
+#define CLI_HEX4(n)       CLI_HEX1(n), CLI_HEX1((n) + 1), CLI_HEX1((n) + 2), CLI_HEX1((n) + 3)
+#define CLI_HEX16(n)      CLI_HEX4(n), CLI_HEX4((n) + 4), CLI_HEX4((n) + 8), CLI_HEX4((n) + 12)
+#define CLI_HEX64(n)      CLI_HEX16(n), CLI_HEX16((n) + 16), CLI_HEX16((n) + 32), CLI_HEX16((n) + 48)
+static const char cli_hex[256][2] = {
+	CLI_HEX64(0), CLI_HEX64(64), CLI_HEX64(128), CLI_HEX64(192)
+};
+
+static const char cli_base64[64] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static char *cli_memory_hex(char *out, uintptr_t value, int bytes);
+static uint32_t cli_memory_read(uintptr_t address, int width);
+static void cli_memory_write(uintptr_t address, int width, uint32_t value);
+static int cli_memory_width(const char *text);
+static int cli_memory_dump_hex(cli_t *cli, uintptr_t address, size_t length, int width);
+static int cli_memory_dump_base64(cli_t *cli, const uint8_t *data, size_t length);
+
+/**
+* @brief 	Command: Add the memory commands to the CLI.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*/
+int cli_memory_init(cli_t *cli) {
+	CLI_COMMAND_DEFINE(cli, "md", cli_function_md, "Memory dump");
+	CLI_COMMAND_DEFINE(cli, "mw", cli_function_mw, "Memory write");
+	CLI_COMMAND_DEFINE(cli, "mfill", cli_function_mfill, "Memory fill");
+	CLI_COMMAND_DEFINE(cli, "mcmp", cli_function_mcmp, "Memory compare");
+	return 0;
+}
+
+/**
+* @brief 	Command: Dump the memory in hex, base64 or binary.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_md(cli_t *cli, int argc, char *argv[]) {
+	/* Default */
+	int width = 1;
+	int mode = 'x';
+	int count = 0;
+	uintptr_t address = 0;
+	size_t length = CLI_MEMORY_ROW;
+
+	/* Parse */
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-h")) | (!strcmp(argv[i], "--help"))) {
+			goto label_help;
+		}
+		if ((!strcmp(argv[i], "-w")) | (!strcmp(argv[i], "--width"))) {
+			if ((i + 1 >= argc) || !(width = cli_memory_width(argv[++i]))) {
+				cli_printf(cli, "Width must be 1, 2 or 4\r\n");
+				return EXIT_FAILURE;
+			}
+			continue;
+		}
+		if ((!strcmp(argv[i], "-b")) | (!strcmp(argv[i], "--base64"))) {
+			mode = 'b';
+			continue;
+		}
+		if ((!strcmp(argv[i], "-r")) | (!strcmp(argv[i], "--raw"))) {
+			mode = 'r';
+			continue;
+		}
+		if (argv[i][0] != '-') {
+			if (count == 0) {
+				address = (uintptr_t)strtoull(argv[i], NULL, 0);
+			} else {
+				length = (size_t)strtoull(argv[i], NULL, 0);
+			}
+			count++;
+		}
+	}
+	if (count == 0) {
+		goto label_help;
+	}
+	if ((address | length) & (width - 1)) {
+		cli_printf(cli, "Address and length must be aligned to the width\r\n");
+		return EXIT_FAILURE;
+	}
+
+	switch (mode) {
+	case 'b':
+		return cli_memory_dump_base64(cli, (const uint8_t *)address, length);
+	case 'r':
+		cli_write(cli, (const char *)address, length);
+		return EXIT_SUCCESS;
+	default:
+		return cli_memory_dump_hex(cli, address, length, width);
+	}
+
+label_help:
+	cli_printf(cli, "Usage: %s ADDRESS [LENGTH]\r\n", argv[0]);
+	cli_printf(cli, "Examples: %s 0x20000000 64 -w 4\r\n", argv[0]);
+	cli_printf(cli, "Option: \r\n");
+	cli_printf(cli, "\t-h, --help        print information about function\r\n");
+	cli_printf(cli, "\t-w, --width       Access width: 1, 2 or 4 bytes.\r\n");
+	cli_printf(cli, "\t-b, --base64      Print in base64.\r\n");
+	cli_printf(cli, "\t-r, --raw         Send the memory as is (binary).\r\n");
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Command: Write values to the memory.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_mw(cli_t *cli, int argc, char *argv[]) {
+	/* Default */
+	int width = 4;
+	int count = 0;
+	uintptr_t address = 0;
+
+	/* Parse */
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-h")) | (!strcmp(argv[i], "--help"))) {
+			goto label_help;
+		}
+		if ((!strcmp(argv[i], "-w")) | (!strcmp(argv[i], "--width"))) {
+			if ((i + 1 >= argc) || !(width = cli_memory_width(argv[++i]))) {
+				cli_printf(cli, "Width must be 1, 2 or 4\r\n");
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-w")) | (!strcmp(argv[i], "--width"))) {
+			i++;
+			continue;
+		}
+		uintptr_t value = (uintptr_t)strtoull(argv[i], NULL, 0);
+		if (count++ == 0) {
+			address = value;
+			if (address & (width - 1)) {
+				cli_printf(cli, "Address must be aligned to the width\r\n");
+				return EXIT_FAILURE;
+			}
+			continue;
+		}
+		cli_memory_write(address, width, (uint32_t)value);
+		address += width;
+	}
+	if (count < 2) {
+		goto label_help;
+	}
+	return EXIT_SUCCESS;
+
+label_help:
+	cli_printf(cli, "Usage: %s ADDRESS VALUE [VALUE_2] ...\r\n", argv[0]);
+	cli_printf(cli, "Examples: %s 0x20000000 0x12345678\r\n", argv[0]);
+	cli_printf(cli, "Option: \r\n");
+	cli_printf(cli, "\t-h, --help        print information about function\r\n");
+	cli_printf(cli, "\t-w, --width       Access width: 1, 2 or 4 bytes (4 by default).\r\n");
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Command: Fill the memory with a value.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_mfill(cli_t *cli, int argc, char *argv[]) {
+	/* Default */
+	int width = 1;
+	int count = 0;
+	uintptr_t args[3] = { 0 };
+
+	/* Parse */
+	for (int i = 1; i < argc; i++) {
+		if ((!strcmp(argv[i], "-h")) | (!strcmp(argv[i], "--help"))) {
+			goto label_help;
+		}
+		if ((!strcmp(argv[i], "-w")) | (!strcmp(argv[i], "--width"))) {
+			if ((i + 1 >= argc) || !(width = cli_memory_width(argv[++i]))) {
+				cli_printf(cli, "Width must be 1, 2 or 4\r\n");
+				return EXIT_FAILURE;
+			}
+			continue;
+		}
+		if (count < 3) {
+			args[count++] = (uintptr_t)strtoull(argv[i], NULL, 0);
+		}
+	}
+	if (count < 3) {
+		goto label_help;
+	}
+	if ((args[0] | args[1]) & (width - 1)) {
+		cli_printf(cli, "Address and length must be aligned to the width\r\n");
+		return EXIT_FAILURE;
+	}
+	if (width == 1) {
+		memset((void *)args[0], (int)args[2], args[1]);
+	} else {
+		for (uintptr_t offset = 0; offset < args[1]; offset += width) {
+			cli_memory_write(args[0] + offset, width, (uint32_t)args[2]);
+		}
+	}
+	return EXIT_SUCCESS;
+
+label_help:
+	cli_printf(cli, "Usage: %s ADDRESS LENGTH VALUE\r\n", argv[0]);
+	cli_printf(cli, "Examples: %s 0x20000000 256 0xff\r\n", argv[0]);
+	cli_printf(cli, "Option: \r\n");
+	cli_printf(cli, "\t-h, --help        print information about function\r\n");
+	cli_printf(cli, "\t-w, --width       Access width: 1, 2 or 4 bytes.\r\n");
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Command: Compare two memory areas.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if the areas are equal.
+* @retval   (1) if the areas differ.
+*/
+int cli_function_mcmp(cli_t *cli, int argc, char *argv[]) {
+	if ((argc < 4) || (!strcmp(argv[1], "-h")) || (!strcmp(argv[1], "--help"))) {
+		cli_printf(cli, "Usage: %s ADDRESS_1 ADDRESS_2 LENGTH\r\n", argv[0]);
+		cli_printf(cli, "Prints the first %d differences.\r\n", CLI_MEMORY_ROW);
+		return EXIT_SUCCESS;
+	}
+	const uint8_t *first = (const uint8_t *)(uintptr_t)strtoull(argv[1], NULL, 0);
+	const uint8_t *second = (const uint8_t *)(uintptr_t)strtoull(argv[2], NULL, 0);
+	size_t length = (size_t)strtoull(argv[3], NULL, 0);
+
+	size_t differences = 0;
+	size_t offset = 0;
+	while (offset < length) {
+		/* Skip the equal part in one call */
+		if (!memcmp(first + offset, second + offset, length - offset)) break;
+		while (first[offset] == second[offset]) offset++;
+		if (differences++ < CLI_MEMORY_ROW) {
+			char row[2 * CLI_MEMORY_ADDRESS_DIGITS + 16];
+			char *out = cli_memory_hex(row, (uintptr_t)(first + offset), sizeof(uintptr_t));
+			*out++ = ':'; *out++ = ' ';
+			out = cli_memory_hex(out, first[offset], 1);
+			*out++ = ' '; *out++ = ' ';
+			out = cli_memory_hex(out, (uintptr_t)(second + offset), sizeof(uintptr_t));
+			*out++ = ':'; *out++ = ' ';
+			out = cli_memory_hex(out, second[offset], 1);
+			*out++ = '\r'; *out++ = '\n';
+			cli_write(cli, row, out - row);
+		}
+		offset++;
+	}
+	if (differences) {
+		cli_printf(cli, "%u differences\r\n", (unsigned int)differences);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Print the memory as hex rows with the address and, for the byte
+*       	width, the characters. Each row is formatted in the buffer
+*       	and sent with one call.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	address Start address.
+* @param	length Number of bytes.
+* @param	width Access width.
+* @return 	`int` Function success or error code.
+*/
+static int cli_memory_dump_hex(cli_t *cli, uintptr_t address, size_t length, int width) {
+	/* Address, ": ", 16 * "xx ", " |", 16 characters, "|\r\n" */
+	char row[CLI_MEMORY_ADDRESS_DIGITS + 2 + CLI_MEMORY_ROW * 3 + 2 + CLI_MEMORY_ROW + 3];
+	for (size_t offset = 0; offset < length; offset += CLI_MEMORY_ROW) {
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+		if (cli_tx_room(cli) < 0) {
+			/* 'q' in the pager: the rest is not even read */
+			break;
+		}
+#endif
+		size_t count = length - offset;
+		if (count > CLI_MEMORY_ROW) {
+			count = CLI_MEMORY_ROW;
+		}
+		char *out = cli_memory_hex(row, address + offset, sizeof(uintptr_t));
+		*out++ = ':';
+		*out++ = ' ';
+		if (width == 1) {
+			const volatile uint8_t *data = (const volatile uint8_t *)(address + offset);
+			uint8_t bytes[CLI_MEMORY_ROW];
+			for (size_t i = 0; i < count; i++) {
+				bytes[i] = data[i];
+				memcpy(out, cli_hex[bytes[i]], 2);
+				out[2] = ' ';
+				out += 3;
+			}
+			/* Align the characters of the last row */
+			memset(out, ' ', (CLI_MEMORY_ROW - count) * 3);
+			out += (CLI_MEMORY_ROW - count) * 3;
+			*out++ = ' ';
+			*out++ = '|';
+			for (size_t i = 0; i < count; i++) {
+				*out++ = ((bytes[i] >= 0x20) && (bytes[i] <= 0x7e)) ? bytes[i] : '.';
+			}
+			*out++ = '|';
+		} else {
+			for (size_t i = 0; i < count; i += width) {
+				out = cli_memory_hex(out, cli_memory_read(address + offset + i, width), width);
+				*out++ = ' ';
+			}
+		}
+		*out++ = '\r';
+		*out++ = '\n';
+		cli_write(cli, row, out - row);
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Print the memory in base64, 64 characters per line.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	data Start address.
+* @param	length Number of bytes.
+* @return 	`int` Function success or error code.
+*/
+static int cli_memory_dump_base64(cli_t *cli, const uint8_t *data, size_t length) {
+	char line[CLI_MEMORY_BASE64_LINE / 3 * 4 + 2];
+	while (length) {
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+		if (cli_tx_room(cli) < 0) {
+			/* 'q' in the pager: the rest is not even read */
+			break;
+		}
+#endif
+		size_t count = (length > CLI_MEMORY_BASE64_LINE) ? CLI_MEMORY_BASE64_LINE : length;
+		char *out = line;
+		size_t i = 0;
+		for (; i + 3 <= count; i += 3) {
+			uint32_t triple = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+			*out++ = cli_base64[(triple >> 18) & 0x3f];
+			*out++ = cli_base64[(triple >> 12) & 0x3f];
+			*out++ = cli_base64[(triple >> 6) & 0x3f];
+			*out++ = cli_base64[triple & 0x3f];
+		}
+		if (i < count) {
+			uint32_t triple = data[i] << 16;
+			if (i + 1 < count) {
+				triple |= data[i + 1] << 8;
+			}
+			*out++ = cli_base64[(triple >> 18) & 0x3f];
+			*out++ = cli_base64[(triple >> 12) & 0x3f];
+			*out++ = (i + 1 < count) ? cli_base64[(triple >> 6) & 0x3f] : '=';
+			*out++ = '=';
+		}
+		*out++ = '\r';
+		*out++ = '\n';
+		cli_write(cli, line, out - line);
+		data += count;
+		length -= count;
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Write the value in hex, the most significant byte first.
+* @param	out Output buffer.
+* @param	value Value.
+* @param	bytes Number of bytes of the value to write.
+* @return 	`char*` The end of the written text.
+*/
+static char *cli_memory_hex(char *out, uintptr_t value, int bytes) {
+	for (int i = bytes - 1; i >= 0; i--) {
+		memcpy(out, cli_hex[(value >> (i * 8)) & 0xff], 2);
+		out += 2;
+	}
+	return out;
+}
+
+/**
+* @brief 	Read the memory with the given access width.
+* @param	address Address.
+* @param	width Access width.
+* @return 	`uint32_t` Value.
+*/
+static uint32_t cli_memory_read(uintptr_t address, int width) {
+	switch (width) {
+	case 2:
+		return *(const volatile uint16_t *)address;
+	case 4:
+		return *(const volatile uint32_t *)address;
+	default:
+		return *(const volatile uint8_t *)address;
+	}
+}
+
+/**
+* @brief 	Write the memory with the given access width.
+* @param	address Address.
+* @param	width Access width.
+* @param	value Value.
+*/
+static void cli_memory_write(uintptr_t address, int width, uint32_t value) {
+	switch (width) {
+	case 2:
+		*(volatile uint16_t *)address = (uint16_t)value;
+		break;
+	case 4:
+		*(volatile uint32_t *)address = value;
+		break;
+	default:
+		*(volatile uint8_t *)address = (uint8_t)value;
+		break;
+	}
+}
+
+/**
+* @brief 	Parse the access width.
+* @param	text Argument.
+* @return 	`int` Width (1, 2, 4) or (0) if incorrect.
+*/
+static int cli_memory_width(const char *text) {
+	int width = (int)strtol(text, NULL, 10);
+	return ((width == 1) || (width == 2) || (width == 4)) ? width : 0;
+}
+
+#endif
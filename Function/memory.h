@@ -0,0 +1,44 @@
+/*
+*******************************************************************************
+@file	memory.h
+@brief	Commands for inspecting and changing memory: md, mw, mfill, mcmp.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_FUNCTION_MEMORY_H_
+#define CLI_FUNCTION_MEMORY_H_
+
+#include "../cli.h"
+
+int cli_memory_init(cli_t *cli);
+
+int cli_function_md(cli_t *cli, int argc, char *argv[]);
+int cli_function_mw(cli_t *cli, int argc, char *argv[]);
+int cli_function_mfill(cli_t *cli, int argc, char *argv[]);
+int cli_function_mcmp(cli_t *cli, int argc, char *argv[]);
+
+#endif /* CLI_FUNCTION_MEMORY_H_ */
@@ -0,0 +1,417 @@
+/*
+*******************************************************************************
+@file	transfer.c
+@brief	File and blob transfer over the CLI link (XMODEM-CRC/1K): rx, sx.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "transfer.h"
+#include "../io.h"
+#include <stdlib.h>
+
+#if (CLI_TRANSFER_ENABLE == TRUE)
+
+/* Protocol symbols */
+#define XMODEM_SOH        0x01  /* Block of 128 bytes */
+#define XMODEM_STX        0x02  /* Block of 1024 bytes */
+#define XMODEM_EOT        0x04
+#define XMODEM_ACK        0x06
+#define XMODEM_NAK        0x15
+#define XMODEM_CAN        0x18
+#define XMODEM_CRC        'C'
+#define XMODEM_PAD        0x1A
+
+/* Timeouts, ms */
+#define XMODEM_TIMEOUT_START   3000
+#define XMODEM_TIMEOUT_BLOCK   10000
+#define XMODEM_TIMEOUT_BYTE    1000
+#define XMODEM_RETRY           10
+
+static const cli_transfer_target_t *cli_transfer_targets[CLI_TRANSFER_TARGETS];
+/* Only one transfer in each direction at a time, so the blocks are not on the stack */
+static uint8_t cli_transfer_rx_block[1024 + 4];
+static uint8_t cli_transfer_tx_block[1024 + 5];
+
+#if (CLI_FOR_POSIX == TRUE)
+#include <stdio.h>
+static int cli_transfer_file_open(void *context, int write);
+static int cli_transfer_file_write(void *context, uint32_t offset, const uint8_t *data, int length);
+static int cli_transfer_file_read(void *context, uint32_t offset, uint8_t *data, int length);
+static int cli_transfer_file_close(void *context, int status);
+
+/* Any name that is not a registered target is a file */
+static FILE *cli_transfer_file;
+static cli_transfer_target_t cli_transfer_file_target = {
+	.Open = cli_transfer_file_open,
+	.Write = cli_transfer_file_write,
+	.Read = cli_transfer_file_read,
+	.Close = cli_transfer_file_close,
+};
+#endif
+
+static const cli_transfer_target_t *cli_transfer_find(const char *name);
+static int cli_transfer_getc(cli_t *cli, uint32_t timeout);
+static void cli_transfer_putc(cli_t *cli, uint8_t ch);
+static void cli_transfer_purge(cli_t *cli);
+static void cli_transfer_cancel(cli_t *cli);
+static uint16_t cli_transfer_crc(const uint8_t *data, int length);
+
+/**
+* @brief 	Command: Add the transfer commands to the CLI.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*/
+int cli_transfer_init(cli_t *cli) {
+	CLI_COMMAND_DEFINE(cli, "rx", cli_function_rx, "Receive data (XMODEM)");
+	CLI_COMMAND_DEFINE(cli, "sx", cli_function_sx, "Send data (XMODEM)");
+	return 0;
+}
+
+/**
+* @brief 	Add the target for 'rx' and 'sx'.
+* @param 	target Target. Must exist while the CLI works.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no free place.
+*/
+int cli_transfer_add(const cli_transfer_target_t *target) {
+	for (int i = 0; i < CLI_TRANSFER_TARGETS; i++) {
+		if (cli_transfer_targets[i] == NULL) {
+			cli_transfer_targets[i] = target;
+			return CLI_OK;
+		}
+	}
+	return CLI_ERROR;
+}
+
+/**
+* @brief 	Command: Receive the data to the target (XMODEM-CRC, blocks
+*       	of 128 and 1024 bytes). The line editor does not work until the
+*       	transfer is over.
+* @note 	The last block is padded with 0x1A by the sender, the target
+*       	gets it as it is.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_rx(cli_t *cli, int argc, char *argv[]) {
+	const cli_transfer_target_t *target = (argc > 1) ? cli_transfer_find(argv[1]) : NULL;
+	if (target == NULL) {
+		cli_printf(cli, "Usage: %s TARGET\r\n", argv[0]);
+		for (int i = 0; i < CLI_TRANSFER_TARGETS; i++) {
+			if (cli_transfer_targets[i] != NULL) {
+				cli_printf(cli, "\t%s\r\n", cli_transfer_targets[i]->Name);
+			}
+		}
+		return EXIT_FAILURE;
+	}
+	if (__io_cli_millis == NULL) {
+		cli_printf(cli, "Define '__io_cli_millis' for the transfer\r\n");
+		return EXIT_FAILURE;
+	}
+	if ((target->Open != NULL) && target->Open(target->Context, 1)) {
+		return EXIT_FAILURE;
+	}
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	/* XON and XOFF are in the blocks, the pager would break them */
+	int raw = cli_raw(cli, CLI_RAW_RX | CLI_RAW_TX);
+#endif
+
+	uint8_t expected = 1;
+	uint32_t offset = 0;
+	int errors = 0;
+	int status = EXIT_FAILURE;
+	uint8_t request = XMODEM_CRC;
+	cli_transfer_putc(cli, request);
+	while (errors < XMODEM_RETRY) {
+		int header = cli_transfer_getc(cli, (offset || (request == XMODEM_NAK)) ? XMODEM_TIMEOUT_BLOCK : XMODEM_TIMEOUT_START);
+		if (header == XMODEM_EOT) {
+			cli_transfer_putc(cli, XMODEM_ACK);
+			status = EXIT_SUCCESS;
+			break;
+		}
+		if (header == XMODEM_CAN) {
+			break;
+		}
+		if ((header != XMODEM_SOH) && (header != XMODEM_STX)) {
+			/* Timeout or garbage: ask again */
+			errors++;
+			cli_transfer_purge(cli);
+			cli_transfer_putc(cli, request);
+			continue;
+		}
+		int length = (header == XMODEM_STX) ? 1024 : 128;
+		int i = 0;
+		/* Block number, its complement, data and CRC */
+		for (; i < length + 4; i++) {
+			int ch = cli_transfer_getc(cli, XMODEM_TIMEOUT_BYTE);
+			if (ch < 0) break;
+			cli_transfer_rx_block[i] = ch;
+		}
+		uint8_t *data = &cli_transfer_rx_block[2];
+		uint16_t crc = (data[length] << 8) | data[length + 1];
+		if ((i < length + 4) || ((uint8_t)~cli_transfer_rx_block[0] != cli_transfer_rx_block[1]) ||
+			(cli_transfer_crc(data, length) != crc)) {
+			errors++;
+			cli_transfer_purge(cli);
+			request = XMODEM_NAK;
+			cli_transfer_putc(cli, request);
+			continue;
+		}
+		if (cli_transfer_rx_block[0] == (uint8_t)(expected - 1)) {
+			/* Our ACK was lost, the block is repeated */
+			cli_transfer_putc(cli, XMODEM_ACK);
+			continue;
+		}
+		if (cli_transfer_rx_block[0] != expected) {
+			break;
+		}
+		if (target->Write(target->Context, offset, data, length)) {
+			break;
+		}
+		offset += length;
+		expected++;
+		errors = 0;
+		request = XMODEM_NAK;
+		cli_transfer_putc(cli, XMODEM_ACK);
+	}
+	if (status != EXIT_SUCCESS) {
+		cli_transfer_cancel(cli);
+	}
+	if (target->Close != NULL) {
+		target->Close(target->Context, status);
+	}
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	cli_raw(cli, raw);
+#endif
+	cli_printf(cli, "\r\n%s: %lu bytes\r\n", (status == EXIT_SUCCESS) ? "Received" : "Failed", (unsigned long)offset);
+	return status;
+}
+
+/**
+* @brief 	Command: Send the data of the target (XMODEM-CRC or checksum,
+*       	blocks of 1024 bytes if the receiver asked for CRC).
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_sx(cli_t *cli, int argc, char *argv[]) {
+	const cli_transfer_target_t *target = (argc > 1) ? cli_transfer_find(argv[1]) : NULL;
+	if ((target == NULL) || (target->Read == NULL)) {
+		cli_printf(cli, "Usage: %s TARGET\r\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (__io_cli_millis == NULL) {
+		cli_printf(cli, "Define '__io_cli_millis' for the transfer\r\n");
+		return EXIT_FAILURE;
+	}
+	if ((target->Open != NULL) && target->Open(target->Context, 0)) {
+		return EXIT_FAILURE;
+	}
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	/* XON and XOFF are in the blocks, the pager would break them */
+	int raw = cli_raw(cli, CLI_RAW_RX | CLI_RAW_TX);
+#endif
+
+	/* Wait for the receiver: 'C' for CRC, NAK for the checksum */
+	int mode = -1;
+	for (int i = 0; (i < XMODEM_RETRY * 2) && (mode != XMODEM_CRC) && (mode != XMODEM_NAK); i++) {
+		mode = cli_transfer_getc(cli, XMODEM_TIMEOUT_START);
+		if (mode == XMODEM_CAN) break;
+	}
+	int status = EXIT_FAILURE;
+	uint32_t offset = 0;
+	uint8_t number = 1;
+	while ((mode == XMODEM_CRC) || (mode == XMODEM_NAK)) {
+		int length = (mode == XMODEM_CRC) ? 1024 : 128;
+		uint8_t *data = &cli_transfer_tx_block[3];
+		int count = target->Read(target->Context, offset, data, length);
+		if (count <= 0) {
+			/* End of the data */
+			for (int i = 0; i < XMODEM_RETRY; i++) {
+				cli_transfer_putc(cli, XMODEM_EOT);
+				if (cli_transfer_getc(cli, XMODEM_TIMEOUT_BLOCK) == XMODEM_ACK) {
+					status = EXIT_SUCCESS;
+					break;
+				}
+			}
+			break;
+		}
+		if (count <= 128) {
+			length = 128;
+		}
+		memset(&data[count], XMODEM_PAD, length - count);
+		cli_transfer_tx_block[0] = (length == 1024) ? XMODEM_STX : XMODEM_SOH;
+		cli_transfer_tx_block[1] = number;
+		cli_transfer_tx_block[2] = ~number;
+		int size = length + 3;
+		if (mode == XMODEM_CRC) {
+			uint16_t crc = cli_transfer_crc(data, length);
+			data[length] = crc >> 8;
+			data[length + 1] = crc & 0xff;
+			size += 2;
+		} else {
+			uint8_t sum = 0;
+			for (int i = 0; i < length; i++) {
+				sum += data[i];
+			}
+			data[length] = sum;
+			size += 1;
+		}
+
+		int answer = -1;
+		for (int i = 0; (i < XMODEM_RETRY) && (answer != XMODEM_ACK) && (answer != XMODEM_CAN); i++) {
+			cli_write(cli, (const char *)cli_transfer_tx_block, size);
+			answer = cli_transfer_getc(cli, XMODEM_TIMEOUT_BLOCK);
+		}
+		if (answer != XMODEM_ACK) {
+			cli_transfer_cancel(cli);
+			break;
+		}
+		offset += count;
+		number++;
+	}
+	if (target->Close != NULL) {
+		target->Close(target->Context, status);
+	}
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	cli_raw(cli, raw);
+#endif
+	cli_printf(cli, "\r\n%s: %lu bytes\r\n", (status == EXIT_SUCCESS) ? "Sent" : "Failed", (unsigned long)offset);
+	return status;
+}
+
+/**
+* @brief 	Find the target by name.
+* @param	name Name of the target.
+* @return 	`cli_transfer_target_t*` The target or NULL.
+*/
+static const cli_transfer_target_t *cli_transfer_find(const char *name) {
+	for (int i = 0; i < CLI_TRANSFER_TARGETS; i++) {
+		if ((cli_transfer_targets[i] != NULL) && !strcmp(cli_transfer_targets[i]->Name, name)) {
+			return cli_transfer_targets[i];
+		}
+	}
+#if (CLI_FOR_POSIX == TRUE)
+	cli_transfer_file_target.Name = name;
+	cli_transfer_file_target.Context = (void *)name;
+	return &cli_transfer_file_target;
+#else
+	return NULL;
+#endif
+}
+
+#if (CLI_FOR_POSIX == TRUE)
+static int cli_transfer_file_open(void *context, int write) {
+	cli_transfer_file = fopen((const char *)context, write ? "wb" : "rb");
+	return (cli_transfer_file == NULL) ? CLI_ERROR : CLI_OK;
+}
+
+static int cli_transfer_file_write(void *context, uint32_t offset, const uint8_t *data, int length) {
+	return (fwrite(data, 1, length, cli_transfer_file) == (size_t)length) ? CLI_OK : CLI_ERROR;
+}
+
+static int cli_transfer_file_read(void *context, uint32_t offset, uint8_t *data, int length) {
+	return (int)fread(data, 1, length, cli_transfer_file);
+}
+
+static int cli_transfer_file_close(void *context, int status) {
+	fclose(cli_transfer_file);
+	cli_transfer_file = NULL;
+	return CLI_OK;
+}
+#endif
+
+/**
+* @brief 	Receive a byte, sleeping in `cli_wait` while there is no data.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	timeout Timeout, ms.
+* @return 	`int` The byte or (-1) on timeout.
+*/
+static int cli_transfer_getc(cli_t *cli, uint32_t timeout) {
+	uint32_t start = __io_cli_millis();
+	uint8_t ch;
+	while (!cli_read(cli, &ch, 1)) {
+		uint32_t elapsed = __io_cli_millis() - start;
+		if (elapsed >= timeout) {
+			return -1;
+		}
+		cli_wait(cli, (int)(timeout - elapsed));
+	}
+	return ch;
+}
+
+/**
+* @brief 	Send a control byte.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	ch The byte.
+*/
+static void cli_transfer_putc(cli_t *cli, uint8_t ch) {
+	cli_write(cli, (const char *)&ch, 1);
+}
+
+/**
+* @brief 	Skip the received bytes until the line is silent.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*/
+static void cli_transfer_purge(cli_t *cli) {
+	while (cli_transfer_getc(cli, XMODEM_TIMEOUT_BYTE) >= 0);
+}
+
+/**
+* @brief 	Cancel the transfer on the other side.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*/
+static void cli_transfer_cancel(cli_t *cli) {
+	static const char cancel[] = { XMODEM_CAN, XMODEM_CAN, XMODEM_CAN };
+	cli_write(cli, cancel, sizeof(cancel));
+}
+
+/**
+* @brief 	CRC-16/XMODEM (polynomial 0x1021), by nibbles to keep the table small.
+* @param	data Data.
+* @param	length Number of bytes.
+* @return 	`uint16_t` CRC.
+*/
+static uint16_t cli_transfer_crc(const uint8_t *data, int length) {
+	static const uint16_t table[16] = {
+		0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+		0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef
+	};
+	uint16_t crc = 0;
+	for (int i = 0; i < length; i++) {
+		crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)];
+		crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0f)];
+	}
+	return crc;
+}
+
+#endif
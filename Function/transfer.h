@@ -0,0 +1,58 @@
+/*
+*******************************************************************************
+@file	transfer.h
+@brief	File and blob transfer over the CLI link (XMODEM-CRC/1K): rx, sx.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_FUNCTION_TRANSFER_H_
+#define CLI_FUNCTION_TRANSFER_H_
+
+#include <stdint.h>
+
+#include "../cli.h"
+
+/*
+ * @brief	Target of the transfer: where the received data goes (flash
+ *      	writer, file) and where the sent data comes from.
+ */
+typedef struct {
+	const char *Name;                                            // Name used in 'rx NAME' and 'sx NAME'
+	int (*Open)(void *context, int write);                       // Start of the transfer (optional)
+	int (*Write)(void *context, uint32_t offset, const uint8_t *data, int length); // Received data
+	int (*Read)(void *context, uint32_t offset, uint8_t *data, int length);        // Data to send, (0) at the end
+	int (*Close)(void *context, int status);                     // End of the transfer (optional)
+	void *Context;                                               // Argument for the functions
+} cli_transfer_target_t;
+
+int cli_transfer_init(cli_t *cli);
+int cli_transfer_add(const cli_transfer_target_t *target);
+
+int cli_function_rx(cli_t *cli, int argc, char *argv[]);
+int cli_function_sx(cli_t *cli, int argc, char *argv[]);
+
+#endif /* CLI_FUNCTION_TRANSFER_H_ */
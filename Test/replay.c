@@ -0,0 +1,149 @@
+/*
+*******************************************************************************
+@file	replay.c
+@brief	Host tool: replay a saved trace through cli_handler.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_ENABLE_EMIT=TRUE CLI_ENABLE_TRACE=TRUE CLI_TRACE_SIZE=4096
+*
+* Reads the lines printed by the 'trace' command of the device (the other
+* lines of the terminal log are skipped), gives the received bytes to an
+* instance with the same 'opt.h' and compares what it sends with the
+* recorded output byte by byte. Then prints the histograms of the time
+* from a key to the echo: the recorded one in the ticks of the device and
+* the one of the replay in nanoseconds of the host.
+*   replay [trace.txt]              the standard input if no file
+* The exit status is (0) if the output is the same, (1) if it differs and
+* (2) if the trace can not be read.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "cli.h"
+
+#define REPLAY_BINS       32    /* Bin k: [2^k, 2^(k+1)) ticks */
+
+static cli_t cli;
+static cli_trace_t replay_saved;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The greeting of the instance is not a part of the replay.
+* @param	ch The byte.
+*
+*/
+int __io_cli_putchar(int ch) {
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Nothing is received outside of the replay.
+* @return	`int` (0).
+*/
+int __io_cli_getchar(void) {
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Timestamps of the replay: nanoseconds of the host.
+* @return	`uint32_t` The time, wraps around.
+*/
+uint32_t __io_cli_cycles(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the histogram of the latency.
+* @param	title The name of the histogram.
+* @param	trace The trace.
+*
+*/
+static void replay_latency(const char *title, const cli_trace_t *trace) {
+	unsigned int histogram[REPLAY_BINS];
+	int measured = cli_trace_latency(trace, histogram, REPLAY_BINS);
+	printf("%s: %d keystrokes\n", title, measured);
+	for (int bin = 0; bin < REPLAY_BINS; bin++) {
+		if (!histogram[bin]) continue;
+		printf("  %10lu %8u\n", bin ? (1UL << bin) : 0UL, histogram[bin]);
+	}
+}
+
+int main(int argc, char *argv[]) {
+	FILE *file = stdin;
+	if (argc > 2) {
+		fprintf(stderr, "Usage: %s [trace.txt]\n", argv[0]);
+		return 2;
+	}
+	if ((argc > 1) && ((file = fopen(argv[1], "r")) == NULL)) {
+		perror(argv[1]);
+		return 2;
+	}
+	cli_trace_init(&replay_saved);
+	char line[128];
+	cli_trace_record_t record;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (cli_trace_parse(line, &record) == CLI_OK) {
+			cli_trace_append(&replay_saved, &record);
+		}
+	}
+	if (file != stdin) {
+		fclose(file);
+	}
+	if (replay_saved.Head > CLI_TRACE_SIZE) {
+		fprintf(stderr, "The trace has %u events, only the last %d are replayed. "
+				"Change the value of CLI_TRACE_SIZE in the 'opt.h' file.\n",
+				replay_saved.Head, CLI_TRACE_SIZE);
+	}
+	if (cli_trace_count(&replay_saved) == 0) {
+		fprintf(stderr, "No events in the trace\n");
+		return 2;
+	}
+
+	cli_init(&cli);
+	/* Only the replay is measured */
+	cli.Trace.Head = 0;
+	int mismatch;
+	int result = cli_trace_replay(&cli, &replay_saved, &mismatch);
+	printf("%d events\n", cli_trace_count(&replay_saved));
+	if (result == CLI_OK) {
+		printf("output: same\n");
+	} else {
+		printf("output: differs at byte %d\n", mismatch);
+	}
+	replay_latency("recorded latency, ticks", &replay_saved);
+	replay_latency("replay latency, ns", &cli.Trace);
+	return (result == CLI_OK) ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+#!/bin/sh
+# Build and run the host tests. Each 'test_*.c' is built with the options of
+# its '@options' line set in a copy of 'opt.h', with the terminal of 'test.c'.
+# The tool 'replay' (a saved trace through 'cli_handler') is built the same
+# way into '_test_build/replay/replay', the tests find it in $TEST_REPLAY.
+#   Test/run.sh [test_name ...]
+root=$(cd "$(dirname "$0")/.." && pwd)
+build=${TEST_BUILD:-$root/_test_build}
+tests=$*
+[ -n "$tests" ] || tests=$(cd "$root/Test" && ls test_*.c | sed 's/\.c$//')
+status=0
+
+# compile <name> <sources ...>: the program '$dir/<name>' with the options of 'Test/<name>.c'
+compile() {
+	name=$1
+	shift
+	dir=$build/$name
+	rm -rf "$dir" && mkdir -p "$dir/Function" || return 1
+	cp "$root"/*.c "$root"/*.h "$dir/" && cp "$root"/Function/*.c "$root"/Function/*.h "$dir/Function/" || return 1
+	sed -i -E 's/^#define (CLI_CUSTOM_IO) .*/#define \1 TRUE/; s/^#define (CLI_FOR_[A-Z0-9_]+) .*/#define \1 FALSE/' "$dir/opt.h"
+	for option in $(sed -n 's/^\* *@options[[:space:]]*//p' "$root/Test/$name.c"); do
+		sed -i -E "s/^#define ${option%%=*}( +).*/#define ${option%%=*}\1${option#*=}/" "$dir/opt.h"
+	done
+	if ! ${CC:-gcc} -std=gnu11 -g -Wall -Werror ${CFLAGS:-} -I"$dir" -I"$root/Test" \
+			"$dir"/*.c "$dir"/Function/*.c "$@" -o "$dir/$name" -lpthread -ldl; then
+		echo "$name: build failed"
+		return 1
+	fi
+}
+
+compile replay "$root/Test/replay.c" || status=1
+export TEST_REPLAY="$build/replay/replay"
+for name in $tests; do
+	if ! compile "$name" "$root/Test/vt100.c" "$root/Test/test.c" "$root/Test/$name.c"; then
+		status=1
+		continue
+	fi
+	"$dir/$name" || status=1
+done
+exit $status
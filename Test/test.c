@@ -0,0 +1,194 @@
+/*
+*******************************************************************************
+@file	test.c
+@brief	Checks and the terminal of the host tests.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include <stdio.h>
+
+#include "test.h"
+
+vt100_t test_vt;
+
+static const uint8_t *test_input;
+static int test_input_length;
+static int test_checks;
+static int test_failures;
+
+#if (CLI_CUSTOM_IO == TRUE)
+/* A test of a ready port ('@options CLI_FOR_POSIX=TRUE') uses its functions */
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The output of the CLI goes to the emulator.
+* @param	ch The byte.
+*
+*/
+int __io_cli_putchar(int ch) {
+	vt100_putc(&test_vt, (char)ch);
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The keys of 'test_type', one byte per call.
+* @return	`int` The byte or (0) if there is none.
+*/
+int __io_cli_getchar(void) {
+	if (test_input_length <= 0) {
+		return 0;
+	}
+	test_input_length--;
+	return *test_input++;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check the condition.
+* @param	passed The result of the condition.
+* @param	file The file of the check.
+* @param	line The line of the check.
+* @param	text The condition.
+*
+*/
+void test_check(int passed, const char *file, int line, const char *text) {
+	test_checks++;
+	if (!passed) {
+		test_failures++;
+		printf("%s:%d: failed: %s\n", file, line, text);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check the number.
+* @param	actual The value.
+* @param	expected The expected value.
+* @param	file The file of the check.
+* @param	line The line of the check.
+* @param	text The expression of the value.
+*
+*/
+void test_check_int(long actual, long expected, const char *file, int line, const char *text) {
+	test_checks++;
+	if (actual != expected) {
+		test_failures++;
+		printf("%s:%d: %s is %ld, expected %ld\n", file, line, text, actual, expected);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check the string.
+* @param	actual The value.
+* @param	expected The expected value.
+* @param	file The file of the check.
+* @param	line The line of the check.
+* @param	text The expression of the value.
+*
+*/
+void test_check_str(const char *actual, const char *expected, const char *file, int line, const char *text) {
+	test_checks++;
+	if ((actual == NULL) || strcmp(actual, expected)) {
+		test_failures++;
+		printf("%s:%d: %s is \"%s\", expected \"%s\"\n", file, line, text, (actual != NULL) ? actual : "(null)", expected);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check the budget: the value must not be greater.
+* @param	actual The value.
+* @param	limit The budget.
+* @param	file The file of the check.
+* @param	line The line of the check.
+* @param	text The expression of the value.
+*
+*/
+void test_check_most(long actual, long limit, const char *file, int line, const char *text) {
+	test_checks++;
+	if (actual > limit) {
+		test_failures++;
+		printf("%s:%d: %s is %ld, the budget is %ld\n", file, line, text, actual, limit);
+	} else if (actual < limit) {
+		printf("%s:%d: note: %s is %ld, the budget %ld can be lowered\n", file, line, text, actual, limit);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Type the keys and let the instance handle them all.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	keys The keys, the escape sequences as they come from a terminal.
+*
+*/
+void test_type(cli_t *cli, const char *keys) {
+	test_type_bytes(cli, keys, strlen(keys));
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Type the bytes and let the instance handle them all.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	keys The bytes.
+* @param	length Number of the bytes.
+*
+*/
+void test_type_bytes(cli_t *cli, const void *keys, int length) {
+#if (CLI_USE_RING_BUFFER == TRUE)
+	const uint8_t *data = keys;
+	while (length > 0) {
+		int pushed = cli_rx_push(cli, data, length);
+		data += pushed;
+		length -= pushed;
+		/* The held output (XOFF, pager) may keep the instance pending */
+		for (int turn = 0; cli_pending(cli) && (turn < 4096); turn++) {
+			cli_handler(cli);
+		}
+	}
+#else
+	test_input = keys;
+	test_input_length = length;
+	while (test_input_length > 0) {
+		cli_handler(cli);
+	}
+#endif
+	/* The instance sees that nothing more comes */
+	cli_handler(cli);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the result of the test.
+* @param	name The name of the test.
+* @return	`int` The exit status: (0) if all the checks passed.
+*/
+int test_report(const char *name) {
+	printf("%s: %d checks, %d failed\n", name, test_checks, test_failures);
+	return test_failures ? 1 : 0;
+}
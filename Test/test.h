@@ -0,0 +1,68 @@
+/*
+*******************************************************************************
+@file	test.h
+@brief	Checks and the terminal of the host tests.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_TEST_H_
+#define CLI_TEST_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "cli.h"
+#include "vt100.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Define ------------------------------------------------------------------ */
+/* The check fails the test, the next checks still run */
+#define TEST_CHECK(condition)            test_check((condition), __FILE__, __LINE__, #condition)
+#define TEST_EQUAL_INT(actual, expected) test_check_int((long)(actual), (long)(expected), __FILE__, __LINE__, #actual)
+#define TEST_EQUAL_STR(actual, expected) test_check_str((actual), (expected), __FILE__, __LINE__, #actual)
+/* The budget of the bytes: more is a failure, less is shown to lower it */
+#define TEST_AT_MOST(actual, limit)      test_check_most((long)(actual), (long)(limit), __FILE__, __LINE__, #actual)
+/*---------------------------------------------------------------------------*/
+
+
+/* Variables --------------------------------------------------------------- */
+/* The terminal of the instances that print with '__io_cli_putchar' */
+extern vt100_t test_vt;
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'test.c'. */
+/* Function instances ------------------------------------------------------ */
+void test_check(int passed, const char *file, int line, const char *text);
+void test_check_int(long actual, long expected, const char *file, int line, const char *text);
+void test_check_str(const char *actual, const char *expected, const char *file, int line, const char *text);
+void test_check_most(long actual, long limit, const char *file, int line, const char *text);
+void test_type(cli_t *cli, const char *keys);
+void test_type_bytes(cli_t *cli, const void *keys, int length);
+int test_report(const char *name);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_TEST_H_ */
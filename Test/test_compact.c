@@ -0,0 +1,99 @@
+/*
+*******************************************************************************
+@file	test_compact.c
+@brief	The commands of the compact layout: the pool and the constant descriptors.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_ENABLE_LINE_POOL=TRUE CLI_COMPACT=TRUE CLI_COMMAND_POOL=4 CLI_MAX_COUNT_COMMAND=16 CLI_ENABLE_DELETE_COMMAND=TRUE
+*
+* 'cli_add' stays a function: the names made at run time in a loop are
+* different commands, their descriptors take the places of the pool and
+* a removed command gives its place back. The commands of
+* 'CLI_COMMAND_DEFINE' (and the built-in ones) keep one constant descriptor
+* for all the instances and do not take the pool.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+static cli_t cli, other;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Command: print its name.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` (0).
+*/
+static int test_function_name(cli_t *cli, int argc, char *argv[]) {
+	cli_printf(cli, "%s", argv[0]);
+	return 0;
+}
+
+int main(void) {
+	vt100_init(&test_vt);
+	cli_init(&cli);
+	cli_init(&other);
+	char out[32];
+
+	/* The names of the run time, one call site */
+	static char names[CLI_COMMAND_POOL + 1][8];
+	int index[CLI_COMMAND_POOL + 1];
+	for (int i = 0; i <= CLI_COMMAND_POOL; i++) {
+		snprintf(names[i], sizeof(names[i]), "run%d", i);
+		index[i] = cli_add(&cli, names[i], test_function_name, "Print the name");
+	}
+	for (int i = 0; i < CLI_COMMAND_POOL; i++) {
+		TEST_CHECK(index[i] > 1);
+		TEST_EQUAL_INT(cli_exec(&cli, names[i], out, sizeof(out)), 0);
+		TEST_EQUAL_STR(out, names[i]);
+	}
+	/* The pool is full */
+	TEST_EQUAL_INT(index[CLI_COMMAND_POOL], CLI_ERROR);
+	TEST_EQUAL_INT(cli_exec(&cli, names[CLI_COMMAND_POOL], NULL, 0), CLI_ERROR);
+
+	/* A removed command gives its place back */
+	TEST_EQUAL_INT(cli_remove_name(&cli, "run1"), CLI_OK);
+	TEST_EQUAL_INT(cli_exec(&cli, "run1", NULL, 0), CLI_ERROR);
+	TEST_CHECK(cli_add(&cli, names[CLI_COMMAND_POOL], test_function_name, "Print the name") > 1);
+	TEST_EQUAL_INT(cli_exec(&cli, names[CLI_COMMAND_POOL], out, sizeof(out)), 0);
+	TEST_EQUAL_STR(out, names[CLI_COMMAND_POOL]);
+
+	/* The constant descriptors are shared and do not take the pool */
+	int defined = CLI_COMMAND_DEFINE(&other, "name", test_function_name, "Print the name");
+	TEST_CHECK(defined > 1);
+	TEST_EQUAL_INT(cli_exec(&other, "name", out, sizeof(out)), 0);
+	TEST_EQUAL_STR(out, "name");
+	TEST_CHECK(cli.Commands[0] == other.Commands[0]);
+	TEST_EQUAL_STR(cli.Commands[0]->Name, "help");
+	return test_report("test_compact");
+}
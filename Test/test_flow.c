@@ -0,0 +1,109 @@
+/*
+*******************************************************************************
+@file	test_flow.c
+@brief	Test of the pager: the keys typed ahead and the keys of the operator.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_USE_RING_BUFFER=TRUE CLI_ENABLE_FLOW_CONTROL=TRUE
+*
+* The terminal of the test answers each "--More--" at once. With "z ",
+* 'z' is not a key of the pager and must reach the line editor after the
+* keys typed before the page was full, Space gives the next page.
+*/
+
+#include "test.h"
+
+#define TEST_LINES     60
+
+static cli_t cli;
+static const char *answer = "z ";
+static int prompts;
+static int dashes;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Terminal of the instance: the operator answers the pager.
+* @param	ch The byte.
+* @return	`int` (0) always.
+*/
+static int test_putchar(int ch) {
+	vt100_putc(&test_vt, ch);
+	if (ch == '\n') {
+		dashes = 0;
+	} else if ((ch == '-') && (++dashes == 4)) {
+		/* The end of "--More--" */
+		dashes = 0;
+		prompts++;
+		cli_rx_push(&cli, (const uint8_t *)answer, strlen(answer));
+	}
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Command: the keys are typed ahead, then the lines fill the pages.
+*
+*/
+static int test_lines(cli_t *cli, int argc, char *argv[]) {
+	cli_rx_push(cli, (const uint8_t *)"a b", 3);
+	for (int i = 0; i < TEST_LINES; i++) {
+		cli_printf(cli, "line %d\r\n", i);
+	}
+	return 0;
+}
+
+int main(void) {
+	vt100_init(&test_vt);
+	cli_init(&cli);
+	cli._io_putchar = test_putchar;
+	cli_add(&cli, "lines", test_lines, "Lines");
+	test_type(&cli, "more on\r");
+	TEST_EQUAL_INT(cli.Pager, 1);
+
+	test_type(&cli, "lines\r");
+	TEST_EQUAL_INT(prompts, (TEST_LINES + 2) / (CLI_PAGER_ROWS - 1));
+	TEST_EQUAL_INT(cli.Page, CLI_PAGE_FLOW);
+	TEST_EQUAL_INT(cli.TxDropped, 0);
+	TEST_EQUAL_STR(vt100_row(&test_vt, test_vt.Row - 1), "line 59");
+	/* The keys typed ahead, then the keys of the operator without Space */
+	TEST_EQUAL_STR(vt100_row(&test_vt, test_vt.Row), ">a bzz");
+	TEST_EQUAL_INT(cli_ring_count(&cli.Rx), 0);
+
+	/* 'q' drops the rest of the output of the command */
+	test_type(&cli, "\025");
+	prompts = 0;
+	answer = "q";
+	test_type(&cli, "lines\r");
+	TEST_EQUAL_INT(prompts, 1);
+	TEST_EQUAL_INT(cli.Page, CLI_PAGE_FLOW);
+	TEST_CHECK(cli.TxDropped > 0);
+	TEST_EQUAL_STR(vt100_row(&test_vt, test_vt.Row), ">a b");
+	TEST_EQUAL_INT(cli_ring_count(&cli.Rx), 0);
+	return test_report("test_flow");
+}
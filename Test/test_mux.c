@@ -0,0 +1,311 @@
+/*
+*******************************************************************************
+@file	test_mux.c
+@brief	Test of the virtual channels: the framing round trip, the priority and the flow control.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_USE_RING_BUFFER=TRUE CLI_ENABLE_MUX=TRUE CLI_ENABLE_FLOW_CONTROL=TRUE
+*
+* The frames of the link are checked by a separate decoder and encoder here,
+* then the bytes sent by the link are given back to it: the data of the
+* stream must come out as it went in, with FLAG and ESCAPE inside.
+*/
+
+#include "test.h"
+#include "mux.h"
+
+#define TEST_SHELL     0
+#define TEST_LOG       2
+
+static cli_t cli;
+static uint8_t received[1024];
+static int received_length;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Receiver of the stream channel.
+* @param	channel Number of the channel.
+* @param	data Bytes.
+* @param	length Number of bytes.
+*
+*/
+static void test_receive(int channel, const uint8_t *data, int length) {
+	TEST_EQUAL_INT(channel, TEST_LOG);
+	if (received_length + length <= (int)sizeof(received)) {
+		memcpy(&received[received_length], data, length);
+	}
+	received_length += length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Encode a data frame.
+* @param	frame Buffer of the frame.
+* @param	channel Number of the channel.
+* @param	data Bytes.
+* @param	length Number of bytes.
+* @return	`int` Length of the frame.
+*/
+static int test_frame(uint8_t *frame, int channel, const void *data, int length) {
+	const uint8_t *bytes = data;
+	int size = 0;
+	frame[size++] = CLI_MUX_FLAG;
+	frame[size++] = channel;
+	for (int i = 0; i < length; i++) {
+		if ((bytes[i] == CLI_MUX_FLAG) || (bytes[i] == CLI_MUX_ESCAPE)) {
+			frame[size++] = CLI_MUX_ESCAPE;
+			frame[size++] = bytes[i] ^ 0x20;
+		} else {
+			frame[size++] = bytes[i];
+		}
+	}
+	frame[size++] = CLI_MUX_FLAG;
+	return size;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Decode the next frame sent by the link.
+* @param	channel Returns the channel of the frame.
+* @param	payload Buffer of the data.
+* @return	`int` Length of the data, (-1) if the link has nothing to send.
+*/
+static int test_unframe(int *channel, uint8_t *payload) {
+	uint8_t byte;
+	if (cli_mux_transmit(&byte, 1) != 1) {
+		return -1;
+	}
+	TEST_EQUAL_INT(byte, CLI_MUX_FLAG);
+	TEST_EQUAL_INT(cli_mux_transmit(&byte, 1), 1);
+	*channel = byte;
+	int length = 0;
+	while (cli_mux_transmit(&byte, 1) == 1) {
+		if (byte == CLI_MUX_FLAG) {
+			return length;
+		}
+		if (byte == CLI_MUX_ESCAPE) {
+			TEST_EQUAL_INT(cli_mux_transmit(&byte, 1), 1);
+			TEST_CHECK((byte ^ 0x20) == CLI_MUX_FLAG || (byte ^ 0x20) == CLI_MUX_ESCAPE);
+			byte ^= 0x20;
+		}
+		TEST_CHECK(length < CLI_MUX_FRAME);
+		payload[length++] = byte;
+	}
+	TEST_CHECK(0 && "The frame is not finished");
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Handle all the received bytes of the shell.
+*
+*/
+static void test_handle(void) {
+	for (int turn = 0; cli_pending(&cli) && (turn < 1024); turn++) {
+		cli_handler(&cli);
+	}
+	cli_handler(&cli);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The data of the stream with all the byte values goes through the
+*       	frames and back.
+*
+*/
+static void test_round_trip(void) {
+	uint8_t data[256];
+	for (int i = 0; i < (int)sizeof(data); i++) {
+		data[i] = i;
+	}
+	TEST_EQUAL_INT(cli_mux_write(TEST_LOG, data, sizeof(data)), sizeof(data));
+
+	/* The wire: FLAG only at the ends of the frames */
+	uint8_t wire[4 * sizeof(data)];
+	int size = 0;
+	int count;
+	while ((count = cli_mux_transmit(&wire[size], 7)) > 0) {
+		size += count;
+	}
+	int frames = 0;
+	int escapes = 0;
+	for (int i = 0; i < size; i++) {
+		if (wire[i] == CLI_MUX_FLAG) frames++;
+		if (wire[i] == CLI_MUX_ESCAPE) escapes++;
+	}
+	TEST_EQUAL_INT(frames, 2 * ((sizeof(data) + CLI_MUX_FRAME - 1) / CLI_MUX_FRAME));
+	TEST_EQUAL_INT(escapes, 2);
+	/* FLAG, channel, data and FLAG of each frame */
+	TEST_EQUAL_INT(size, sizeof(data) + escapes + frames + frames / 2);
+
+	/* Back through the receiver, one byte at a time */
+	received_length = 0;
+	for (int i = 0; i < size; i++) {
+		cli_mux_receive(&wire[i], 1);
+	}
+	TEST_EQUAL_INT(received_length, sizeof(data));
+	TEST_CHECK(!memcmp(received, data, sizeof(data)));
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The keys in a frame go to the shell and its echo comes back in
+*       	a frame of its channel.
+*
+*/
+static void test_shell(void) {
+	uint8_t frame[64];
+	int size = test_frame(frame, TEST_SHELL, "he", 2);
+	cli_mux_receive(frame, size);
+	test_handle();
+
+	vt100_t terminal;
+	vt100_init(&terminal);
+	uint8_t payload[CLI_MUX_FRAME];
+	int channel;
+	int length;
+	while ((length = test_unframe(&channel, payload)) >= 0) {
+		TEST_EQUAL_INT(channel, TEST_SHELL);
+		vt100_write(&terminal, payload, length);
+	}
+	TEST_EQUAL_STR(vt100_row(&terminal, terminal.Row), "he");
+	TEST_EQUAL_INT(cli.Point, 2);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The echo of the shell waits for at most one frame of the log.
+*
+*/
+static void test_priority(void) {
+	uint8_t data[CLI_MUX_STREAM_SIZE];
+	memset(data, 'L', sizeof(data));
+	TEST_EQUAL_INT(cli_mux_write(TEST_LOG, data, sizeof(data)), sizeof(data));
+	uint8_t payload[CLI_MUX_FRAME];
+	int channel;
+	TEST_EQUAL_INT(test_unframe(&channel, payload), CLI_MUX_FRAME);
+	TEST_EQUAL_INT(channel, TEST_LOG);
+
+	uint8_t frame[16];
+	int size = test_frame(frame, TEST_SHELL, "l", 1);
+	cli_mux_receive(frame, size);
+	test_handle();
+	TEST_EQUAL_INT(test_unframe(&channel, payload), 1);
+	TEST_EQUAL_INT(channel, TEST_SHELL);
+	TEST_EQUAL_INT(payload[0], 'l');
+
+	/* Then the rest of the log */
+	int rest = 0;
+	int length;
+	while ((length = test_unframe(&channel, payload)) >= 0) {
+		TEST_EQUAL_INT(channel, TEST_LOG);
+		rest += length;
+	}
+	TEST_EQUAL_INT(rest, sizeof(data) - CLI_MUX_FRAME);
+	test_type(&cli, "\025");
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The other side is stopped when the receive ring of the shell is
+*       	almost full, and let go when it is read.
+*
+*/
+static void test_flow(void) {
+	uint8_t keys[CLI_RX_RING_SIZE];
+	memset(keys, 'x', sizeof(keys) - CLI_RX_RING_SIZE / 8);
+	uint8_t frame[2 * CLI_RX_RING_SIZE + 4];
+	int size = test_frame(frame, TEST_SHELL, keys, sizeof(keys) - CLI_RX_RING_SIZE / 8);
+	cli_mux_receive(frame, size);
+	uint8_t payload[CLI_MUX_FRAME];
+	int channel;
+	TEST_EQUAL_INT(test_unframe(&channel, payload), 1);
+	TEST_EQUAL_INT(channel, TEST_SHELL | CLI_MUX_CONTROL);
+	TEST_EQUAL_INT(payload[0], CLI_MUX_STOP);
+
+	/* The shell reads the ring (its echo is not needed here) */
+	test_handle();
+	while (test_unframe(&channel, payload) >= 0) {
+		if (channel & CLI_MUX_CONTROL) break;
+	}
+	cli_mux_poll();
+	if (!(channel & CLI_MUX_CONTROL)) {
+		TEST_CHECK(test_unframe(&channel, payload) == 1);
+	}
+	TEST_EQUAL_INT(channel, TEST_SHELL | CLI_MUX_CONTROL);
+	TEST_EQUAL_INT(payload[0], CLI_MUX_GO);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The held output of the shell waits and the log goes on; XON
+*       	and XOFF in the frames are data.
+*
+*/
+static void test_hold(void) {
+	uint8_t payload[CLI_MUX_FRAME];
+	int channel;
+	while (test_unframe(&channel, payload) >= 0);
+	cli_tx_hold(&cli, 1);
+	uint8_t frame[16];
+	int size = test_frame(frame, TEST_SHELL, "h\x13", 2);
+	cli_mux_receive(frame, size);
+	TEST_EQUAL_INT(cli.TxXoff, 0);
+	test_handle();
+	TEST_EQUAL_INT(cli_mux_write(TEST_LOG, "12345", 5), 5);
+	TEST_EQUAL_INT(test_unframe(&channel, payload), 5);
+	TEST_EQUAL_INT(channel, TEST_LOG);
+	TEST_EQUAL_INT(test_unframe(&channel, payload), -1);
+
+	cli_tx_hold(&cli, 0);
+	TEST_EQUAL_INT(test_unframe(&channel, payload), 1);
+	TEST_EQUAL_INT(channel, TEST_SHELL);
+	TEST_EQUAL_INT(payload[0], 'h');
+	test_type(&cli, "\025");
+	while (test_unframe(&channel, payload) >= 0);
+}
+
+int main(void) {
+	vt100_init(&test_vt);
+	cli_init(&cli);
+	cli_mux_init(NULL);
+	TEST_EQUAL_INT(cli_mux_bind(TEST_SHELL, &cli, 1), CLI_OK);
+	TEST_EQUAL_INT(cli_mux_bind_stream(TEST_LOG, 0, test_receive), CLI_OK);
+	/* The prompt of the shell is in its ring: drop it */
+	uint8_t payload[CLI_MUX_FRAME];
+	int channel;
+	while (test_unframe(&channel, payload) >= 0);
+
+	test_round_trip();
+	test_shell();
+	test_priority();
+	test_hold();
+	test_flow();
+	return test_report("test_mux");
+}
@@ -0,0 +1,114 @@
+/*
+*******************************************************************************
+@file	test_poll.c
+@brief	Test of cli_poll_all: the budgets of the turn and the latency of the instances.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_ENABLE_POLL_ALL=TRUE CLI_USE_RING_BUFFER=TRUE CLI_POLL_INSTANCES=4
+*
+* Four loopback instances, each with its own terminal. The first one gets
+* a flood of command lines, the others one key now and then. Every turn the
+* flooded instance must keep to the budgets, and the keys of the others must
+* be echoed in the same call of 'cli_poll_all'.
+*/
+
+#include "test.h"
+
+#define TEST_INSTANCES 4
+#define TEST_TURNS     64
+
+static cli_t instances[TEST_INSTANCES];
+static vt100_t terminals[TEST_INSTANCES];
+
+static int test_putchar0(int ch) { vt100_putc(&terminals[0], (char)ch); return 0; }
+static int test_putchar1(int ch) { vt100_putc(&terminals[1], (char)ch); return 0; }
+static int test_putchar2(int ch) { vt100_putc(&terminals[2], (char)ch); return 0; }
+static int test_putchar3(int ch) { vt100_putc(&terminals[3], (char)ch); return 0; }
+
+static int (*const test_putchars[TEST_INSTANCES])(int) = {
+	test_putchar0, test_putchar1, test_putchar2, test_putchar3,
+};
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Fill the receive ring of the instance with command lines.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	offset Position in the line to start from, kept between calls.
+*
+*/
+static void test_flood(cli_t *cli, int *offset) {
+	static const char line[] = "example\r";
+	while (cli_ring_space(&cli->Rx)) {
+		cli_rx_push(cli, (const uint8_t*)&line[*offset], 1);
+		*offset = (*offset + 1) % (sizeof(line) - 1);
+	}
+}
+
+int main(void) {
+	vt100_init(&test_vt);
+	for (int i = 0; i < TEST_INSTANCES; i++) {
+		cli_init(&instances[i]);
+		instances[i]._io_putchar = test_putchars[i];
+		vt100_init(&terminals[i]);
+		TEST_EQUAL_INT(cli_register(&instances[i]), CLI_OK);
+	}
+
+	/* The output of one command: a turn may finish the command it started */
+	test_type(&instances[0], "example\r");
+	long command = terminals[0].Bytes;
+	TEST_CHECK(command > 0);
+	vt100_reset_counters(&terminals[0]);
+
+	int offset = 0;
+	for (int turn = 0; turn < TEST_TURNS; turn++) {
+		test_flood(&instances[0], &offset);
+		unsigned int before = cli_ring_count(&instances[0].Rx);
+		int key = 1 + turn % (TEST_INSTANCES - 1);
+		cli_rx_push(&instances[key], (const uint8_t*)"a", 1);
+		for (int i = 0; i < TEST_INSTANCES; i++) {
+			vt100_reset_counters(&terminals[i]);
+		}
+
+		TEST_EQUAL_INT(cli_poll_all(), 1);
+
+		/* The flood takes no more than its budgets */
+		TEST_CHECK(before - cli_ring_count(&instances[0].Rx) <= CLI_POLL_RX_BUDGET);
+		TEST_CHECK(terminals[0].Bytes <= CLI_POLL_TX_BUDGET + command);
+		/* The key is echoed in the same turn, the others stay quiet */
+		for (int i = 1; i < TEST_INSTANCES; i++) {
+			TEST_EQUAL_INT(terminals[i].Bytes, (i == key) ? 1 : 0);
+		}
+	}
+	/* The flooded instance still has work: it did not take the loop */
+	TEST_CHECK(cli_pending(&instances[0]));
+	for (int i = 1; i < TEST_INSTANCES; i++) {
+		TEST_EQUAL_INT(instances[i].Point, TEST_TURNS / (TEST_INSTANCES - 1) + ((i <= TEST_TURNS % (TEST_INSTANCES - 1)) ? 1 : 0));
+	}
+	return test_report("test_poll");
+}
@@ -0,0 +1,206 @@
+/*
+*******************************************************************************
+@file	test_replay.c
+@brief	A recorded session replayed by the host tool 'replay'.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_ENABLE_EMIT=TRUE CLI_ENABLE_TRACE=TRUE CLI_TRACE_SIZE=4096
+*
+* The same options as 'replay.c': the tool is the host build of this
+* "device". A session is typed with the line editor, the history and the
+* completion, and the output of the 'trace' command is saved as the
+* terminal log would be. The tool must replay it with the same output byte
+* for byte and measure every keystroke. A log with one sent byte changed
+* must be reported at that byte.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#include "test.h"
+
+#define KEY_UP        "\033[A"
+#define KEY_LEFT      "\033[D"
+#define KEY_BACKSPACE "\177"
+
+static cli_t cli;
+static FILE *test_log;                    // The terminal log of the 'trace' command
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Timestamps of the recording: nanoseconds of the host.
+* @return	`uint32_t` The time, wraps around.
+*/
+uint32_t __io_cli_cycles(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The output of the 'trace' command goes to the log.
+* @param	ch The byte.
+*
+*/
+static int test_log_putchar(int ch) {
+	fputc(ch, test_log);
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Type the keys one by one, as a person does.
+* @param	keys The keys.
+*
+*/
+static void test_keys(const char *keys) {
+	for (; *keys; keys++) {
+		test_type_bytes(&cli, keys, 1);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the tool on the log.
+* @param	path The log.
+* @param	output The output of the tool.
+* @param	size Size of the output.
+* @return	`int` The exit status of the tool, (-1) if it did not run.
+*/
+static int test_replay(const char *path, char *output, int size) {
+	char command[512];
+	snprintf(command, sizeof(command), "\"%s\" \"%s\" 2>&1", getenv("TEST_REPLAY"), path);
+	FILE *tool = popen(command, "r");
+	if (tool == NULL) {
+		return -1;
+	}
+	int length = fread(output, 1, size - 1, tool);
+	output[length] = '\0';
+	int status = pclose(tool);
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the number of the keystrokes of the histogram.
+* @param	output The output of the tool.
+* @param	title The name of the histogram.
+* @return	`int` The number, (-1) if not found.
+*/
+static int test_keystrokes(const char *output, const char *title) {
+	const char *line = strstr(output, title);
+	int measured;
+	if ((line == NULL) || (sscanf(line + strlen(title), ": %d keystrokes", &measured) != 1)) {
+		return -1;
+	}
+	return measured;
+}
+
+int main(int argc, char *argv[]) {
+	TEST_CHECK(getenv("TEST_REPLAY") != NULL);
+	char path[256], changed[256];
+	snprintf(path, sizeof(path), "%s.log", argv[0]);
+	snprintf(changed, sizeof(changed), "%s.changed.log", argv[0]);
+
+	/* The session */
+	vt100_init(&test_vt);
+	cli_init(&cli);
+	test_keys("form\t json\r");
+	test_keys("format\r");
+	test_keys("format text\r");
+	/* Not 'help': it prints the time of the build */
+	test_keys("trcae" KEY_BACKSPACE KEY_BACKSPACE KEY_BACKSPACE "ace bogus\r");
+	test_keys("nosuch" KEY_LEFT KEY_LEFT "x\r");
+	test_keys(KEY_UP KEY_UP KEY_UP "\r");
+
+	/* The log, as a terminal would save it */
+	test_log = fopen(path, "w");
+	TEST_CHECK(test_log != NULL);
+	if (test_log == NULL) {
+		return test_report("test_replay");
+	}
+	int (*io_putchar)(int) = cli._io_putchar;
+	cli._io_putchar = test_log_putchar;
+	test_keys("trace\r");
+	cli._io_putchar = io_putchar;
+	fclose(test_log);
+	TEST_CHECK(cli.Trace.Head < CLI_TRACE_SIZE);
+
+	/* The same output, every keystroke measured */
+	char output[4096];
+	TEST_EQUAL_INT(test_replay(path, output, sizeof(output)), 0);
+	TEST_CHECK(strstr(output, "output: same") != NULL);
+	int measured = test_keystrokes(output, "recorded latency, ticks");
+	TEST_CHECK(measured > 50);
+	TEST_EQUAL_INT(test_keystrokes(output, "replay latency, ns"), measured);
+	printf("%s", output);
+
+	/* One sent byte changed: the tool finds it */
+	FILE *in = fopen(path, "r");
+	FILE *out = fopen(changed, "w");
+	TEST_CHECK((in != NULL) && (out != NULL));
+	char line[128];
+	int events = 0, sent = -1, target = -1;
+	cli_trace_record_t record;
+	while ((in != NULL) && (out != NULL) && (fgets(line, sizeof(line), in) != NULL)) {
+		if (cli_trace_parse(line, &record) == CLI_OK) {
+			events++;
+		} else {
+			record.Event = CLI_TRACE_EVENTS;
+		}
+		/* The replay compares the output from the first received byte */
+		if ((record.Event == CLI_TRACE_RX) && (sent < 0)) {
+			sent = 0;
+		}
+		if ((record.Event == CLI_TRACE_TX) && (sent >= 0)) {
+			if ((sent == 100) && (target < 0)) {
+				target = sent;
+				snprintf(line, sizeof(line), "%10lu %-8s 0x%.2x\r\n", (unsigned long)record.Time,
+						cli_trace_name(record.Event), record.Value ^ 0x20);
+			}
+			sent++;
+		}
+		fputs(line, out);
+	}
+	if (in != NULL) fclose(in);
+	if (out != NULL) fclose(out);
+	TEST_EQUAL_INT(target, 100);
+	snprintf(line, sizeof(line), "%d events", events);
+	TEST_CHECK(strstr(output, line) != NULL);
+	TEST_EQUAL_INT(test_replay(changed, output, sizeof(output)), 1);
+	TEST_CHECK(strstr(output, "output: differs at byte 100") != NULL);
+
+	/* No trace */
+	TEST_EQUAL_INT(test_replay("/nonexistent", output, sizeof(output)), 2);
+	return test_report("test_replay");
+}
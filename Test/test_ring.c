@@ -0,0 +1,197 @@
+/*
+*******************************************************************************
+@file	test_ring.c
+@brief	Stress test of the receive ring: a thread in place of the UART interrupt.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_USE_RING_BUFFER=TRUE CLI_RX_RING_SIZE=1024
+*
+* A producer thread pushes the command lines one byte at a time at the rate
+* of the link, as the receive interrupt does. The main thread calls
+* 'cli_handler' only every few milliseconds, as a busy main loop would.
+* Up to the link rate the ring must take every byte: no drops and every
+* line run once, in order. A consumer that stops for longer than the ring
+* lasts must lose bytes, and they must be counted.
+*/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "test.h"
+
+#define TEST_RUN_MS       250   /* Length of each run */
+#define TEST_HANDLER_MS   2     /* Period of the main loop */
+
+typedef struct {
+	cli_t *Cli;
+	const char *Data;         // The stream of the lines
+	int Length;               // Its length
+	long Rate;                // Bytes per second
+	int Accepted;             // Bytes taken by the ring
+	volatile int Done;        // The producer has finished
+} test_link_t;
+
+static int test_next;         // The number of the next expected line
+static int test_disorder;     // The lines that came out of order
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Nanoseconds from any moment.
+* @return	`long long` The time.
+*/
+static long long test_now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Sleep for some microseconds.
+* @param	us The time.
+*
+*/
+static void test_sleep(long us) {
+	struct timespec pause = { .tv_sec = us / 1000000, .tv_nsec = (us % 1000000) * 1000 };
+	nanosleep(&pause, NULL);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The command of the stream: checks the number of the line.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	argc Number of arguments.
+* @param	argv The arguments.
+* @return	`int` CLI_OK.
+*/
+static int test_line(cli_t *cli, int argc, char *argv[]) {
+	if ((argc != 2) || (atoi(argv[1]) != test_next)) {
+		test_disorder++;
+	}
+	test_next++;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The receive interrupt: every byte is pushed as soon as the link
+*       	has delivered it.
+* @param	arg The link (`test_link_t`).
+* @return	`void*` NULL.
+*/
+static void *test_producer(void *arg) {
+	test_link_t *link = arg;
+	long long start = test_now();
+	int sent = 0;
+	while (sent < link->Length) {
+		long long due = (test_now() - start) * link->Rate / 1000000000LL;
+		while ((sent < due) && (sent < link->Length)) {
+			link->Accepted += cli_rx_push(link->Cli, (const uint8_t*)&link->Data[sent++], 1);
+		}
+		test_sleep(50);
+	}
+	link->Done = 1;
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the stream of the lines through the instance.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	baud Rate of the link, 10 bits per byte.
+* @param	stall Time the main loop stops once in the middle, ms.
+* @param	lines Number of the lines sent, returned.
+* @return	`int` Bytes pushed to the ring.
+*/
+static int test_run(cli_t *cli, long baud, int stall, int *lines) {
+	static char data[65536];
+	test_link_t link = { .Cli = cli, .Data = data, .Rate = baud / 10 };
+	int count = 0;
+	while (link.Length < (int)(link.Rate * TEST_RUN_MS / 1000)) {
+		link.Length += sprintf(&data[link.Length], "n %d\r", count++);
+	}
+	*lines = count;
+	test_next = 0;
+	test_disorder = 0;
+	cli->RxDropped = 0;
+
+	pthread_t producer;
+	pthread_create(&producer, NULL, test_producer, &link);
+	unsigned int peak = 0;
+	int stalled = 0;
+	while (!link.Done || cli_pending(cli)) {
+		unsigned int used = cli_ring_count(&cli->Rx);
+		if (used > peak) {
+			peak = used;
+		}
+		while (cli_pending(cli)) {
+			cli_handler(cli);
+		}
+		if (stall && !stalled && (test_next > count / 2)) {
+			stalled = 1;
+			test_sleep(stall * 1000L);
+		} else {
+			test_sleep(TEST_HANDLER_MS * 1000L);
+		}
+	}
+	pthread_join(producer, NULL);
+	printf("test_ring: %ld baud, stall %d ms: peak %u of %d bytes, %d dropped\n",
+			baud, stall, peak, CLI_RX_RING_SIZE, (int)cli->RxDropped);
+	return link.Accepted;
+}
+
+int main(void) {
+	static cli_t cli;
+	vt100_init(&test_vt);
+	cli_init(&cli);
+	TEST_CHECK(cli_add(&cli, "n", test_line, "Line of the stream") > 0);
+
+	/* Up to the link rate nothing is lost */
+	static const long rates[] = { 9600, 115200, 460800 };
+	for (unsigned int i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+		int lines;
+		int accepted = test_run(&cli, rates[i], 0, &lines);
+		TEST_EQUAL_INT(cli.RxDropped, 0);
+		TEST_EQUAL_INT(test_next, lines);
+		TEST_EQUAL_INT(test_disorder, 0);
+		TEST_CHECK(accepted > 0);
+	}
+
+	/* A stall longer than the ring lasts loses bytes, all of them counted */
+	int lines;
+	int accepted = test_run(&cli, 460800, 100, &lines);
+	TEST_CHECK(cli.RxDropped > 0);
+	int length = 0;
+	for (int i = 0; i < lines; i++) {
+		length += snprintf(NULL, 0, "n %d\r", i);
+	}
+	TEST_EQUAL_INT(accepted + (int)cli.RxDropped, length);
+	return test_report("test_ring");
+}
@@ -0,0 +1,154 @@
+/*
+*******************************************************************************
+@file	test_screen.c
+@brief	Test of the live screen: only the changed cells are sent.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_ENABLE_SCREEN=TRUE
+*
+* After each commit the emulated terminal must show the frame cell by cell
+* (the symbols and the attributes), the bytes it received are the bytes
+* counted by the screen, and a change of a few cells costs a few bytes.
+*/
+
+#include "test.h"
+#include "screen.h"
+
+#define TEST_TASKS     8
+
+static cli_t cli;
+static cli_screen_t *screen;
+static unsigned int load[TEST_TASKS];
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Draw the frame of the task table.
+* @param	uptime Seconds in the header.
+*
+*/
+static void test_draw(unsigned int uptime) {
+	cli_screen_clear(screen);
+	cli_screen_attr(screen, CLI_SCREEN_BOLD);
+	cli_screen_printf(screen, 0, 0, "uptime %u s", uptime);
+	for (int i = 0; i < TEST_TASKS; i++) {
+		cli_screen_attr(screen, (load[i] > 90) ? CLI_SCREEN_COLOR(CLI_SCREEN_RED) : 0);
+		cli_screen_printf(screen, 2 + i, 0, "task%-4d %3u%%", i, load[i]);
+	}
+	cli_screen_attr(screen, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Commit the frame and compare the terminal with it.
+* @return	`int` Bytes of the frame.
+*/
+static int test_commit(void) {
+	vt100_reset_counters(&test_vt);
+	int bytes = cli_screen_commit(&cli);
+	TEST_EQUAL_INT(test_vt.Bytes, bytes);
+	TEST_EQUAL_INT(screen->FrameBytes, bytes);
+	TEST_EQUAL_INT(test_vt.Unknown, 0);
+	int differ = 0;
+	for (int row = 0; row < CLI_SCREEN_ROWS; row++) {
+		for (int col = 0; col < CLI_SCREEN_COLS; col++) {
+			cli_cell_t cell = screen->Back[row][col];
+			vt100_cell_t shown = test_vt.Cells[row][col];
+			int color = (cell.Attr >> 4) ? 90 + (cell.Attr >> 4) - 1 : 0;
+			/* The attributes of a blank are not seen */
+			if ((shown.Symbol != cell.Symbol) ||
+					((cell.Symbol != ' ') && ((shown.Attr != (cell.Attr & 0x0F)) || (shown.Foreground != color)))) {
+				differ++;
+			}
+		}
+	}
+	TEST_EQUAL_INT(differ, 0);
+	return bytes;
+}
+
+int main(void) {
+	vt100_init(&test_vt);
+	cli_init(&cli);
+	screen = cli_screen_open(&cli, 0, NULL);
+	TEST_CHECK(screen != NULL);
+	TEST_CHECK(test_vt.CursorHidden);
+	TEST_EQUAL_STR(vt100_row(&test_vt, 0), "");
+
+	/* The first frame: everything is new */
+	for (int i = 0; i < TEST_TASKS; i++) {
+		load[i] = 10 * i + 5;
+	}
+	load[3] = 95;
+	test_draw(1);
+	int first = test_commit();
+	TEST_EQUAL_STR(vt100_row(&test_vt, 0), "uptime 1 s");
+	TEST_EQUAL_STR(vt100_row(&test_vt, 5), "task3     95%");
+	TEST_EQUAL_INT(test_vt.Cells[5][0].Foreground, 91);
+	TEST_EQUAL_INT(test_vt.Cells[0][0].Attr, VT100_BOLD);
+	TEST_CHECK(first < (int)screen->FrameFullBytes);
+
+	/* One digit: the position, the bold and the digit */
+	test_draw(2);
+	TEST_AT_MOST(test_commit(), 11);
+	TEST_EQUAL_STR(vt100_row(&test_vt, 0), "uptime 2 s");
+
+	/* The same frame: nothing is sent */
+	test_draw(2);
+	TEST_EQUAL_INT(test_commit(), 0);
+
+	/* All the loads change: less than the frame from a clear screen */
+	for (int i = 0; i < TEST_TASKS; i++) {
+		load[i] = (load[i] + 37) % 100;
+	}
+	test_draw(3);
+	int changed = test_commit();
+	TEST_CHECK(changed < (int)screen->FrameFullBytes);
+	TEST_AT_MOST(changed, 91);
+
+	/* Only the color of a row changes */
+	load[0] = 99;
+	test_draw(3);
+	TEST_AT_MOST(test_commit(), 22);
+	TEST_EQUAL_INT(test_vt.Cells[2][0].Foreground, 91);
+
+	/* A long text erased: the rest of the row is cleared */
+	cli_screen_text(screen, 12, 0, "a long line of the text to be erased later");
+	test_commit();
+	test_draw(3);
+	TEST_AT_MOST(test_commit(), 4);
+	TEST_EQUAL_STR(vt100_row(&test_vt, 12), "");
+
+	TEST_EQUAL_INT(screen->Frames, 7);
+	TEST_CHECK(screen->Bytes < screen->FullBytes);
+
+	/* The prompt comes back below the screen */
+	TEST_EQUAL_INT(cli_screen_close(&cli), CLI_OK);
+	TEST_CHECK(!test_vt.CursorHidden);
+	TEST_EQUAL_INT(cli_screen_close(&cli), CLI_ERROR);
+	return test_report("test_screen");
+}
@@ -0,0 +1,111 @@
+/*
+*******************************************************************************
+@file	test_terminal.c
+@brief	Test of the line editor: the screen after the keys and the bytes sent for them.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_EXAMPLE_ENABLE=TRUE
+*
+* Each scenario types the keys into the instance, checks the line on the
+* screen of the emulator and the cursor, and the bytes and escape sequences
+* sent for them. The budgets are the current traffic: a change of the line
+* editor that sends more fails the test.
+*/
+
+#include "test.h"
+
+#define KEY_UP        "\033[A"
+#define KEY_DOWN      "\033[B"
+#define KEY_RIGHT     "\033[C"
+#define KEY_LEFT      "\033[D"
+#define KEY_DELETE    "\033[3~"
+#define KEY_HOME      "\033[H"
+#define KEY_END       "\033[F"
+#define KEY_BACKSPACE "\177"
+#define KEY_KILL      "\025"
+
+static cli_t cli;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Type the keys and check the line of the cursor and the traffic.
+* @param	keys The keys.
+* @param	line The expected row of the cursor.
+* @param	col The expected column of the cursor.
+* @param	bytes The budget of the bytes.
+* @param	sequences The budget of the escape sequences.
+*
+*/
+static void test_scenario(const char *keys, const char *line, int col, long bytes, long sequences) {
+	vt100_reset_counters(&test_vt);
+	test_type(&cli, keys);
+	TEST_EQUAL_STR(vt100_row(&test_vt, test_vt.Row), line);
+	TEST_EQUAL_INT(test_vt.Col, col);
+	TEST_EQUAL_INT(test_vt.Unknown, 0);
+	TEST_AT_MOST(test_vt.Bytes, bytes);
+	TEST_AT_MOST(test_vt.Sequences, sequences);
+}
+
+int main(void) {
+	vt100_init(&test_vt);
+	cli_init(&cli);
+	TEST_EQUAL_STR(vt100_row(&test_vt, 0), "Command Line Interpreter initialized");
+	TEST_EQUAL_STR(vt100_row(&test_vt, 1), ">");
+	TEST_EQUAL_INT(test_vt.Row, 1);
+	TEST_EQUAL_INT(test_vt.Col, 1);
+
+	/* The symbols at the end of the line are only echoed */
+	test_scenario("help", ">help", 5, 4, 0);
+	/* Insert in the middle: the tail is sent again */
+	test_scenario(KEY_LEFT KEY_LEFT, ">help", 3, 6, 2);
+	test_scenario("xy", ">hexylp", 5, 8, 1);
+	test_scenario(KEY_BACKSPACE, ">hexlp", 4, 13, 3);
+	test_scenario(KEY_DELETE, ">hexp", 4, 8, 2);
+	test_scenario(KEY_HOME, ">hexp", 1, 4, 1);
+	test_scenario(KEY_END, ">hexp", 5, 4, 1);
+	test_scenario(KEY_KILL, ">", 1, 7, 2);
+
+	/* The command runs and goes to the history */
+	test_scenario("example\r", ">", 1, 58, 2);
+	TEST_EQUAL_STR(vt100_row(&test_vt, test_vt.Row - 1), "        argv[0] - 'example'");
+	test_scenario(KEY_UP, ">example", 8, 12, 1);
+	test_scenario(KEY_KILL, ">", 1, 7, 2);
+
+	/* Tab: the only candidate, then the listing of all of them */
+	test_scenario("he\t", ">help", 6, 5, 0);
+	test_scenario(KEY_KILL "wr\t", ">write_buffer", 14, 20, 2);
+	test_scenario(KEY_KILL "\t", ">", 1, 84, 3);
+	TEST_EQUAL_STR(vt100_row(&test_vt, test_vt.Row - 1), "help          clear         example       read_buffer   write_buffer");
+
+	/* A paste in the middle of the line: the tail is drawn once, not after
+	 * each symbol (that was 6 bytes per symbol here, 120 for the paste) */
+	test_scenario("ab" KEY_LEFT, ">ab", 2, 5, 1);
+	test_scenario("0123456789abcdefghij", ">a0123456789abcdefghijb", 22, 25, 1);
+	return test_report("test_terminal");
+}
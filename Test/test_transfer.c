@@ -0,0 +1,346 @@
+/*
+*******************************************************************************
+@file	test_transfer.c
+@brief	Loopback test of the XMODEM commands rx and sx.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_USE_RING_BUFFER=TRUE CLI_RX_RING_SIZE=2048 CLI_TRANSFER_ENABLE=TRUE
+*
+* The far end of the link is simulated here: a sender for 'rx' and a
+* receiver for 'sx', with their own framing and CRC. The blob goes both
+* ways through a target whose callbacks write to (and read from) memory,
+* and must come back the same, padded with 0x1A. The clock of the CLI is
+* the link: each byte takes 10 bits of time, so the effective throughput
+* is measured against the raw rate of the link.
+*/
+
+#include "test.h"
+#include "Function/transfer.h"
+
+#define TEST_BAUD         115200
+#define TEST_BLOB         (9 * 1024 + 100)  /* The last block of 'sx' is short */
+#define TEST_TURNAROUND   1000              /* Time the far end takes to answer, us */
+
+#define TEST_SOH          0x01
+#define TEST_STX          0x02
+#define TEST_EOT          0x04
+#define TEST_ACK          0x06
+#define TEST_NAK          0x15
+#define TEST_CAN          0x18
+
+typedef enum {
+	TEST_PEER_IDLE = 0,                    // The transfer is not started
+	TEST_PEER_SEND,                        // Sends the blob to 'rx'
+	TEST_PEER_RECEIVE,                     // Receives the blob from 'sx'
+	TEST_PEER_DONE                         // The transfer is over
+} test_peer_state_t;
+
+static cli_t cli;
+static uint8_t blob[TEST_BLOB];
+static uint8_t sink[TEST_BLOB + 1024];      // Data written by the target
+static int sink_length;
+static uint8_t peer_data[TEST_BLOB + 1024]; // Data received by the far end
+static int peer_length;
+static uint8_t peer_block[1024 + 5];
+static int peer_fill;
+static int peer_state;
+static int peer_number;                    // Number of the block sent
+static int peer_started;                   // 'C' sent to 'sx'
+static int peer_corrupt;                   // Number of the block to spoil once
+static int peer_naks;                      // NAKs received from 'rx'
+static int peer_errors;                    // Bad blocks from 'sx'
+static unsigned long long link_us;         // The clock of the link
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The clock of the CLI is the time of the link.
+* @return	`uint32_t` Milliseconds.
+*/
+uint32_t __io_cli_millis(void) {
+	return (uint32_t)(link_us / 1000);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The CLI waits for the far end: the receiver of 'sx' starts here,
+*       	otherwise the silence of the link passes.
+* @param	timeout Time to wait, ms.
+* @return	`int` (0).
+*/
+int __io_cli_wait(int timeout) {
+	if ((peer_state == TEST_PEER_RECEIVE) && !peer_started) {
+		peer_started = 1;
+		cli_rx_push(&cli, (const uint8_t*)"C", 1);
+		return 0;
+	}
+	link_us += (unsigned long long)timeout * 1000;
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	CRC-16/XMODEM, bit by bit: independent of the table of the CLI.
+* @param	data Data.
+* @param	length Number of bytes.
+* @return	`uint16_t` CRC.
+*/
+static uint16_t test_crc(const uint8_t *data, int length) {
+	uint16_t crc = 0;
+	for (int i = 0; i < length; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The far end puts the bytes on the link, towards the CLI.
+* @param	data The bytes.
+* @param	length Number of the bytes.
+*
+*/
+static void test_peer_push(const uint8_t *data, int length) {
+	link_us += TEST_TURNAROUND + (unsigned long long)length * 10 * 1000000 / TEST_BAUD;
+	TEST_EQUAL_INT(cli_rx_push(&cli, data, length), length);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The sender sends the next block of the blob, or EOT at the end.
+*
+*/
+static void test_peer_block(void) {
+	uint8_t block[1024 + 5];
+	int offset = (peer_number - 1) * 1024;
+	if (offset >= TEST_BLOB) {
+		test_peer_push((const uint8_t[]){ TEST_EOT }, 1);
+		return;
+	}
+	int count = (TEST_BLOB - offset < 1024) ? TEST_BLOB - offset : 1024;
+	block[0] = TEST_STX;
+	block[1] = peer_number;
+	block[2] = ~peer_number;
+	memcpy(&block[3], &blob[offset], count);
+	memset(&block[3 + count], 0x1A, 1024 - count);
+	uint16_t crc = test_crc(&block[3], 1024);
+	block[1027] = crc >> 8;
+	block[1028] = crc & 0xff;
+	if (peer_number == peer_corrupt) {
+		/* The noise of the link: the block is spoiled once */
+		peer_corrupt = 0;
+		block[500] ^= 0x40;
+	}
+	test_peer_push(block, sizeof(block));
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The receiver takes a byte of a block from 'sx'.
+* @param	ch The byte.
+*
+*/
+static void test_peer_receive(uint8_t ch) {
+	if ((peer_fill == 0) && (ch == TEST_EOT)) {
+		test_peer_push((const uint8_t[]){ TEST_ACK }, 1);
+		peer_state = TEST_PEER_DONE;
+		return;
+	}
+	peer_block[peer_fill++] = ch;
+	int length = (peer_block[0] == TEST_STX) ? 1024 : 128;
+	if (peer_fill < length + 5) {
+		return;
+	}
+	peer_fill = 0;
+	uint16_t crc = (peer_block[length + 3] << 8) | peer_block[length + 4];
+	if (((peer_block[0] != TEST_STX) && (peer_block[0] != TEST_SOH)) ||
+		(peer_block[1] != (uint8_t)(peer_number + 1)) || ((uint8_t)~peer_block[1] != peer_block[2]) ||
+		(test_crc(&peer_block[3], length) != crc)) {
+		peer_errors++;
+		test_peer_push((const uint8_t[]){ TEST_NAK }, 1);
+		return;
+	}
+	peer_number++;
+	memcpy(&peer_data[peer_length], &peer_block[3], length);
+	peer_length += length;
+	test_peer_push((const uint8_t[]){ TEST_ACK }, 1);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The link: the output of the CLI goes to the far end.
+* @param	ch The byte.
+* @return	`int` (0).
+*/
+static int test_link(int ch) {
+	link_us += 10 * 1000000 / TEST_BAUD;
+	switch (peer_state) {
+	case TEST_PEER_SEND:
+		if (ch == 'C') {
+			test_peer_block();
+		} else if (ch == TEST_NAK) {
+			peer_naks++;
+			test_peer_block();
+		} else if (ch == TEST_ACK) {
+			if ((peer_number - 1) * 1024 >= TEST_BLOB) {
+				peer_state = TEST_PEER_DONE;
+			} else {
+				peer_number++;
+				test_peer_block();
+			}
+		} else if (ch == TEST_CAN) {
+			peer_state = TEST_PEER_DONE;
+		}
+		break;
+	case TEST_PEER_RECEIVE:
+		if (peer_started) {
+			test_peer_receive((uint8_t)ch);
+		}
+		break;
+	default:
+		/* The echo, the prompt and the report of the command */
+		break;
+	}
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The target: the received data goes to the sink.
+* @param	context Unused.
+* @param	offset Position of the data in the transfer.
+* @param	data The data.
+* @param	length Number of the bytes.
+* @return	`int` CLI_OK, or CLI_ERROR if the data is out of order.
+*/
+static int test_write(void *context, uint32_t offset, const uint8_t *data, int length) {
+	if ((offset != (uint32_t)sink_length) || (sink_length + length > (int)sizeof(sink))) {
+		return CLI_ERROR;
+	}
+	memcpy(&sink[offset], data, length);
+	sink_length += length;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The target: the data to send is the blob.
+* @param	context Unused.
+* @param	offset Position of the data in the transfer.
+* @param	data Buffer for the data.
+* @param	length Size of the buffer.
+* @return	`int` Number of the bytes, (0) at the end of the blob.
+*/
+static int test_read(void *context, uint32_t offset, uint8_t *data, int length) {
+	if (offset >= TEST_BLOB) {
+		return 0;
+	}
+	int count = (TEST_BLOB - offset < (uint32_t)length) ? TEST_BLOB - offset : length;
+	memcpy(data, &blob[offset], count);
+	return count;
+}
+
+static const cli_transfer_target_t test_target = {
+	.Name = "blob", .Write = test_write, .Read = test_read,
+};
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the command over the link and report its throughput.
+* @param	line The command.
+* @param	state The part of the far end.
+* @param	bytes The payload.
+* @return	`long` Effective throughput in per mille of the raw link rate.
+*/
+static long test_transfer(const char *line, int state, int bytes) {
+	peer_state = TEST_PEER_IDLE;
+	peer_number = 1;
+	peer_fill = 0;
+	peer_started = 0;
+	test_type(&cli, line);
+	/* The line is typed: the command starts the transfer with the next key */
+	unsigned long long start = link_us;
+	peer_state = state;
+	peer_number = (state == TEST_PEER_SEND) ? 1 : 0;
+	test_type(&cli, "\r");
+	unsigned long long time = link_us - start;
+	TEST_EQUAL_INT(peer_state, TEST_PEER_DONE);
+	long permille = (long)((unsigned long long)bytes * 10 * 1000000 / TEST_BAUD * 1000 / time);
+	printf("test_transfer: %s%s: %d bytes in %llu ms, %ld.%ld%% of the link\n",
+			line, (peer_naks || peer_errors) ? " (with a bad block)" : "", bytes, time / 1000, permille / 10, permille % 10);
+	return permille;
+}
+
+int main(void) {
+	vt100_init(&test_vt);
+	cli_init(&cli);
+	cli._io_putchar = test_link;
+	TEST_EQUAL_INT(cli_transfer_add(&test_target), CLI_OK);
+	for (int i = 0; i < TEST_BLOB; i++) {
+		blob[i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+	int blocks = (TEST_BLOB + 1023) / 1024;
+
+	/* rx: the far end sends, the target gets the blob padded to the block */
+	long permille = test_transfer("rx blob", TEST_PEER_SEND, blocks * 1024);
+	TEST_EQUAL_INT(sink_length, blocks * 1024);
+	TEST_CHECK(!memcmp(sink, blob, TEST_BLOB));
+	int padded = 1;
+	for (int i = TEST_BLOB; i < sink_length; i++) {
+		padded &= (sink[i] == 0x1A);
+	}
+	TEST_CHECK(padded);
+	TEST_EQUAL_INT(peer_naks, 0);
+	/* The blocks of 1 KiB: 5 bytes of framing, the ACK and the turnaround */
+	TEST_CHECK(permille >= 950);
+
+	/* sx: the far end receives the blob, the short tail in a block of 128 */
+	permille = test_transfer("sx blob", TEST_PEER_RECEIVE, TEST_BLOB);
+	TEST_EQUAL_INT(peer_errors, 0);
+	TEST_EQUAL_INT(peer_length, (blocks - 1) * 1024 + 128);
+	TEST_CHECK(!memcmp(peer_data, blob, TEST_BLOB));
+	padded = 1;
+	for (int i = TEST_BLOB; i < peer_length; i++) {
+		padded &= (peer_data[i] == 0x1A);
+	}
+	TEST_CHECK(padded);
+	TEST_CHECK(permille >= 950);
+
+	/* A spoiled block is refused by its CRC and sent again */
+	sink_length = 0;
+	memset(sink, 0, sizeof(sink));
+	peer_corrupt = 3;
+	test_transfer("rx blob", TEST_PEER_SEND, blocks * 1024);
+	TEST_EQUAL_INT(peer_naks, 1);
+	TEST_EQUAL_INT(sink_length, blocks * 1024);
+	TEST_CHECK(!memcmp(sink, blob, TEST_BLOB));
+	return test_report("test_transfer");
+}
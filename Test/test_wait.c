@@ -0,0 +1,179 @@
+/*
+*******************************************************************************
+@file	test_wait.c
+@brief	Idle CPU and wakeup latency of cli_wait on the POSIX port.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+/*
+* @options	CLI_CUSTOM_IO=FALSE CLI_FOR_POSIX=TRUE CLI_ENABLE_LOG=TRUE
+*
+* The instance runs on the POSIX port, with the standard input replaced by
+* an empty pipe. Idle, 'cli_wait' must sleep in 'poll()' and take almost no
+* CPU. A record of 'cli_log' from another thread and a key written to the
+* input must wake it up at once, long before its timeout.
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "test.h"
+
+#define TEST_IDLE_WAITS   10    /* Sleeps of the idle run */
+#define TEST_IDLE_MS      30    /* Timeout of each of them */
+#define TEST_WAKEUPS      20    /* Wakeups of each kind */
+#define TEST_TIMEOUT_MS   1000  /* Timeout of the waits that must be woken up */
+#define TEST_LATENCY_US   50000 /* The longest wakeup allowed: a loaded host */
+
+static cli_t cli;
+static int test_input[2];                 // The standard input of the port [read, write]
+static volatile long long test_sent;      // Time of the last event
+static volatile int test_key;             // The events are the keys, not the log
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Nanoseconds of the clock.
+* @param	clock The clock.
+* @return	`long long` The time.
+*/
+static long long test_now(clockid_t clock) {
+	struct timespec now;
+	clock_gettime(clock, &now);
+	return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The output of the instance is not checked here.
+* @param	ch The byte.
+* @return	`int` (0).
+*/
+static int test_discard(int ch) {
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The other thread: an event every few milliseconds.
+* @param	arg Unused.
+* @return	`void*` NULL.
+*/
+static void *test_events(void *arg) {
+	for (int i = 0; i < TEST_WAKEUPS; i++) {
+		struct timespec pause = { .tv_sec = 0, .tv_nsec = 5000000 };
+		nanosleep(&pause, NULL);
+		test_sent = test_now(CLOCK_MONOTONIC);
+		if (test_key) {
+			if (write(test_input[1], "a", 1) != 1) {
+				test_sent = 0;
+			}
+		} else {
+			cli_log(&cli, "event %d", i);
+		}
+	}
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Sleep in 'cli_wait' for each event of the other thread.
+* @param	key The events are the keys written to the input.
+* @param	name The name of the events.
+*
+*/
+static void test_wakeups(int key, const char *name) {
+	long latency[TEST_WAKEUPS];
+	test_key = key;
+	test_sent = 0;
+	pthread_t thread;
+	pthread_create(&thread, NULL, test_events, NULL);
+	for (int i = 0; i < TEST_WAKEUPS; i++) {
+		long long before = test_sent;
+		TEST_EQUAL_INT(cli_wait(&cli, TEST_TIMEOUT_MS), CLI_OK);
+		long long woken = test_now(CLOCK_MONOTONIC);
+		TEST_CHECK(test_sent != before);
+		latency[i] = (long)((woken - test_sent) / 1000);
+		TEST_CHECK(latency[i] < TEST_LATENCY_US);
+		/* The instance takes the event and sees that nothing more came */
+		int turn = 0;
+		do {
+			cli_handler(&cli);
+		} while (cli_pending(&cli) && (++turn < 4));
+		TEST_CHECK(!cli_pending(&cli));
+	}
+	pthread_join(thread, NULL);
+
+	long sorted[TEST_WAKEUPS];
+	memcpy(sorted, latency, sizeof(sorted));
+	for (int i = 1; i < TEST_WAKEUPS; i++) {
+		for (int j = i; (j > 0) && (sorted[j - 1] > sorted[j]); j--) {
+			long swap = sorted[j];
+			sorted[j] = sorted[j - 1];
+			sorted[j - 1] = swap;
+		}
+	}
+	printf("test_wait: wakeup by %s: median %ld us, max %ld us\n", name, sorted[TEST_WAKEUPS / 2], sorted[TEST_WAKEUPS - 1]);
+}
+
+int main(void) {
+	/* The port reads the standard input: an empty pipe */
+	TEST_EQUAL_INT(pipe(test_input), 0);
+	dup2(test_input[0], STDIN_FILENO);
+	/* The greeting of 'cli_init' goes to the standard output of the port */
+	fflush(stdout);
+	int out = dup(STDOUT_FILENO);
+	int null = open("/dev/null", O_WRONLY);
+	dup2(null, STDOUT_FILENO);
+	cli_init(&cli);
+	dup2(out, STDOUT_FILENO);
+	close(null);
+	close(out);
+	cli._io_putchar = test_discard;
+	cli_handler(&cli);
+	cli_handler(&cli);
+	TEST_CHECK(!cli_pending(&cli));
+
+	/* Idle: the time is spent asleep */
+	long long wall = test_now(CLOCK_MONOTONIC);
+	long long cpu = test_now(CLOCK_PROCESS_CPUTIME_ID);
+	for (int i = 0; i < TEST_IDLE_WAITS; i++) {
+		cli_wait(&cli, TEST_IDLE_MS);
+	}
+	wall = test_now(CLOCK_MONOTONIC) - wall;
+	cpu = test_now(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+	printf("test_wait: idle: %lld us of CPU in %lld ms\n", cpu / 1000, wall / 1000000);
+	TEST_CHECK(wall >= TEST_IDLE_WAITS * TEST_IDLE_MS * 1000000LL);
+	/* A busy loop would take all of it */
+	TEST_CHECK(cpu * 20 < wall);
+
+	test_wakeups(0, "cli_log");
+	test_wakeups(1, "a key");
+	return test_report("test_wait");
+}
@@ -0,0 +1,329 @@
+/*
+*******************************************************************************
+@file	vt100.c
+@brief	A VT100 screen emulator for the host tests: it renders the output of the CLI and counts the bytes.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "vt100.h"
+
+#define VT100_STATE_TEXT           0
+#define VT100_STATE_ESCAPE         1
+#define VT100_STATE_CSI            2
+
+static const vt100_cell_t vt100_blank = {' ', 0, 0, 0};
+
+static void vt100_clear(vt100_t *vt, int row, int from, int to);
+static void vt100_line_feed(vt100_t *vt);
+static void vt100_execute(vt100_t *vt, char final);
+static void vt100_sgr(vt100_t *vt, const int *params, int count);
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Empty screen, the cursor at the top left corner.
+* @param	vt The emulator.
+*
+*/
+void vt100_init(vt100_t *vt) {
+	memset(vt, 0, sizeof(*vt));
+	for (int row = 0; row < VT100_ROWS; row++) {
+		vt100_clear(vt, row, 0, VT100_COLS);
+	}
+	vt->Pen = vt100_blank;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Start counting the bytes of the next scenario. The screen stays.
+* @param	vt The emulator.
+*
+*/
+void vt100_reset_counters(vt100_t *vt) {
+	vt->Bytes = 0;
+	vt->Sequences = 0;
+	vt->Unknown = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Receive one byte from the CLI.
+* @param	vt The emulator.
+* @param	ch The byte.
+*
+*/
+void vt100_putc(vt100_t *vt, char ch) {
+	vt->Bytes++;
+	switch (vt->State) {
+	case VT100_STATE_ESCAPE:
+		vt->State = VT100_STATE_TEXT;
+		if (ch == '[') {
+			vt->State = VT100_STATE_CSI;
+			vt->ParamLength = 0;
+		} else if (ch == 'c') {
+			/* Reset of the terminal */
+			vt100_init(vt);
+		} else {
+			vt->Unknown++;
+		}
+		return;
+	case VT100_STATE_CSI:
+		if ((ch >= 0x30) && (ch <= 0x3F)) {
+			if (vt->ParamLength < (int)sizeof(vt->Params) - 1) {
+				vt->Params[vt->ParamLength++] = ch;
+			}
+		} else {
+			vt->Params[vt->ParamLength] = 0;
+			vt->State = VT100_STATE_TEXT;
+			vt100_execute(vt, ch);
+		}
+		return;
+	default:
+		break;
+	}
+	switch (ch) {
+	case '\033':
+		vt->State = VT100_STATE_ESCAPE;
+		vt->Sequences++;
+		break;
+	case '\r':
+		vt->Col = 0;
+		break;
+	case '\n':
+		vt100_line_feed(vt);
+		break;
+	case '\b':
+		if (vt->Col > 0) vt->Col--;
+		break;
+	case '\t':
+		vt->Col = (vt->Col / 8 + 1) * 8;
+		if (vt->Col >= VT100_COLS) vt->Col = VT100_COLS - 1;
+		break;
+	default:
+		if ((unsigned char)ch < 0x20) break;
+		if (vt->Col >= VT100_COLS) {
+			/* Wrap to the next row */
+			vt->Col = 0;
+			vt100_line_feed(vt);
+		}
+		vt->Cells[vt->Row][vt->Col] = vt->Pen;
+		vt->Cells[vt->Row][vt->Col].Symbol = ch;
+		vt->Col++;
+		break;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Receive the bytes from the CLI.
+* @param	vt The emulator.
+* @param	data The bytes.
+* @param	length Number of the bytes.
+*
+*/
+void vt100_write(vt100_t *vt, const void *data, size_t length) {
+	const char *bytes = data;
+	for (size_t i = 0; i < length; i++) {
+		vt100_putc(vt, bytes[i]);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the symbols of the row without the trailing spaces.
+* @param	vt The emulator.
+* @param	row The row, from (0).
+* @return	`const char*` The text, valid until the next call.
+*/
+const char *vt100_row(vt100_t *vt, int row) {
+	int length = 0;
+	for (int col = 0; col < VT100_COLS; col++) {
+		vt->Text[col] = vt->Cells[row][col].Symbol;
+		if (vt->Text[col] != ' ') length = col + 1;
+	}
+	vt->Text[length] = 0;
+	return vt->Text;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Erase the cells of the row.
+* @param	vt The emulator.
+* @param	row The row.
+* @param	from The first column.
+* @param	to The column after the last one.
+*
+*/
+static void vt100_clear(vt100_t *vt, int row, int from, int to) {
+	for (int col = from; col < to; col++) {
+		vt->Cells[row][col] = vt100_blank;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Move the cursor down, the screen scrolls at the last row.
+* @param	vt The emulator.
+*
+*/
+static void vt100_line_feed(vt100_t *vt) {
+	if (vt->Row < VT100_ROWS - 1) {
+		vt->Row++;
+		return;
+	}
+	memmove(vt->Cells[0], vt->Cells[1], sizeof(vt->Cells[0]) * (VT100_ROWS - 1));
+	vt100_clear(vt, VT100_ROWS - 1, 0, VT100_COLS);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the control sequence (CSI).
+* @param	vt The emulator.
+* @param	final The final byte of the sequence.
+*
+*/
+static void vt100_execute(vt100_t *vt, char final) {
+	if (vt->Params[0] == '?') {
+		/* Only the visibility of the cursor is known */
+		if (!strcmp(vt->Params, "?25") && ((final == 'h') || (final == 'l'))) {
+			vt->CursorHidden = (final == 'l');
+		} else {
+			vt->Unknown++;
+		}
+		return;
+	}
+	int params[8] = {0};
+	int count = 0;
+	for (const char *param = vt->Params; count < 8; count++) {
+		params[count] = atoi(param);
+		param = strchr(param, ';');
+		if (param == NULL) {
+			count++;
+			break;
+		}
+		param++;
+	}
+	int n = (params[0] > 0) ? params[0] : 1;
+	switch (final) {
+	case 'A':
+		vt->Row -= n;
+		break;
+	case 'B':
+		vt->Row += n;
+		break;
+	case 'C':
+		vt->Col += n;
+		break;
+	case 'D':
+		/* After the last column the cursor is still in it */
+		if (vt->Col >= VT100_COLS) vt->Col = VT100_COLS - 1;
+		vt->Col -= n;
+		break;
+	case 'G':
+		vt->Col = n - 1;
+		break;
+	case 'H':
+	case 'f':
+		vt->Row = n - 1;
+		vt->Col = ((count > 1) && (params[1] > 0)) ? params[1] - 1 : 0;
+		break;
+	case 'J':
+		if (params[0] == 0) {
+			vt100_clear(vt, vt->Row, vt->Col, VT100_COLS);
+			for (int row = vt->Row + 1; row < VT100_ROWS; row++) vt100_clear(vt, row, 0, VT100_COLS);
+		} else if (params[0] == 1) {
+			for (int row = 0; row < vt->Row; row++) vt100_clear(vt, row, 0, VT100_COLS);
+			vt100_clear(vt, vt->Row, 0, vt->Col + 1);
+		} else {
+			for (int row = 0; row < VT100_ROWS; row++) vt100_clear(vt, row, 0, VT100_COLS);
+		}
+		break;
+	case 'K':
+		if (vt->Col >= VT100_COLS) vt->Col = VT100_COLS - 1;
+		if (params[0] == 0) {
+			vt100_clear(vt, vt->Row, vt->Col, VT100_COLS);
+		} else if (params[0] == 1) {
+			vt100_clear(vt, vt->Row, 0, vt->Col + 1);
+		} else {
+			vt100_clear(vt, vt->Row, 0, VT100_COLS);
+		}
+		break;
+	case 'm':
+		vt100_sgr(vt, params, count);
+		break;
+	default:
+		vt->Unknown++;
+		break;
+	}
+	if (vt->Row < 0) vt->Row = 0;
+	if (vt->Row >= VT100_ROWS) vt->Row = VT100_ROWS - 1;
+	if (vt->Col < 0) vt->Col = 0;
+	if (vt->Col >= VT100_COLS) vt->Col = VT100_COLS - 1;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Set the attributes of the next symbols (SGR).
+* @param	vt The emulator.
+* @param	params The codes.
+* @param	count Number of the codes.
+*
+*/
+static void vt100_sgr(vt100_t *vt, const int *params, int count) {
+	for (int i = 0; i < count; i++) {
+		int code = params[i];
+		if (code == 0) {
+			vt->Pen = vt100_blank;
+		} else if (code == 1) {
+			vt->Pen.Attr |= VT100_BOLD;
+		} else if (code == 2) {
+			vt->Pen.Attr |= VT100_FADED;
+		} else if (code == 4) {
+			vt->Pen.Attr |= VT100_UNDERLINE;
+		} else if (code == 7) {
+			vt->Pen.Attr |= VT100_REVERSE;
+		} else if (code == 22) {
+			vt->Pen.Attr &= ~(VT100_BOLD | VT100_FADED);
+		} else if (code == 24) {
+			vt->Pen.Attr &= ~VT100_UNDERLINE;
+		} else if (code == 27) {
+			vt->Pen.Attr &= ~VT100_REVERSE;
+		} else if (((code >= 30) && (code <= 37)) || ((code >= 90) && (code <= 97))) {
+			vt->Pen.Foreground = code;
+		} else if (code == 39) {
+			vt->Pen.Foreground = 0;
+		} else if (((code >= 40) && (code <= 47)) || ((code >= 100) && (code <= 107))) {
+			vt->Pen.Background = code;
+		} else if (code == 49) {
+			vt->Pen.Background = 0;
+		} else {
+			vt->Unknown++;
+		}
+	}
+}
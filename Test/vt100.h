@@ -0,0 +1,97 @@
+/*
+*******************************************************************************
+@file	vt100.h
+@brief	A VT100 screen emulator for the host tests: it renders the output of the CLI and counts the bytes.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_TEST_VT100_H_
+#define CLI_TEST_VT100_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stddef.h>
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+
+
+/* Define ------------------------------------------------------------------ */
+#define VT100_ROWS                 24
+#define VT100_COLS                 80
+
+/* Attributes of the cell: SGR 1, 2, 4, 7 */
+#define VT100_BOLD                 0x01
+#define VT100_FADED                0x02
+#define VT100_UNDERLINE            0x04
+#define VT100_REVERSE              0x08
+
+/* The color of the cell is the SGR code (30..37, 90..97), 0 - default */
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	One cell of the screen
+ */
+typedef struct {
+	char Symbol;                             // The symbol, ' ' - empty
+	uint8_t Attr;                            // Attributes 'VT100_...'
+	uint8_t Foreground;                      // SGR code of the color, 0 - default
+	uint8_t Background;                      // SGR code of the color, 0 - default
+} vt100_cell_t;
+
+/*
+ * @brief	State of the emulator
+ */
+typedef struct {
+	vt100_cell_t Cells[VT100_ROWS][VT100_COLS]; // The screen
+	vt100_cell_t Pen;                        // Attributes of the next symbols
+	int Row;                                 // Cursor, from (0)
+	int Col;
+	int CursorHidden;                        // ?25l was received
+	/* Parser */
+	int State;                               // 0 - text, 1 - ESC, 2 - CSI
+	char Params[16];                         // Parameters of the CSI
+	int ParamLength;
+	/* Counters */
+	unsigned long Bytes;                     // Received bytes
+	unsigned long Sequences;                 // Escape sequences
+	unsigned long Unknown;                   // Sequences the emulator does not know
+	char Text[VT100_COLS + 1];               // Row returned by 'vt100_row'
+} vt100_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'vt100.c'. */
+/* Function instances ------------------------------------------------------ */
+void vt100_init(vt100_t *vt);
+void vt100_reset_counters(vt100_t *vt);
+void vt100_putc(vt100_t *vt, char ch);
+void vt100_write(vt100_t *vt, const void *data, size_t length);
+const char *vt100_row(vt100_t *vt, int row);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_TEST_VT100_H_ */
@@ -0,0 +1,247 @@
+/*
+*******************************************************************************
+@file	alias.c
+@brief	Aliases of the CLI: command lists tokenized and resolved once, when
+		they are defined, and replayed straight into the dispatch.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+
+#if (CLI_ENABLE_ALIASES == TRUE)
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Define the alias or change its commands.
+* @note 	The body is split into commands by ';' and into arguments by
+*       	spaces (quotes are kept together) once, here. An alias can
+*       	run other aliases; the command of the same name as the alias
+*       	is the command, not the alias itself.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Name of the alias.
+* @param	body Commands of the alias: `cmd1 args; cmd2 args`.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no place or the body is empty.
+*/
+int cli_alias_set(cli_t *cli, const char *name, const char *body) {
+	size_t length = strlen(name);
+	if (!length || (length + 1 + strlen(body) + 1 > CLI_ALIAS_SIZE) || strchr(name, Key_SPACE)) {
+		return CLI_ERROR;
+	}
+	cli_alias_t *alias = cli_alias_find(cli, name);
+	if (alias == NULL) {
+		for (int index = 0; index < CLI_ALIAS_COUNT; index++) {
+			if (cli->Aliases[index].Text[0] == 0) {
+				alias = &cli->Aliases[index];
+				break;
+			}
+		}
+	}
+	if (alias == NULL) {
+		return CLI_ERROR;
+	}
+
+	cli_alias_t temp;
+	memset(&temp, 0, sizeof(temp));
+	memcpy(temp.Text, name, length + 1);
+	char *line = &temp.Text[length + 1];
+	strcpy(line, body);
+	while (line != NULL) {
+		char *argv[CLI_ALIAS_SIZE / 2];
+		char *next;
+		int argc = cli_tokenize(line, argv, sizeof(argv) / sizeof(argv[0]), &next);
+		if (argc) {
+			if (temp.Count == CLI_ALIAS_STEPS) {
+				return CLI_ERROR;
+			}
+			cli_alias_step_t *step = &temp.Steps[temp.Count++];
+			step->Offset = argv[0] - temp.Text;
+			step->Argc = argc;
+			for (int i = 0; i < argc; i++) {
+				step->Expand |= (strchr(argv[i], '$') != NULL);
+			}
+		}
+		line = next;
+	}
+	if (!temp.Count) {
+		return CLI_ERROR;
+	}
+	*alias = temp;
+	/* The other aliases may have to find this one */
+	cli->Generation++;
+	cli_alias_resolve(cli, alias);
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the alias.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Name of the alias.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no such alias.
+*/
+int cli_alias_remove(cli_t *cli, const char *name) {
+	cli_alias_t *alias = cli_alias_find(cli, name);
+	if (alias == NULL) {
+		return CLI_ERROR;
+	}
+	memset(alias, 0, sizeof(cli_alias_t));
+	cli->Generation++;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the alias by name.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Name of the alias.
+* @return	`cli_alias_t*` The alias or NULL if not found.
+*/
+cli_alias_t *cli_alias_find(cli_t *cli, const char *name) {
+	for (int index = 0; index < CLI_ALIAS_COUNT; index++) {
+		if (cli->Aliases[index].Text[0] && !strcmp(cli->Aliases[index].Text, name)) {
+			return &cli->Aliases[index];
+		}
+	}
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the commands of the alias and keep them in its steps.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	alias The alias.
+*
+*/
+void cli_alias_resolve(cli_t *cli, cli_alias_t *alias) {
+	for (int i = 0; i < alias->Count; i++) {
+		cli_alias_step_t *step = &alias->Steps[i];
+		char *argv[CLI_ALIAS_SIZE / 2];
+		char *text = &alias->Text[step->Offset];
+		for (int j = 0; j < step->Argc; j++) {
+			argv[j] = text;
+			text += strlen(text) + 1;
+		}
+		step->Alias = 0;
+		step->Command = NULL;
+		step->Depth = 0;
+		cli_alias_t *nested = cli_alias_find(cli, argv[0]);
+		if ((nested != NULL) && (nested != alias)) {
+			step->Alias = (nested - cli->Aliases) + 1;
+		} else {
+			int depth = 0;
+			step->Command = cli_command_walk(cli, step->Argc, argv, &depth);
+			step->Depth = depth;
+		}
+	}
+	alias->Generation = cli_alias_generation(cli);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the number of changes of the commands and aliases seen by
+*       	the instance.
+* @note 	The registry of the plugins is shared by all the instances, its
+*       	changes are added to those of the instance.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`unsigned int` Number of changes.
+*/
+unsigned int cli_alias_generation(cli_t *cli) {
+#if (CLI_ENABLE_PLUGINS == TRUE)
+	return cli->Generation + cli_plugin_generation();
+#else
+	return cli->Generation;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the text inside the single quotes of the alias: the
+*       	quote itself is closed, given in double quotes and opened again.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	text The text.
+* @param	length Number of the symbols.
+*
+*/
+static void cli_alias_put(cli_t *cli, const char *text, int length) {
+	while (length > 0) {
+		int span = strcspn(text, "'");
+		span = (span < length) ? span : length;
+		cli_write(cli, text, span);
+		if (span == length) {
+			break;
+		}
+		cli_write(cli, "'\"'\"'", 5);
+		text += span + 1;
+		length -= span + 1;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the alias as it can be defined again.
+* @note 	The arguments with spaces, ';' or quotes are put in quotes
+*       	again: the double ones, or the single ones around '"'.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	alias The alias.
+*
+*/
+void cli_alias_print(cli_t *cli, const cli_alias_t *alias) {
+	cli_printf(cli, "%s='", alias->Text);
+	for (int i = 0; i < alias->Count; i++) {
+		const char *text = &alias->Text[alias->Steps[i].Offset];
+		for (int j = 0; j < alias->Steps[i].Argc; j++) {
+			if (i || j) {
+				cli_alias_put(cli, j ? " " : "; ", j ? 1 : 2);
+			}
+			if (*text && !strpbrk(text, " ;'\"")) {
+				cli_alias_put(cli, text, strlen(text));
+			} else if (strchr(text, '"') && !strchr(text, '\'')) {
+				cli_alias_put(cli, "'", 1);
+				cli_alias_put(cli, text, strlen(text));
+				cli_alias_put(cli, "'", 1);
+			} else {
+				cli_alias_put(cli, "\"", 1);
+				for (const char *part = text; *part; ) {
+					int span = strcspn(part, "\"");
+					cli_alias_put(cli, part, span);
+					part += span;
+					if (*part) {
+						cli_alias_put(cli, "\"'\"'\"", 5);
+						part++;
+					}
+				}
+				cli_alias_put(cli, "\"", 1);
+			}
+			text += strlen(text) + 1;
+		}
+	}
+	cli_printf(cli, "'");
+}
+
+#endif /* CLI_ENABLE_ALIASES */
@@ -0,0 +1,85 @@
+/*
+*******************************************************************************
+@file	alias.h
+@brief	Aliases of the CLI: command lists tokenized and resolved once, when
+		they are defined, and replayed straight into the dispatch.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_ALIAS_H_
+#define CLI_ALIAS_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdint.h>  /* For 'uint8_t' */
+
+#include "opt.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+struct cli_command;
+
+/*
+ * @brief	One command of the alias
+ */
+typedef struct {
+	const struct cli_command *Command;     // Resolved command, NULL if not found
+	uint8_t Alias;                         // Index of the nested alias + 1, 0 - a command
+	uint8_t Offset;                        // First argument in 'Text'
+	uint8_t Argc;                          // Number of the arguments
+	uint8_t Depth;                         // Arguments taken by the groups of the command
+	uint8_t Expand;                        // The arguments contain '$'
+} cli_alias_step_t;
+
+/*
+ * @brief	Alias Structure definition
+ * @note	`Text` holds the name and then the arguments of all the commands,
+ *      	each terminated by zero. The commands are found again only when
+ *      	the list of commands or aliases has been changed ('Generation').
+ */
+typedef struct {
+	char Text[CLI_ALIAS_SIZE];             // Name and arguments, empty name - free place
+	cli_alias_step_t Steps[CLI_ALIAS_STEPS]; // Commands of the alias
+	uint8_t Count;                         // Number of the commands
+	uint8_t Running;                       // The alias is running: calling it again is a loop
+	unsigned int Generation;               // Generation of the lists when the commands were found
+} cli_alias_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'alias.c'. */
+/* Function instances ------------------------------------------------------ */
+struct cli_instance;
+int cli_alias_set(struct cli_instance *cli, const char *name, const char *body);
+int cli_alias_remove(struct cli_instance *cli, const char *name);
+cli_alias_t *cli_alias_find(struct cli_instance *cli, const char *name);
+void cli_alias_resolve(struct cli_instance *cli, cli_alias_t *alias);
+unsigned int cli_alias_generation(struct cli_instance *cli);
+void cli_alias_print(struct cli_instance *cli, const cli_alias_t *alias);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_ALIAS_H_ */
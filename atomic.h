@@ -0,0 +1,63 @@
+/*
+*******************************************************************************
+@file	atomic.h
+@brief	Atomic operations used by the lock-free queues of the CLI.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_ATOMIC_H_
+#define CLI_ATOMIC_H_
+
+/*
+ * C11 atomics are used when the compiler provides them (the host build),
+ * otherwise the GCC `__atomic` builtins, which are available for all
+ * the supported MCU targets.
+ *
+ *  - `cli_atomic_load`  - load with acquire semantics.
+ *  - `cli_atomic_store` - store with release semantics.
+ *  - `cli_atomic_cas`   - compare and swap with acq_rel semantics. On failure,
+ *                         `*_expected` gets the current value.
+ *  - `cli_atomic_add`   - relaxed increment, for statistics counters.
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+typedef atomic_uint cli_atomic_t;
+#define cli_atomic_load(_p)      atomic_load_explicit((_p), memory_order_acquire)
+#define cli_atomic_store(_p, _v) atomic_store_explicit((_p), (_v), memory_order_release)
+#define cli_atomic_cas(_p, _expected, _v) \
+	atomic_compare_exchange_weak_explicit((_p), (_expected), (_v), memory_order_acq_rel, memory_order_acquire)
+#define cli_atomic_add(_p, _v)   atomic_fetch_add_explicit((_p), (_v), memory_order_relaxed)
+#else
+typedef volatile unsigned int cli_atomic_t;
+#define cli_atomic_load(_p)      __atomic_load_n((_p), __ATOMIC_ACQUIRE)
+#define cli_atomic_store(_p, _v) __atomic_store_n((_p), (_v), __ATOMIC_RELEASE)
+#define cli_atomic_cas(_p, _expected, _v) \
+	__atomic_compare_exchange_n((_p), (_expected), (_v), 1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define cli_atomic_add(_p, _v)   __atomic_fetch_add((_p), (_v), __ATOMIC_RELAXED)
+#endif
+
+#endif /* CLI_ATOMIC_H_ */
@@ -33,6 +33,9 @@ SOFTWARE.
 #include "cli.h"
 #include "io.h"
 #include "function.h"
+#if (CLI_ENABLE_WORKERS == TRUE)
+#include "worker.h"
+#endif
 
 #if CLI_USE_FULL_ASSERT == 1
 #include <assert.h>
@@ -45,24 +48,182 @@ SOFTWARE.
 #include "Function/example.h"
 #endif
 
+#if (CLI_MEMORY_ENABLE == TRUE)
+#include "Function/memory.h"
+#endif
+
+#if (CLI_TRANSFER_ENABLE == TRUE)
+#include "Function/transfer.h"
+#endif
+
 /* Instance Definition ----------------------------------------------------- */
 cli_t cli0;
 
+#if (CLI_COMPACT == TRUE)
+/* Descriptors of the commands of 'cli_add', shared by the instances: free if 'Name' is NULL */
+static cli_command_t cli_command_pool[CLI_COMMAND_POOL];
+#endif
+
+#if (CLI_INSTANCE_BUDGET > 0)
+_Static_assert(sizeof(cli_t) <= CLI_INSTANCE_BUDGET, "The instance does not fit in 'CLI_INSTANCE_BUDGET', see 'cli_sizeof_report'");
+#endif
+_Static_assert((cli_point_t)CLI_BUFFER_SIZE == CLI_BUFFER_SIZE, "'cli_point_t' is too narrow for 'CLI_BUFFER_SIZE'");
+_Static_assert((cli_history_point_t)CLI_SIZE_HISTORY == CLI_SIZE_HISTORY, "'cli_history_point_t' is too narrow for 'CLI_SIZE_HISTORY'");
+
+/* Ways to launch a command */
+enum {
+	CLI_RUN_DIRECT = 0,      // In the caller, from 'cli_exec'
+	CLI_RUN_FOREGROUND,      // From the console
+	CLI_RUN_BACKGROUND,      // From the console with '&'
+	CLI_RUN_INLINE           // From the console, more commands of the list follow
+};
+
 /* Instances of static functions ------------------------------------------- */
 
 static void cli_clear_buffer(cli_t *cli);
+static int cli_add_copy(cli_t *cli, const cli_command_t *command);
+static int cli_line_reserve(cli_t *cli, int size);
+static int cli_getchar(cli_t *cli);
+static int cli_getchar_printable(cli_t *cli, char *text, int size);
+#if (CLI_ENABLE_LOG == TRUE)
+static void cli_log_flush(cli_t *cli);
+#endif
 static int cli_utils_abs(int id);
-static void cli_print_line(cli_t *cli);
-static int cli_key_handler(cli_t *cli, char symbol);
-static int cli_key_handler_backspace(cli_t *cli);
-static int cli_key_handler_enter(cli_t *cli);
-static int cli_key_handler_tab(cli_t *cli);
-static int cli_key_handler_esc(cli_t *cli);
+static int cli_key_dispatch(cli_t *cli, int key);
+static int cli_key_sequence(cli_t *cli, char symbol);
+static int cli_key_move(cli_t *cli, int point);
+static int cli_key_erase(cli_t *cli, int from, int to);
+static int cli_key_word_left(cli_t *cli);
+static int cli_key_word_right(cli_t *cli);
+static int cli_key_handler(cli_t *cli, int key);
+static int cli_key_handler_insert(cli_t *cli, const char *text, int count);
+static int cli_key_handler_backspace(cli_t *cli, int key);
+static int cli_key_handler_delete(cli_t *cli, int key);
+static int cli_key_handler_enter(cli_t *cli, int key);
+static int cli_key_handler_tab(cli_t *cli, int key);
+static const char *cli_complete_name(cli_t *cli, const cli_command_t *group, int count, int index);
+static int cli_complete_start(cli_t *cli, cli_complete_t *complete, int start);
+static void cli_complete_level(cli_t *cli, cli_complete_t *complete, const cli_command_t *group);
+static int cli_complete_apply(cli_t *cli, const cli_complete_t *complete);
+#if (CLI_ENABLE_COMPLETION == TRUE)
+static cli_complete_t *cli_complete_make(cli_t *cli, const cli_command_t *group, const cli_command_t *command, int first, int start);
+static void cli_complete_drop(cli_t *cli);
+#endif
+static int cli_key_handler_esc(cli_t *cli, int key);
+static int cli_key_handler_up(cli_t *cli, int key);
+static int cli_key_handler_down(cli_t *cli, int key);
+static int cli_key_handler_left(cli_t *cli, int key);
+static int cli_key_handler_right(cli_t *cli, int key);
+static int cli_key_handler_home(cli_t *cli, int key);
+static int cli_key_handler_end(cli_t *cli, int key);
+static int cli_key_handler_word_left(cli_t *cli, int key);
+static int cli_key_handler_word_right(cli_t *cli, int key);
+static int cli_key_handler_kill_end(cli_t *cli, int key);
+static int cli_key_handler_kill_start(cli_t *cli, int key);
+static int cli_key_handler_kill_word_left(cli_t *cli, int key);
+static int cli_key_handler_kill_word_right(cli_t *cli, int key);
+static int cli_key_handler_cancel(cli_t *cli, int key);
+static int cli_key_handler_clear(cli_t *cli, int key);
+#if (CLI_KEY_BINDINGS > 0)
+static int cli_key_handler_command(cli_t *cli, int key);
+#endif
 static int cli_key_handler_print_element(cli_t *cli, int inc);
-static int cli_key_handler_set_point(cli_t *cli, int inc);
-static int cli_key_handler_control_delete(cli_t *cli);
 static int cli_history_add(cli_t *cli);
+static void cli_history_drop(cli_t *cli, int slot);
+#if (CLI_ENABLE_SUGGEST == TRUE)
+static int cli_history_index_find(cli_t *cli, const char *text);
+static int cli_history_suggest(cli_t *cli, const char *text, int length);
+static void cli_suggest_erase(cli_t *cli);
+static void cli_suggest_show(cli_t *cli);
+static int cli_key_handler_accept(cli_t *cli, int key);
+#endif
 static int cli_run(cli_t *cli);
+static int cli_execute(cli_t *cli, char *line, int *ret, int mode);
+static int cli_execute_command(cli_t *cli, int argc, char *argv[], int *ret, int mode);
+static int cli_dispatch(cli_t *cli, const cli_command_t *command, int argc, char *argv[], int *ret, int mode);
+#if (CLI_ENABLE_ALIASES == TRUE)
+static int cli_execute_alias(cli_t *cli, cli_alias_t *alias, int argc, char *argv[], int *ret, int mode);
+#endif
+static int cli_command_level(cli_t *cli, const cli_command_t *group);
+static const cli_command_t *cli_command_at(cli_t *cli, const cli_command_t *group, int index);
+static void cli_print_result(cli_t *cli, const char *name, int ret, int found);
+static size_t cli_scratch_rest(cli_t *cli);
+static const cli_command_t *cli_command_find(cli_t *cli, const cli_command_t *group, const char *name, size_t length);
+
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+/* The empty command of the history does not take the blocks of the pool */
+static const char cli_history_empty[1] = "";
+#endif
+
+/* Key tables -------------------------------------------------------------- */
+/*
+ * @brief	Default actions of the received bytes. The printable symbols are
+ *       	inserted, the bytes without an action are ignored.
+ */
+static const cli_key_function_t cli_keys_byte[256] = {
+	[CLI_KEY_CTRL('A')] = cli_key_handler_home,
+	[CLI_KEY_CTRL('B')] = cli_key_handler_left,
+	[CLI_KEY_CTRL('C')] = cli_key_handler_cancel,
+	[CLI_KEY_CTRL('D')] = cli_key_handler_delete,
+	[CLI_KEY_CTRL('E')] = cli_key_handler_end,
+	[CLI_KEY_CTRL('F')] = cli_key_handler_right,
+	[Key_BS]            = cli_key_handler_backspace,
+	[Key_TAB]           = cli_key_handler_tab,
+	[CLI_KEY_CTRL('K')] = cli_key_handler_kill_end,
+	[CLI_KEY_CTRL('L')] = cli_key_handler_clear,
+	[Key_CR]            = cli_key_handler_enter,
+	[CLI_KEY_CTRL('N')] = cli_key_handler_down,
+	[CLI_KEY_CTRL('P')] = cli_key_handler_up,
+	[CLI_KEY_CTRL('U')] = cli_key_handler_kill_start,
+	[CLI_KEY_CTRL('W')] = cli_key_handler_kill_word_left,
+	[Key_ESC]           = cli_key_handler_esc,
+	[0x20 ... 0x7e]     = cli_key_handler,
+	[Key_DEL]           = cli_key_handler_backspace,
+};
+
+/*
+ * @brief	Default actions of the escape sequences (`CLI_KEY_UP` and further).
+ */
+static const cli_key_function_t cli_keys_sequence[CLI_KEY_LAST - CLI_KEY_UP] = {
+	[CLI_KEY_UP - CLI_KEY_UP]         = cli_key_handler_up,
+	[CLI_KEY_DOWN - CLI_KEY_UP]       = cli_key_handler_down,
+	[CLI_KEY_RIGHT - CLI_KEY_UP]      = cli_key_handler_right,
+	[CLI_KEY_LEFT - CLI_KEY_UP]       = cli_key_handler_left,
+	[CLI_KEY_HOME - CLI_KEY_UP]       = cli_key_handler_home,
+	[CLI_KEY_END - CLI_KEY_UP]        = cli_key_handler_end,
+	[CLI_KEY_DELETE - CLI_KEY_UP]     = cli_key_handler_delete,
+	[CLI_KEY_CTRL_RIGHT - CLI_KEY_UP] = cli_key_handler_word_right,
+	[CLI_KEY_CTRL_LEFT - CLI_KEY_UP]  = cli_key_handler_word_left,
+	[CLI_KEY_ALT_B - CLI_KEY_UP]      = cli_key_handler_word_left,
+	[CLI_KEY_ALT_F - CLI_KEY_UP]      = cli_key_handler_word_right,
+	[CLI_KEY_ALT_D - CLI_KEY_UP]      = cli_key_handler_kill_word_right,
+};
+
+/*
+ * @brief	Escape sequences (without the leading ESC) and their key codes.
+ */
+static const struct {
+	const char *Sequence;
+	int Key;
+} cli_keys_escape[] = {
+	{"[A",    CLI_KEY_UP},         {"[B",    CLI_KEY_DOWN},
+	{"[C",    CLI_KEY_RIGHT},      {"[D",    CLI_KEY_LEFT},
+	{"[H",    CLI_KEY_HOME},       {"[F",    CLI_KEY_END},
+	{"OH",    CLI_KEY_HOME},       {"OF",    CLI_KEY_END},
+	{"[1~",   CLI_KEY_HOME},       {"[4~",   CLI_KEY_END},
+	{"[7~",   CLI_KEY_HOME},       {"[8~",   CLI_KEY_END},
+	{"[2~",   CLI_KEY_INSERT},     {"[3~",   CLI_KEY_DELETE},
+	{"[5~",   CLI_KEY_PAGE_UP},    {"[6~",   CLI_KEY_PAGE_DOWN},
+	{"[1;5C", CLI_KEY_CTRL_RIGHT}, {"[1;5D", CLI_KEY_CTRL_LEFT},
+	{"OP",    CLI_KEY_F1},         {"OQ",    CLI_KEY_F2},
+	{"OR",    CLI_KEY_F3},         {"OS",    CLI_KEY_F4},
+	{"[15~",  CLI_KEY_F5},         {"[17~",  CLI_KEY_F6},
+	{"[18~",  CLI_KEY_F7},         {"[19~",  CLI_KEY_F8},
+	{"[20~",  CLI_KEY_F9},         {"[21~",  CLI_KEY_F10},
+	{"[23~",  CLI_KEY_F11},        {"[24~",  CLI_KEY_F12},
+	{"b",     CLI_KEY_ALT_B},      {"f",     CLI_KEY_ALT_F},
+	{"d",     CLI_KEY_ALT_D},
+};
 
 /*---------------------------------------------------------------------------*/
 /**
@@ -79,16 +240,88 @@ int cli_init(cli_t *cli) {
 	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
 	cli_error_t status = CLI_OK;
 	memset(cli, 0, sizeof(cli_t));
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	cli->Buffer = cli->Inline;
+	cli->BufferSize = sizeof(cli->Inline);
+	for (int i = 0; i < CLI_SIZE_HISTORY; i++) {
+		cli->History[i].Command = (char*)cli_history_empty;
+	}
+#endif
 	cli->_io_getchar = __io_cli_getchar;
 	cli->_io_putchar = __io_cli_putchar;
+	cli->_io_wait = __io_cli_wait;
+	cli->_io_wakeup = __io_cli_wakeup;
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+	cli->RxLeft = -1;
+	cli->TxLeft = -1;
+#endif
+#if (CLI_USE_RING_BUFFER == TRUE)
+	cli->_io_txstart = __io_cli_txstart;
+	cli_ring_init(&cli->Rx, cli->RxData, sizeof(cli->RxData));
+	cli_ring_init(&cli->Tx, cli->TxData, sizeof(cli->TxData));
+#endif
+#if (CLI_ENABLE_LOG == TRUE)
+	cli_log_init(&cli->Log);
+#endif
+#if (CLI_ENABLE_VARIABLES == TRUE)
+	cli_variables_init(&cli->Variables);
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+	cli_trace_init(&cli->Trace);
+#endif
+	if (__io_cli_start != NULL) {
+		__io_cli_start();
+	}
 
 	/* Add default commands */
-	status |= cli_add(cli, "help", cli_function_help, "Displays reference information about commands");
-	status |= cli_add(cli, "clear", cli_function_clear, "Clear terminal");
+	status |= CLI_COMPLETE_DEFINE(cli, "help", cli_function_help, "Displays reference information about commands", cli_complete_commands);
+	status |= CLI_COMMAND_DEFINE(cli, "clear", cli_function_clear, "Clear terminal");
+#if (CLI_ENABLE_WORKERS == TRUE)
+	status |= CLI_COMMAND_DEFINE(cli, "jobs", cli_function_jobs, "Print the jobs running in the background");
+	status |= CLI_COMMAND_DEFINE(cli, "wait", cli_function_wait, "Wait for the background jobs");
+#endif
+#if (CLI_ENABLE_PLUGINS == TRUE)
+#if (CLI_COMPLETION_FILES == TRUE)
+	status |= CLI_COMPLETE_DEFINE(cli, "load", cli_function_load, "Load the commands of the plugin: load [PATH]", cli_complete_files);
+#else
+	status |= CLI_COMMAND_DEFINE(cli, "load", cli_function_load, "Load the commands of the plugin: load [PATH]");
+#endif
+	status |= CLI_COMMAND_DEFINE(cli, "unload", cli_function_unload, "Unload the plugin: unload NAME");
+#endif
+#if (CLI_ENABLE_ALIASES == TRUE)
+	status |= CLI_COMMAND_DEFINE(cli, "alias", cli_function_alias, "Define the alias: alias NAME='CMD1; CMD2'");
+	status |= CLI_COMPLETE_DEFINE(cli, "unalias", cli_function_unalias, "Remove the alias: unalias NAME", cli_complete_unalias);
+#endif
+#if (CLI_ENABLE_VARIABLES == TRUE)
+	status |= CLI_COMMAND_DEFINE(cli, "set", cli_function_set, "Set the variable: set NAME VALUE");
+	status |= CLI_COMMAND_DEFINE(cli, "unset", cli_function_unset, "Remove the variable: unset NAME");
+	status |= CLI_COMMAND_DEFINE(cli, "env", cli_function_env, "Print the variables");
+#endif
+#if (CLI_ENABLE_EMIT == TRUE)
+	status |= CLI_COMPLETE_DEFINE(cli, "format", cli_function_format, "Output format of the commands: format text|json|cbor", cli_complete_format);
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+	status |= CLI_COMMAND_DEFINE(cli, "stats", cli_function_stats, "Traffic of the terminal: stats [clear]");
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	status |= CLI_COMPLETE_DEFINE(cli, "more", cli_function_more, "Page the long output: more [on|off]", cli_complete_more);
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+	status |= CLI_COMMAND_DEFINE(cli, "watch", cli_function_watch, "Run the command on the live screen: watch [-n MS] COMMAND");
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+	status |= CLI_COMMAND_DEFINE(cli, "trace", cli_function_trace, "Trace of the input and output: trace [on|off|clear|latency]");
+#endif
 
 #if (CLI_EXAMPLE_ENABLE == TRUE)
 	cli_example_init(cli);
 #endif
+#if (CLI_MEMORY_ENABLE == TRUE)
+	cli_memory_init(cli);
+#endif
+#if (CLI_TRANSFER_ENABLE == TRUE)
+	cli_transfer_init(cli);
+#endif
 
 	if (status != CLI_ERROR) {
 		status = CLI_OK;
@@ -101,6 +334,26 @@ int cli_init(cli_t *cli) {
 	return status;
 }
 
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Format the text into the buffer.
+* @note 	Newlib has the integer-only `vsniprintf`, which keeps the
+*       	floating point out of the image; the other libraries use
+*       	`vsnprintf`.
+* @param	buffer Buffer of the text.
+* @param	size Size of the buffer.
+* @param	format Format string.
+* @param	args Arguments of the format.
+* @return	`int` Length of the whole text, as `vsnprintf`.
+*/
+int cli_vsnprintf(char *buffer, size_t size, const char *format, va_list args) {
+#ifdef __NEWLIB__
+	return vsniprintf(buffer, size, format, args);
+#else
+	return vsnprintf(buffer, size, format, args);
+#endif
+}
+
 /*---------------------------------------------------------------------------*/
 /**
 * @brief	Console Output Function.
@@ -114,392 +367,2403 @@ int cli_printf(cli_t *cli, const char* format, ...) {
 	va_list args;
 	va_start(args, format);
 	char temp[BUFSIZ];
-	int nchar = vsniprintf(temp, sizeof(temp), format, args);
+	int nchar = cli_vsnprintf(temp, sizeof(temp), format, args);
 	va_end(args);
 
 	if (nchar < 0) return CLI_ERROR;
-	for (int i = 0; i < nchar; i++) {
-		cli->_io_putchar(temp[i]);
-	}
-	return nchar;
-}
-
-/*---------------------------------------------------------------------------*/
-/**
-* @brief	Display a welcome message in the console.
-* @note 	Can be overridden.
-* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-*
-*/
-int __cli_print_hello(cli_t *cli) {
-	return cli_printf(cli, "%s\rCommand Line Interpreter initialized\r\n", CONSOLE_CLEAR_STRING);
+	if (nchar > (int)sizeof(temp) - 1) nchar = sizeof(temp) - 1;
+	return cli_write(cli, temp, nchar);
 }
 
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Function of adding a command to the CLI.
+* @brief	Raw console output function. All the CLI output passes through it.
+* @note 	While `cli_exec` is running, the output goes to the capture
+*       	buffer (or sink) of the caller instead of the terminal.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-* @param	name Function name.
-* @param	function Pointer on Function.
-* @param	help Minimal description of the function.
-* @return	`int` The number of the command in the list.
-* @retval 	`int` (>0) if success.
-* @retval   `CLI_ERROR` (!0) if error.
-*
+* @param	data Data to be sent.
+* @param	length Number of bytes to send.
+* @return	`int` Number of characters sent.
 */
-int cli_add(cli_t *cli, const char *name, int (*function)(cli_t *cli, int argc, char* argv[]), const char *help) {
-	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
-	assert_cli(name != NULL && "Name function text is incorrect!\n");
-	assert_cli(function != NULL && "Pointer to function is incorrect!\n");
-	assert_cli(help != NULL && "Help text is incorrect!\n");
-	int index = 0;
-	for (index = 0; index < CLI_MAX_COUNT_COMMAND; index++) {
-		if (cli->Commands[index].Function == NULL) {
-			cli->Commands[index].Name = name;
-			cli->Commands[index].Function = function;
-			cli->Commands[index].Help = help;
-			return index;
+int cli_write(cli_t *cli, const char *data, int length) {
+#if (CLI_ENABLE_WORKERS == TRUE)
+	if (cli_worker_write(cli, data, length) >= 0) {
+		return length;
+	}
+#endif
+	cli_capture_t *capture = cli->Capture;
+	if (capture != NULL) {
+		if (capture->Sink != NULL) {
+			return capture->Sink(capture->Context, data, length);
 		}
+		for (int i = 0; i < length; i++) {
+			/* Leave a place for the terminating zero */
+			if (capture->Length + 1 >= capture->Size) break;
+			capture->Data[capture->Length++] = data[i];
+		}
+		return length;
 	}
-	cli_printf(cli, "Failed to add a function. Buffer is overcrowded. Change the value of CLI_MAX_COUNT_COMMAND in the 'opt.h' file.");
-	return CLI_ERROR;
+#if (CLI_ENABLE_TRACE == TRUE)
+	cli_trace_bytes(&cli->Trace, CLI_TRACE_TX, data, length);
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+	cli->Stats.TxBytes += length;
+	/* Each sequence starts with ESC */
+	for (const char *escape = data; (escape = memchr(escape, Key_ESC, data + length - escape)) != NULL; escape++) {
+		cli->Stats.TxSequences++;
+	}
+#endif
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+	if (cli->TxLeft > 0) {
+		cli->TxLeft = (length < cli->TxLeft) ? cli->TxLeft - length : 0;
+	}
+#endif
+#if (CLI_USE_RING_BUFFER == TRUE)
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	if (cli->Discard) {
+		cli->TxDropped += length;
+		return length;
+	}
+#endif
+	int sent = 0;
+	while (1) {
+		sent += cli_ring_write(&cli->Tx, (const uint8_t*)&data[sent], length - sent);
+		cli_tx_kick(cli);
+		if (sent >= length) break;
+		/* Wait until the interrupt frees up space */
+		cli->TxStalled++;
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+		if (cli_flow_wait(cli) != CLI_OK) {
+			cli->TxDropped += length - sent;
+			break;
+		}
+#else
+		while (!cli_ring_space(&cli->Tx));
+#endif
+	}
+#else
+	for (int i = 0; i < length; i++) {
+		cli->_io_putchar(data[i]);
+	}
+#endif
+	return length;
 }
 
-#if (CLI_ENABLE_DELETE_COMMAND == TRUE)
+#if (CLI_USE_RING_BUFFER == TRUE)
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Remove a command from the list.
+* @brief	Put the received bytes in the receive ring.
+* @note 	Called from the UART receive interrupt (or DMA) only.
+*       	Does not block: the bytes that do not fit are dropped and
+*       	counted in `RxDropped`.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-* @param	index Command index.
-* @retval 	`CLI_OK` (0) if success.
-* @retval   `CLI_ERROR` (!0) if error.
-*
+* @param	data Received bytes.
+* @param	length Number of bytes.
+* @return	`int` Number of bytes accepted.
 */
-int cli_remove_id(cli_t *cli, int index) {
-	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
-	if (cli->Commands[index].Name != NULL) {
-		cli->Commands[index].Name = NULL;
-		cli->Commands[index].Function = NULL;
-		cli->Commands[index].Help = NULL;
-		return CLI_OK;
+int cli_rx_push(cli_t *cli, const uint8_t *data, int length) {
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	int accepted = cli_flow_rx(cli, data, length);
+#else
+	int accepted = cli_ring_write(&cli->Rx, data, length);
+#endif
+	cli->RxDropped += length - accepted;
+	if (accepted && (cli->_io_wakeup != NULL)) {
+		cli->_io_wakeup();
 	}
-	return CLI_ERROR;
+	return accepted;
 }
+
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Remove a command from the list.
+* @brief	Take the bytes for transmission from the transmit ring.
+* @note 	Called from the UART transmit interrupt (or DMA) only.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-* @param	name Command name.
-* @retval 	`CLI_OK` (0) if success.
-* @retval   `CLI_ERROR` (!0) if error.
+* @param	data Buffer for the bytes.
+* @param	length Size of the buffer.
+* @return	`int` Number of bytes taken. If (0), the transmission can be
+*       	stopped until the next `__io_cli_txstart`.
 */
-int cli_remove_name(cli_t *cli, const char* name) {
-	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
-	for (int index = 0; index < CLI_MAX_COUNT_COMMAND; index++) {
-		size_t length = strlen(cli->Commands[index].Name);
-		if (!memcmp(cli->Commands[index].Name, name, length)) {
-			return cli_remove_id(cli, index);
-		}
-	}
-	return CLI_ERROR;
+int cli_tx_pop(cli_t *cli, uint8_t *data, int length) {
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	return cli_flow_pop(cli, data, length);
+#else
+	return cli_ring_read(&cli->Tx, data, length);
+#endif
 }
 
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Remove a command from the list.
+* @brief	Start the transmission of the transmit ring. Without the
+*       	interrupt, send from the ring ourselves.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-* @param	function Pointer on Function.
-* @retval 	`CLI_OK` (0) if success.
-* @retval   `CLI_ERROR` (!0) if error.
 */
-int cli_remove_ptr(cli_t *cli, int (*function)(cli_t *cli, int argc, char* argv[])) {
-	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
-	for (int index = 0; index < CLI_MAX_COUNT_COMMAND; index++) {
-		if (cli->Commands[index].Function == function) {
-			return cli_remove_id(cli, index);
+void cli_tx_kick(cli_t *cli) {
+	if (cli->_io_txstart != NULL) {
+		cli->_io_txstart();
+		return;
+	}
+	uint8_t block[16];
+	int count;
+	while ((count = cli_tx_pop(cli, block, sizeof(block))) > 0) {
+		for (int i = 0; i < count; i++) {
+			cli->_io_putchar(block[i]);
 		}
 	}
-	return CLI_ERROR;
 }
 #endif
+
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Command to clear the contents of the buffer.
+* @brief	Read the received bytes directly, bypassing the line editor.
+* @note 	For the commands that take over the link (file transfer).
+*       	Without `CLI_USE_RING_BUFFER` the byte (0) cannot be received.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-*
+* @param	data Buffer for the bytes.
+* @param	length Size of the buffer.
+* @return	`int` Number of bytes read, (0) if there is no data.
 */
-static void cli_clear_buffer(cli_t *cli) {
-	memset(cli->Buffer, 0, sizeof(cli->Buffer));
-	cli->Point = 0;
+int cli_read(cli_t *cli, uint8_t *data, int length) {
+#if (CLI_USE_RING_BUFFER == TRUE)
+	int count = cli_ring_read(&cli->Rx, data, length);
+#else
+	int count = 0;
+	if (cli->Pending && length) {
+		data[count++] = cli->Pending;
+		cli->Pending = 0;
+	}
+	while (count < length) {
+		int ch = cli->_io_getchar();
+		if (!ch) break;
+		data[count++] = ch;
+	}
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+	cli_trace_bytes(&cli->Trace, CLI_TRACE_RX, data, count);
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+	cli->Stats.RxBytes += count;
+#endif
+	return count;
 }
 
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Print the prefix and buffer content to the console.
+* @brief	Reads the next character for the CLI.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-*
+* @return	`int` The character or (0) if there is no data.
 */
-static void cli_print_line(cli_t *cli) {
-	cli_printf(cli, "\r%s%s%s", CONSOLE_CLEAR_STRING, CLI_PREFIX, cli->Buffer);
-	for (int i = 0; i < strlen(cli->Buffer) - cli->Point; i++) {
-		/* Print '\033[D' */
-		cli_printf(cli, "%c%c%c", Key_ESC, Key_CONTROL, Key_D);
+static int cli_getchar(cli_t *cli) {
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+	if (cli->RxLeft == 0) {
+		/* The rest waits for the next turn */
+		return 0;
+	}
+#endif
+#if (CLI_USE_RING_BUFFER == TRUE)
+	uint8_t ch = 0;
+	cli_ring_read(&cli->Rx, &ch, 1);
+#else
+	int ch = cli->Pending;
+	if (ch) {
+		cli->Pending = 0;
+	} else {
+		ch = cli->_io_getchar();
+	}
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+	if (ch) {
+		cli_trace_event(&cli->Trace, CLI_TRACE_RX, (uint8_t)ch);
+	}
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+	cli->Stats.RxBytes += (ch != 0);
+#endif
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+	if (ch && (cli->RxLeft > 0)) {
+		cli->RxLeft--;
 	}
+#endif
+	return ch;
 }
 
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	The main handler of the Command Line Interpreter.
+* @brief	Take the printable symbols that have already been received.
+* @note 	Stops at the first control symbol, which stays for the next
+*       	`cli_getchar`.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-*
+* @param	text Buffer for the symbols.
+* @param	size Size of the buffer.
+* @return	`int` Number of symbols.
 */
-int cli_handler(cli_t *cli) {
-	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
-	/* Basic Key Handler */
-	char symbol = (char)cli->_io_getchar();
-	switch (symbol) {
-		case 0:
+static int cli_getchar_printable(cli_t *cli, char *text, int size) {
+	int count = 0;
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+	if ((cli->RxLeft >= 0) && (size > cli->RxLeft)) {
+		size = cli->RxLeft;
+	}
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	if ((cli->Page == CLI_PAGE_WAIT) && (size > (int)cli->PageAhead)) {
+		/* The keys after the typed ahead ones go to the pager */
+		size = cli->PageAhead;
+	}
+#endif
+#if (CLI_USE_RING_BUFFER == TRUE)
+	/* Two passes: the received data may wrap around the end of the ring */
+	for (int pass = 0; pass < 2; pass++) {
+		const uint8_t *data;
+		int length = cli_ring_linear(&cli->Rx, &data);
+		int taken = 0;
+		while ((count < size) && (taken < length) && (data[taken] >= 0x20) && (data[taken] <= 0x7e)) {
+			text[count++] = data[taken++];
+		}
+		cli_ring_skip(&cli->Rx, taken);
+		if (taken < length) break;
+	}
+#else
+	while ((count < size) && !cli->Pending) {
+		int ch = cli->_io_getchar();
+		if (!ch) break;
+		if ((ch < 0x20) || (ch > 0x7e)) {
+			/* Traced when it is taken by 'cli_getchar' */
+			cli->Pending = ch;
 			break;
-		case Key_CR:
-			return cli_key_handler_enter(cli);
-		case Key_DEL:
-		case Key_BS:
-			return cli_key_handler_backspace(cli);
-		case Key_TAB:
-			return cli_key_handler_tab(cli);
-		case Key_ESC:
-			return cli_key_handler_esc(cli);
-		default:
-			return cli_key_handler(cli, symbol);
+		}
+		text[count++] = ch;
 	}
-	return CLI_OK;
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+	cli_trace_bytes(&cli->Trace, CLI_TRACE_RX, text, count);
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+	cli->Stats.RxBytes += count;
+#endif
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+	if (cli->RxLeft > 0) {
+		cli->RxLeft -= count;
+	}
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	if (cli->Page == CLI_PAGE_WAIT) {
+		cli->PageAhead -= count;
+	}
+#endif
+	return count;
 }
 
+#if (CLI_ENABLE_LOG == TRUE)
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Handler for basic information keys.
+* @brief	Asynchronous console output, safe to call from any task.
+* @note 	The record is only put in the queue. It is printed by
+*       	`cli_handler` above the line being edited, with "\r\n" added.
+*       	Never blocks: see `CLI_LOG_OVERWRITE` for a full queue.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-* @param	symbol The character to be processed.
-*
+* @param	format Format string.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the record was dropped.
 */
-static int cli_key_handler(cli_t *cli, char symbol) {
-	if ((symbol >= 0x20) & (symbol <= 0x7e)) {
-		if (cli->Buffer[cli->Point]) {
-			for (int i = strlen(cli->Buffer); i > cli->Point; i--) {
-				cli->Buffer[i] = cli->Buffer[i-1];
-			}
-		}
-		if (cli->Point >= CLI_BUFFER_SIZE - 1) {
-			cli_printf(cli, "\r%sThe buffer is full.\r\n", CONSOLE_CLEAR_STRING);
-		} else{
-			cli->Buffer[cli->Point++] = symbol;
-		}
-		cli_print_line(cli);
+int cli_log(cli_t *cli, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	int status = cli_log_post(&cli->Log, format, args);
+	va_end(args);
+	if ((status == CLI_OK) && (cli->_io_wakeup != NULL)) {
+		cli->_io_wakeup();
 	}
-	return CLI_OK;
+	return status;
 }
 
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	The handler removes the character on the left.
+* @brief	Print the queued log records. The line being edited is erased
+*       	and then drawn again with the cursor in place.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
 *
 */
-static int cli_key_handler_backspace(cli_t *cli) {
-	if (cli->Point) {
-		(cli->Point)--;
-		for (int i = cli->Point; i < strlen(cli->Buffer); i++) {
-			cli->Buffer[i] = cli->Buffer[i + 1];
-		}
+static void cli_log_flush(cli_t *cli) {
+	unsigned int position;
+	cli_log_record_t *record = cli_log_claim(&cli->Log, &position);
+	unsigned int lost = cli_atomic_load(&cli->Log.Dropped) + cli_atomic_load(&cli->Log.Overwritten);
+	if ((record == NULL) && (lost == cli->Log.Reported)) return;
+
+	cli_printf(cli, "\r%s", CONSOLE_CLEAR_STRING);
+	if (lost != cli->Log.Reported) {
+		cli_printf(cli, "[%u log records lost]\r\n", lost - cli->Log.Reported);
+		cli->Log.Reported = lost;
+	}
+	/* No more than the queue size at a time, so that the producers cannot hold the CLI */
+	int count = 0;
+	while (record != NULL) {
+		cli_write(cli, record->Text, strlen(record->Text));
+		cli_write(cli, "\r\n", 2);
+		cli_log_release(&cli->Log, record, position);
+		if (++count >= CLI_LOG_QUEUE_SIZE) break;
+		record = cli_log_claim(&cli->Log, &position);
 	}
 	cli_print_line(cli);
-	return CLI_OK;
 }
+#endif
 
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Function for processing the Enter key.
+* @brief	Display a welcome message in the console.
+* @note 	Can be overridden.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
 *
 */
-static int cli_key_handler_enter(cli_t *cli) {
-	cli_error_t res = CLI_OK;
-	if (cli->Point) {
-		res = cli_run(cli);
-	} else {
-		cli->_io_putchar((int)Key_VT);
-	}
-	cli_print_line(cli);
-	return res;
+int __cli_print_hello(cli_t *cli) {
+	return cli_printf(cli, "%s\rCommand Line Interpreter initialized\r\n", CONSOLE_CLEAR_STRING);
 }
 
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Function to handle the launch of commands from the console.
+* @brief	Add the command described by the program.
+* @note 	With `CLI_COMPACT` the descriptor is not copied: it must live as
+*       	long as the command, best in the constant data.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-*
+* @param	command The command or group (`Children`).
+* @return	`int` The number of the command in the list.
+* @retval   `CLI_ERROR` (!0) if error.
 */
-static int cli_run(cli_t *cli) {
-	/* Delete 'Key_Space' at the end of the command */
-	while (cli->Buffer[cli->Point - 1] == Key_SPACE) {
-		cli_key_handler_backspace(cli);
-	}
-	cli_printf(cli, "\r\n");
-	/* Add list command running */
-	cli_history_add(cli);
-	/* Search function */
+int cli_add_command(cli_t *cli, const cli_command_t *command) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	assert_cli(command != NULL && command->Name != NULL && "Command is incorrect!\n");
+	assert_cli(command->Help != NULL && "Help text is incorrect!\n");
 	for (int index = 0; index < CLI_MAX_COUNT_COMMAND; index++) {
-		/* Find command */
-		if (cli->Commands[index].Function == NULL) continue;
-		size_t length = strlen(cli->Commands[index].Name);
-		if (!memcmp(cli->Commands[index].Name, cli->Buffer, length)) {
-			if ((cli->Buffer[length] != 0) && (cli->Buffer[length] != ' ')) {
-				continue;
-			}
-
-			int argc = 1;
-			/* Find count arguments */
-			int len = strlen(cli->Buffer);
-			for (int i = 0; i < len; i++) {
-				if (cli->Buffer[i] == Key_SPACE) {
-					argc++;
-				}
-			}
-			/* Find arguments */
-			char *argv[argc];
-			int inc = 0;
-			argv[inc++] = cli->Buffer;
-			for (int i = 0; i < len; i++) {
-				if (cli->Buffer[i] == Key_SPACE) {
-					cli->Buffer[i] = 0;
-					argv[inc++] = &(cli->Buffer[i + 1]);
-				}
-			}
-			/* Run command */
-			int ret = cli->Commands[index].Function(cli, argc, argv);
-			/* If command return error */
-			if (ret) {
-				cli_printf(cli, "Function '%s' return %d [0x%.8x]\r\n",
-						cli->Commands[index].Name,
-						ret,
-						ret);
-			}
-			goto label_exit_cmd;
+		if (cli_command_at(cli, NULL, index) == NULL) {
+#if (CLI_COMPACT == TRUE)
+			cli->Commands[index] = command;
+#else
+			cli->Commands[index] = *command;
+#endif
+#if (CLI_ENABLE_ALIASES == TRUE)
+			cli->Generation++;
+#endif
+			return index;
 		}
 	}
-	cli_printf(cli, "Command '%s' not found\r\n", cli->Buffer);
-label_exit_cmd:
-	cli_clear_buffer(cli);
-	cli_printf(cli, "\r%s\r", CONSOLE_CLEAR_STRING);
-	return 0;
+	cli_printf(cli, "Failed to add a command. Buffer is overcrowded. Change the value of CLI_MAX_COUNT_COMMAND in the 'opt.h' file.");
+	return CLI_ERROR;
 }
 
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Function for processing the Tab key.
+* @brief	Add the command described by the arguments of `cli_add`.
+* @note 	With `CLI_COMPACT` the descriptor takes a place in the pool
+*       	shared by the instances, `cli_remove_id` gives it back.
 * @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-*
+* @param	command The command, a temporary copy.
+* @return	`int` The number of the command in the list.
+* @retval   `CLI_ERROR` (!0) if error.
 */
-static int cli_key_handler_tab(cli_t *cli) {
-	/* Number of clear matches */
-	int countmatch = 0;
-	/* We are looking for the number of "clear" matches */
-	for (int i = 0; i < CLI_MAX_COUNT_COMMAND; i++) {
-		if ((!memcmp(cli->Commands[i].Name, cli->Buffer, cli->Point)) && (cli->Commands[i].Function != NULL)) {
-			countmatch++;
-		}
-	}
-	/* If there are no matches, exit */
-	if (countmatch == 0) return CLI_OK;
-
-	/* Number of matches with character completion */
-	int match = 0;
-	/* We do it as long as there are matches */
-	do {
-		match = 0;
-		for (int i = 0; i < CLI_MAX_COUNT_COMMAND; i++) {
-			if (cli->Commands[i].Function == NULL) continue;
-			if (!(memcmp(cli->Commands[i].Name, cli->Buffer, cli->Point))) {
-				if (!match) {
-					/* If there is nothing to add */
-					if (cli->Commands[i].Name[cli->Point] == 0) {
-						break;
-					}
-					/* Add symbol */
-					cli->Buffer[cli->Point] = cli->Commands[i].Name[cli->Point];
-					cli->Point++;
-				}
-				match++;
-			}
-		}
-	} while (countmatch == match);
-
-	/* If there is more than one command, then write all possible commands */
-	if (countmatch != 1) {
-		/* Send Enter for a pleasant look */
-		cli_printf(cli, "\r\n");
-		if ((cli->Point)--) {
-			cli->Buffer[cli->Point] = 0;
-		}
-		for (int i = 0; i < CLI_MAX_COUNT_COMMAND; i++) {
-			if (!memcmp(cli->Commands[i].Name, cli->Buffer, cli->Point)) {
-				/* Write all commands */
-				cli_printf(cli, "   %s", cli->Commands[i].Name);
+static int cli_add_copy(cli_t *cli, const cli_command_t *command) {
+#if (CLI_COMPACT == TRUE)
+	for (int slot = 0; slot < CLI_COMMAND_POOL; slot++) {
+		if (cli_command_pool[slot].Name == NULL) {
+			cli_command_pool[slot] = *command;
+			int index = cli_add_command(cli, &cli_command_pool[slot]);
+			/* 'CLI_ERROR' is also a number of the command */
+			if ((index < 0) || (index >= CLI_MAX_COUNT_COMMAND) || (cli->Commands[index] != &cli_command_pool[slot])) {
+				cli_command_pool[slot].Name = NULL;
 			}
+			return index;
 		}
-		/* Send Enter for a pleasant look */
-		cli_printf(cli, "\r\n");
-	} else {
-		cli->Buffer[(cli->Point)++] = ' ';
 	}
-	/* Command output */
-	cli_printf(cli, "\r%s%s", CLI_PREFIX, cli->Buffer);
-	return CLI_OK;
-}
-
+	cli_printf(cli, "Failed to add a command. The pool is full. Change the value of CLI_COMMAND_POOL in the 'opt.h' file.");
+	return CLI_ERROR;
+#else
+	return cli_add_command(cli, command);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Function of adding a command to the CLI.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Function name.
+* @param	function Pointer on Function.
+* @param	help Minimal description of the function.
+* @return	`int` The number of the command in the list.
+* @retval 	`int` (>0) if success.
+* @retval   `CLI_ERROR` (!0) if error.
+*
+*/
+int cli_add(cli_t *cli, const char *name, int (*function)(cli_t *cli, int argc, char* argv[]), const char *help) {
+	assert_cli(function != NULL && "Pointer to function is incorrect!\n");
+	const cli_command_t command = {name, function, help};
+	return cli_add_copy(cli, &command);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add a group of commands: `name subcommand arguments`.
+* @note 	The subcommands are a table ended by the command with `Name`
+*       	equal to NULL. Any of them can be a group with its own
+*       	`Children`. The table is not copied.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Name of the group.
+* @param	children Table of the subcommands.
+* @param	help Help information.
+* @return	`int` Index in the list of commands.
+* @retval   `CLI_ERROR` (!0) if error.
+*/
+int cli_add_group(cli_t *cli, const char *name, const cli_command_t *children, const char *help) {
+	assert_cli(children != NULL && "Subcommands are incorrect!\n");
+	const cli_command_t command = {name, NULL, help, 0, children};
+	return cli_add_copy(cli, &command);
+}
+
+#if (CLI_ENABLE_COMPLETION == TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add a command with the completion of its arguments.
+* @note 	On Tab after the name of the command, `complete` is called with
+*       	the words typed so far and gives the candidates with
+*       	`cli_complete_add`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Function name.
+* @param	function Pointer on Function.
+* @param	help Minimal description of the function.
+* @param	complete Completion function of the arguments.
+* @return	`int` Index in the list of commands.
+* @retval   `CLI_ERROR` (!0) if error.
+*/
+int cli_add_complete(cli_t *cli, const char *name, int (*function)(cli_t *cli, int argc, char* argv[]), const char *help, cli_complete_function_t complete) {
+	assert_cli(function != NULL && "Pointer to function is incorrect!\n");
+	const cli_command_t command = {name, function, help, 0, NULL, complete};
+	return cli_add_copy(cli, &command);
+}
+#endif
+
+#if (CLI_ENABLE_DELETE_COMMAND == TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove a command from the list.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	index Command index.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if error.
+*
+*/
+int cli_remove_id(cli_t *cli, int index) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	if (cli_command_at(cli, NULL, index) != NULL) {
+#if (CLI_COMPACT == TRUE)
+		/* The descriptor of 'cli_add' goes back to the pool */
+		for (int slot = 0; slot < CLI_COMMAND_POOL; slot++) {
+			if (cli->Commands[index] == &cli_command_pool[slot]) {
+				cli_command_pool[slot].Name = NULL;
+			}
+		}
+#endif
+		memset(&cli->Commands[index], 0, sizeof(cli->Commands[index]));
+#if (CLI_ENABLE_ALIASES == TRUE)
+		cli->Generation++;
+#endif
+		return CLI_OK;
+	}
+	return CLI_ERROR;
+}
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove a command from the list.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Command name.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if error.
+*/
+int cli_remove_name(cli_t *cli, const char* name) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	for (int index = 0; index < CLI_MAX_COUNT_COMMAND; index++) {
+		const cli_command_t *command = cli_command_at(cli, NULL, index);
+		if ((command != NULL) && !strcmp(command->Name, name)) {
+			return cli_remove_id(cli, index);
+		}
+	}
+	return CLI_ERROR;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove a command from the list.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	function Pointer on Function.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if error.
+*/
+int cli_remove_ptr(cli_t *cli, int (*function)(cli_t *cli, int argc, char* argv[])) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	for (int index = 0; index < CLI_MAX_COUNT_COMMAND; index++) {
+		const cli_command_t *command = cli_command_at(cli, NULL, index);
+		if ((command != NULL) && (command->Function == function)) {
+			return cli_remove_id(cli, index);
+		}
+	}
+	return CLI_ERROR;
+}
+#endif
+#if (CLI_ENABLE_VARIABLES == TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Set the session variable, which is put in the command line
+*       	instead of `$NAME` or `${NAME}`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Name of the variable: letters, digits and '_'.
+* @param	value Value of the variable.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the name is incorrect or there is no place.
+*/
+int cli_setenv(cli_t *cli, const char *name, const char *value) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	return cli_variables_set(&cli->Variables, name, value);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the session variable.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Name of the variable.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no such variable.
+*/
+int cli_unsetenv(cli_t *cli, const char *name) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	return cli_variables_unset(&cli->Variables, name);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the value of the session variable.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Name of the variable.
+* @return	`const char*` The value or NULL if there is no such variable.
+*       	It is valid until the next change of the variables.
+*/
+const char *cli_getenv(cli_t *cli, const char *name) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	return cli_variables_get(&cli->Variables, name, strlen(name));
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Command to clear the contents of the buffer.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+static void cli_clear_buffer(cli_t *cli) {
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	if (cli->Buffer != cli->Inline) {
+		/* The long line is done: the blocks go back to the pool */
+		cli_pool_free(cli->Buffer, cli->BufferSize);
+		cli->Buffer = cli->Inline;
+		cli->BufferSize = sizeof(cli->Inline);
+	}
+	memset(cli->Buffer, 0, cli->BufferSize);
+#else
+	memset(cli->Buffer, 0, sizeof(cli->Buffer));
+#endif
+	cli->Point = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Make the receive buffer big enough for the line.
+* @note 	With `CLI_ENABLE_LINE_POOL` the line is moved to the blocks of
+*       	the pool, up to `CLI_BUFFER_SIZE`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	size Needed size with the terminating zero.
+* @return	`int` Size of the buffer, can be less than needed.
+*/
+static int cli_line_reserve(cli_t *cli, int size) {
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	if (size <= cli->BufferSize) {
+		return cli->BufferSize;
+	}
+	/* Doubled, so a long paste is not copied on every block */
+	if (size < cli->BufferSize * 2) {
+		size = cli->BufferSize * 2;
+	}
+	if (size > CLI_BUFFER_SIZE) {
+		size = CLI_BUFFER_SIZE;
+	}
+	char *buffer = cli_pool_alloc(size);
+	if (buffer == NULL) {
+		return cli->BufferSize;
+	}
+	/* The whole blocks, but not more than the longest line */
+	size = cli_pool_capacity(size);
+	if (size > CLI_BUFFER_SIZE) {
+		size = CLI_BUFFER_SIZE;
+	}
+	memcpy(buffer, cli->Buffer, cli->BufferSize);
+	memset(&buffer[cli->BufferSize], 0, size - cli->BufferSize);
+	if (cli->Buffer != cli->Inline) {
+		cli_pool_free(cli->Buffer, cli->BufferSize);
+	}
+	cli->Buffer = buffer;
+	cli->BufferSize = size;
+	return size;
+#else
+	return CLI_BUFFER_SIZE;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the prefix and buffer content to the console.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+void cli_print_line(cli_t *cli) {
+	cli_printf(cli, "\r%s%s%s", CONSOLE_CLEAR_STRING, CLI_PREFIX, cli->Buffer);
+	int tail = strlen(cli->Buffer) - cli->Point;
+	if (tail) {
+		/* Print '\033[<n>D' */
+		cli_printf(cli, "%c%c%d%c", Key_ESC, Key_CONTROL, tail, Key_D);
+	}
+#if (CLI_ENABLE_SUGGEST == TRUE)
+	/* The old suggestion was cleared with the line */
+	cli->Suggestion = 0;
+	cli_suggest_show(cli);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The main handler of the Command Line Interpreter.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+int cli_handler(cli_t *cli) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+#if (CLI_ENABLE_LOG == TRUE)
+	cli_log_flush(cli);
+#endif
+#if (CLI_ENABLE_WORKERS == TRUE)
+	if (cli_worker_poll(cli)) {
+		/* The input waits until the foreground job is done */
+		cli->Idle = 1;
+		return CLI_OK;
+	}
+#endif
+	/* Basic Key Handler */
+	char symbol = (char)cli_getchar(cli);
+	cli->Idle = !symbol;
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	if (cli_flow_handler(cli, (uint8_t)symbol)) {
+		/* The key is for the pager */
+		return CLI_OK;
+	}
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+	if (cli->Screen != NULL) {
+		/* The live screen takes the keys instead of the line editor */
+		return cli_screen_handler(cli, (uint8_t)symbol);
+	}
+#endif
+	if (!symbol) {
+		return CLI_OK;
+	}
+	if (cli->Escape) {
+		/* The rest of the escape sequence may come in the next calls */
+		return cli_key_sequence(cli, symbol);
+	}
+	return cli_key_dispatch(cli, (uint8_t)symbol);
+}
+
+#if (CLI_KEY_BINDINGS > 0)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Bind the key to an action instead of the default one.
+* @note 	The binding of the same key is replaced. To return the
+*       	default action, pass NULL.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key A byte (0x00 .. 0xFF) or an escape sequence (`CLI_KEY_...`).
+* @param	function The action. It gets the instance and the key code.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no free place.
+*/
+int cli_bind(cli_t *cli, int key, cli_key_function_t function) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	int index = 0;
+	while ((index < cli->BindingCount) && (cli->Bindings[index].Key != key)) {
+		index++;
+	}
+	if (function == NULL) {
+		if (index < cli->BindingCount) {
+			/* Keep the bindings packed */
+			cli->Bindings[index] = cli->Bindings[--cli->BindingCount];
+		}
+		return CLI_OK;
+	}
+	if (index == CLI_KEY_BINDINGS) {
+		return CLI_ERROR;
+	}
+	cli->Bindings[index].Key = key;
+	cli->Bindings[index].Function = function;
+	cli->Bindings[index].Command = NULL;
+	if (index == cli->BindingCount) {
+		cli->BindingCount++;
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Bind the key to a command line (hotkey).
+* @note 	The command runs as if it was typed, but the edited line is kept
+*       	and the command is not added to the history.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key A byte (0x00 .. 0xFF) or an escape sequence (`CLI_KEY_...`).
+* @param	line Command line with arguments. It is not copied.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no free place.
+*/
+int cli_bind_command(cli_t *cli, int key, const char *line) {
+	assert_cli(line != NULL && "Command line is incorrect!\n");
+	if (cli_bind(cli, key, cli_key_handler_command) != CLI_OK) {
+		return CLI_ERROR;
+	}
+	for (int index = 0; index < cli->BindingCount; index++) {
+		if (cli->Bindings[index].Key == key) {
+			cli->Bindings[index].Command = line;
+		}
+	}
+	return CLI_OK;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the action of the key: the binding of the application or
+*       	the default one.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key A byte (0x00 .. 0xFF) or an escape sequence (`CLI_KEY_...`).
+*
+*/
+static int cli_key_dispatch(cli_t *cli, int key) {
+	cli_key_function_t function = NULL;
+#if (CLI_KEY_BINDINGS > 0)
+	for (int index = 0; index < cli->BindingCount; index++) {
+		if (cli->Bindings[index].Key == key) {
+			function = cli->Bindings[index].Function;
+			break;
+		}
+	}
+#endif
+	if (function != NULL) {
+		/* Bound by the application */
+	} else if (key < CLI_KEY_UP) {
+		function = cli_keys_byte[key];
+	} else if (key < CLI_KEY_LAST) {
+		function = cli_keys_sequence[key - CLI_KEY_UP];
+	}
+#if (CLI_ENABLE_COMPLETION == TRUE)
+	if (function != cli_key_handler_tab) {
+		/* The candidates are kept only for the next Tab */
+		cli_complete_drop(cli);
+	}
+#endif
+	if (function == NULL) {
+		return CLI_OK;
+	}
+#if (CLI_ENABLE_SUGGEST == TRUE)
+	if (cli->Suggestion) {
+		/* The suggestion is shown only with the cursor at the end */
+		if ((function == cli_key_handler_right) || (function == cli_key_handler_end)) {
+			function = cli_key_handler_accept;
+		} else if ((function != cli_key_handler) && (function != cli_key_handler_esc)) {
+			/* The symbols typed at the end just cover the suggestion */
+			cli_suggest_erase(cli);
+		}
+	}
+	int status = function(cli, key);
+	cli_suggest_show(cli);
+	return status;
+#else
+	return function(cli, key);
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Receive the escape sequence symbol by symbol, without waiting.
+* @note 	ESC '[' <parameters> <final>, ESC 'O' <final> or ESC <symbol>.
+*       	The sequence is dispatched when it is complete, unknown
+*       	sequences are ignored.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	symbol The next symbol of the sequence.
+*
+*/
+static int cli_key_sequence(cli_t *cli, char symbol) {
+	int length = cli->Escape - 1;
+	cli->Sequence[length++] = symbol;
+	cli->Escape++;
+	int complete = 1;
+	if (length == 1) {
+		complete = (symbol != '[') && (symbol != 'O');
+	} else if (cli->Sequence[0] == '[') {
+		/* Parameter bytes of CSI */
+		complete = (symbol < 0x30) || (symbol > 0x3f);
+	}
+	if (!complete) {
+		if (length < (int)sizeof(cli->Sequence) - 1) {
+			return CLI_OK;
+		}
+		/* Too long for any known key */
+		cli->Escape = 0;
+		return CLI_OK;
+	}
+	cli->Sequence[length] = 0;
+	cli->Escape = 0;
+	for (int index = 0; index < sizeof(cli_keys_escape) / sizeof(cli_keys_escape[0]); index++) {
+		if (!strcmp(cli_keys_escape[index].Sequence, cli->Sequence)) {
+			return cli_key_dispatch(cli, cli_keys_escape[index].Key);
+		}
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check if the CLI has work for `cli_handler`.
+* @note 	Without `CLI_USE_RING_BUFFER` it is only known whether the last
+*       	call of `cli_handler` received a symbol.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	(0) if there is no work and the caller can sleep.
+* @retval   (!0) if `cli_handler` must be called again.
+*/
+int cli_pending(cli_t *cli) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+#if (CLI_USE_RING_BUFFER == TRUE)
+	int pending = (cli_ring_count(&cli->Rx) != 0);
+#else
+	int pending = !cli->Idle || cli->Pending;
+#endif
+#if (CLI_ENABLE_LOG == TRUE)
+	pending |= (cli_atomic_load(&cli->Log.Enqueue) != cli_atomic_load(&cli->Log.Dequeue));
+#endif
+#if (CLI_ENABLE_WORKERS == TRUE)
+	if (cli->Waiting) {
+		/* The input is not processed, only the output of the jobs */
+		pending = 0;
+	}
+	pending |= cli_worker_pending(cli);
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+	pending |= (cli_screen_timeout(cli) == 0);
+#endif
+	return pending;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Sleep until the CLI has work, instead of calling `cli_handler`
+*       	in a busy loop.
+* @note 	Returns at once if there is work. Otherwise calls the wait
+*       	function of the port (`__io_cli_wait`), which is woken up
+*       	by the received symbols and `cli_log`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	timeout Maximum time to sleep, ms. (-1) to sleep without limit.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if error.
+*/
+int cli_wait(cli_t *cli, int timeout) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	if (cli_pending(cli) || (cli->_io_wait == NULL)) {
+		return CLI_OK;
+	}
+#if (CLI_ENABLE_SCREEN == TRUE)
+	/* Wake up for the next frame of the live screen */
+	int frame = cli_screen_timeout(cli);
+	if ((frame >= 0) && ((timeout < 0) || (frame < timeout))) {
+		timeout = frame;
+	}
+#endif
+	return cli->_io_wait(timeout);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Handler for basic information keys.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The printable character to be processed.
+*
+*/
+static int cli_key_handler(cli_t *cli, int key) {
+	/* A paste comes as a burst: take all the printable symbols already
+	 * received, in the scratch arena */
+	size_t mark = cli->Scratch.Top;
+	size_t size = cli_scratch_rest(cli);
+	size = (size < CLI_BUFFER_SIZE) ? size : CLI_BUFFER_SIZE;
+	char *text = (size > 1) ? cli_scratch_alloc(cli, size) : NULL;
+	if (text == NULL) {
+		/* One symbol at a time */
+		char symbol = (char)key;
+		return cli_key_handler_insert(cli, &symbol, 1);
+	}
+	text[0] = key;
+	int count = 1 + cli_getchar_printable(cli, &text[1], size - 1);
+	int status = cli_key_handler_insert(cli, text, count);
+	cli->Scratch.Top = mark;
+	return status;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Insert the text at the cursor and draw only the changed part
+*       	of the line.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	text Printable symbols.
+* @param	count Number of symbols.
+*
+*/
+static int cli_key_handler_insert(cli_t *cli, const char *text, int count) {
+	int length = strlen(cli->Buffer);
+	int size = cli_line_reserve(cli, length + count + 1);
+	int full = (length + count > size - 1);
+	if (full) {
+		count = size - 1 - length;
+	}
+	memmove(&cli->Buffer[cli->Point + count], &cli->Buffer[cli->Point], length - cli->Point + 1);
+	memcpy(&cli->Buffer[cli->Point], text, count);
+	if (full) {
+		cli->Point += count;
+		cli_printf(cli, "\r%sThe buffer is full.\r\n", CONSOLE_CLEAR_STRING);
+		cli_print_line(cli);
+		return CLI_OK;
+	}
+	/* The new symbols and the tail of the line, then the cursor back */
+	cli_write(cli, &cli->Buffer[cli->Point], length + count - cli->Point);
+	cli->Point += count;
+	int tail = length + count - cli->Point;
+	if (tail) {
+		cli_printf(cli, "\033[%dD", tail);
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Set the cursor to the position in the line.
+* @note 	Absolute positioning (CHA) does not depend on where the cursor
+*       	was, so the line is not redrawn.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	point New position in the buffer.
+*
+*/
+static int cli_key_move(cli_t *cli, int point) {
+	if (point != cli->Point) {
+		cli->Point = point;
+		cli_printf(cli, "\033[%dG", (int)CLI_PREFIX_WIDTH + point + 1);
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the symbols [from, to) and draw only the tail of the line.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	from First symbol to remove, the cursor is set here.
+* @param	to Symbol after the last one to remove.
+*
+*/
+static int cli_key_erase(cli_t *cli, int from, int to) {
+	if (from >= to) {
+		return CLI_OK;
+	}
+	int length = strlen(cli->Buffer);
+	memmove(&cli->Buffer[from], &cli->Buffer[to], length - to + 1);
+	cli_key_move(cli, from);
+	int tail = length - to;
+	cli_write(cli, &cli->Buffer[from], tail);
+	cli_printf(cli, CONSOLE_CLEAR_STRING);
+	if (tail) {
+		cli->Point = from + tail;
+		cli_key_move(cli, from);
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the start of the word on the left of the cursor.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` Position in the buffer.
+*/
+static int cli_key_word_left(cli_t *cli) {
+	int point = cli->Point;
+	while (point && (cli->Buffer[point - 1] == Key_SPACE)) point--;
+	while (point && (cli->Buffer[point - 1] != Key_SPACE)) point--;
+	return point;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the end of the word on the right of the cursor.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` Position in the buffer.
+*/
+static int cli_key_word_right(cli_t *cli) {
+	int point = cli->Point;
+	while (cli->Buffer[point] == Key_SPACE) point++;
+	while (cli->Buffer[point] && (cli->Buffer[point] != Key_SPACE)) point++;
+	return point;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The handler removes the character on the left.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_backspace(cli_t *cli, int key) {
+	if (cli->Point) {
+		return cli_key_erase(cli, cli->Point - 1, cli->Point);
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The handler removes the character on the Right.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_delete(cli_t *cli, int key) {
+	if (cli->Buffer[cli->Point]) {
+		return cli_key_erase(cli, cli->Point, cli->Point + 1);
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Handlers of the cursor movement keys.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_left(cli_t *cli, int key) {
+	if (cli->Point) {
+		cli->Point--;
+		cli_printf(cli, "%c%c%c", Key_ESC, Key_CONTROL, Key_D);
+	}
+	return CLI_OK;
+}
+
+static int cli_key_handler_right(cli_t *cli, int key) {
+	if (cli->Buffer[cli->Point]) {
+		cli->Point++;
+		cli_printf(cli, "%c%c%c", Key_ESC, Key_CONTROL, Key_C);
+	}
+	return CLI_OK;
+}
+
+static int cli_key_handler_home(cli_t *cli, int key) {
+	return cli_key_move(cli, 0);
+}
+
+static int cli_key_handler_end(cli_t *cli, int key) {
+	return cli_key_move(cli, strlen(cli->Buffer));
+}
+
+static int cli_key_handler_word_left(cli_t *cli, int key) {
+	return cli_key_move(cli, cli_key_word_left(cli));
+}
+
+static int cli_key_handler_word_right(cli_t *cli, int key) {
+	return cli_key_move(cli, cli_key_word_right(cli));
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Handlers of the keys that remove a part of the line.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_kill_end(cli_t *cli, int key) {
+	return cli_key_erase(cli, cli->Point, strlen(cli->Buffer));
+}
+
+static int cli_key_handler_kill_start(cli_t *cli, int key) {
+	return cli_key_erase(cli, 0, cli->Point);
+}
+
+static int cli_key_handler_kill_word_left(cli_t *cli, int key) {
+	return cli_key_erase(cli, cli_key_word_left(cli), cli->Point);
+}
+
+static int cli_key_handler_kill_word_right(cli_t *cli, int key) {
+	return cli_key_erase(cli, cli->Point, cli_key_word_right(cli));
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Drop the edited line and start a new one.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_cancel(cli_t *cli, int key) {
+	cli_printf(cli, "^C\r\n");
+	cli_clear_buffer(cli);
+	cli->HistoryPoint = cli->HistoryNewPoint;
+	cli_print_line(cli);
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Clear the terminal and draw the edited line again.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_clear(cli_t *cli, int key) {
+	cli_printf(cli, CONSOLE_CLEAR_TERMINAL);
+	cli_print_line(cli);
+	return CLI_OK;
+}
+
+#if (CLI_KEY_BINDINGS > 0)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the command line bound to the key by `cli_bind_command`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_command(cli_t *cli, int key) {
+	const char *line = NULL;
+	for (int index = 0; index < cli->BindingCount; index++) {
+		if (cli->Bindings[index].Key == key) {
+			line = cli->Bindings[index].Command;
+		}
+	}
+	if ((line == NULL) || (strlen(line) >= CLI_BUFFER_SIZE)) {
+		return CLI_ERROR;
+	}
+	/* The line is split in place: the command gets a copy */
+	size_t mark = cli->Scratch.Top;
+	char *buffer = cli_scratch_alloc(cli, strlen(line) + 1);
+	if (buffer == NULL) {
+		return CLI_ERROR;
+	}
+	strcpy(buffer, line);
+	cli_printf(cli, "\r\n");
+	int ret = 0;
+	cli_execute(cli, buffer, &ret, CLI_RUN_FOREGROUND);
+	cli->Scratch.Top = mark;
+#if (CLI_ENABLE_WORKERS == TRUE)
+	/* The prompt is printed when the foreground job is done */
+	if (cli->Waiting) return ret;
+#endif
+	cli_print_line(cli);
+	return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Function for processing the Enter key.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_enter(cli_t *cli, int key) {
+	cli_error_t res = CLI_OK;
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	/* The echo of the command starts a new page */
+	cli_flow_start(cli);
+#endif
+	if (cli->Buffer[0]) {
+		res = cli_run(cli);
+	} else {
+		cli_printf(cli, "%c", Key_VT);
+	}
+#if (CLI_ENABLE_WORKERS == TRUE)
+	/* The prompt is printed when the foreground job is done */
+	if (cli->Waiting) return res;
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+	/* The prompt is printed when the live screen is closed */
+	if (cli->Screen != NULL) return res;
+#endif
+	cli_print_line(cli);
+	return res;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Function to handle the launch of commands from the console.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+static int cli_run(cli_t *cli) {
+	/* Delete 'Key_Space' at the end of the command */
+	cli->Point = strlen(cli->Buffer);
+	while (cli->Point && (cli->Buffer[cli->Point - 1] == Key_SPACE)) {
+		cli->Buffer[--cli->Point] = 0;
+	}
+	cli_printf(cli, "\r\n");
+	/* Add list command running */
+	cli_history_add(cli);
+	int mode = CLI_RUN_FOREGROUND;
+#if (CLI_ENABLE_WORKERS == TRUE)
+	/* 'command &' runs in the background */
+	int length = strlen(cli->Buffer);
+	if ((length > 1) && (cli->Buffer[length - 1] == '&')) {
+		mode = CLI_RUN_BACKGROUND;
+		cli->Buffer[--length] = 0;
+		while (length && (cli->Buffer[length - 1] == Key_SPACE)) {
+			cli->Buffer[--length] = 0;
+		}
+	}
+#endif
+	int ret = 0;
+	cli_execute(cli, cli->Buffer, &ret, mode);
+	cli_clear_buffer(cli);
+	cli_printf(cli, "\r%s\r", CONSOLE_CLEAR_STRING);
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Split the command line into arguments and run the commands.
+* @note 	The line is modified: the separators are replaced by zeros.
+*       	The commands of the list (`cmd1; cmd2`) run one after another,
+*       	only the last one can go to the background.
+*       	The line after the variables are put in and the arguments are
+*       	kept in the scratch arena, not on the stack.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	line Command line without trailing spaces.
+* @param	ret The value returned by the (last) command.
+* @param	mode Way to launch the command (`CLI_RUN_...`).
+* @retval 	`CLI_OK` (0) if the commands were found and launched.
+* @retval   `CLI_ERROR` (!0) if a command was not found.
+*/
+static int cli_execute(cli_t *cli, char *line, int *ret, int mode) {
+	size_t mark = cli->Scratch.Top;
+#if (CLI_ENABLE_VARIABLES == TRUE)
+	/* Most lines have no variables and are not copied */
+	if (strchr(line, '$') != NULL) {
+		char *expanded = cli_scratch_alloc(cli, CLI_BUFFER_SIZE);
+		int length = -1;
+		if (expanded != NULL) {
+			length = cli_variables_expand(&cli->Variables, line, expanded, CLI_BUFFER_SIZE);
+		}
+		if (length < 0) {
+			cli_printf(cli, "The line is too long after the variables are put in.\r\n");
+			cli->Scratch.Top = mark;
+			*ret = CLI_ERROR;
+			return CLI_OK;
+		}
+		/* Only the used part is kept */
+		cli->Scratch.Top = (uint8_t*)expanded - cli->Scratch.Data + length + 1;
+		line = expanded;
+	}
+#endif
+	int status = CLI_OK;
+	*ret = 0;
+	while (line != NULL) {
+		/* The arguments take the rest of the arena, then only what they need */
+		size_t top = cli->Scratch.Top;
+		int max = cli_scratch_rest(cli) / sizeof(char*);
+		char **argv = cli_scratch_alloc(cli, 0);
+		char *next;
+		int argc = cli_tokenize(line, argv, max - 1, &next);
+		if ((max < 2) || (argc == max - 1)) {
+			cli_printf(cli, "Too many arguments for the scratch memory.\r\n");
+			cli->Scratch.Failed++;
+			*ret = CLI_ERROR;
+			status = CLI_ERROR;
+			break;
+		}
+		if (argc) {
+			cli_scratch_alloc(cli, (argc + 1) * sizeof(char*));
+			argv[argc] = NULL;
+			int step = ((next != NULL) && (mode != CLI_RUN_DIRECT)) ? CLI_RUN_INLINE : mode;
+			status |= cli_execute_command(cli, argc, argv, ret, step);
+		}
+		cli->Scratch.Top = top;
+		line = next;
+	}
+	cli->Scratch.Top = mark;
+	return (status != CLI_OK) ? CLI_ERROR : CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the command or alias of the arguments and run it.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	argc Number of arguments.
+* @param	argv Array of argument values.
+* @param	ret The value returned by the command.
+* @param	mode Way to launch the command (`CLI_RUN_...`).
+* @retval 	`CLI_OK` (0) if the command was found and launched.
+* @retval   `CLI_ERROR` (!0) if the command was not found.
+*/
+static int cli_execute_command(cli_t *cli, int argc, char *argv[], int *ret, int mode) {
+#if (CLI_ENABLE_ALIASES == TRUE)
+	/* The aliases go first: an alias can wrap the command of the same name */
+	cli_alias_t *alias = cli_alias_find(cli, argv[0]);
+	if (alias != NULL) {
+		return cli_execute_alias(cli, alias, argc, argv, ret, mode);
+	}
+#endif
+	int depth = 0;
+	const cli_command_t *command = cli_command_walk(cli, argc, argv, &depth);
+	if (command == NULL) {
+		cli_print_result(cli, argv[0], CLI_ERROR, 0);
+		*ret = CLI_ERROR;
+		return CLI_ERROR;
+	}
+	return cli_dispatch(cli, command, argc - depth, &argv[depth], ret, mode);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the found command.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	command The command.
+* @param	argc Number of arguments, the first one is the name of the command.
+* @param	argv Array of argument values.
+* @param	ret The value returned by the command.
+* @param	mode Way to launch the command (`CLI_RUN_...`).
+* @retval 	`CLI_OK` (0) if success.
+*/
+static int cli_dispatch(cli_t *cli, const cli_command_t *command, int argc, char *argv[], int *ret, int mode) {
+	if (command->Function == NULL) {
+		/* A group without its own function: show what it contains */
+		cli_print_group(cli, command);
+		*ret = 0;
+		return CLI_OK;
+	}
+#if (CLI_ENABLE_WORKERS == TRUE)
+	if ((mode == CLI_RUN_BACKGROUND) ||
+		((mode == CLI_RUN_FOREGROUND) && (command->Flags & CLI_COMMAND_OFFLOAD))) {
+		*ret = cli_worker_submit(cli, command, argc, argv, mode == CLI_RUN_BACKGROUND);
+		return CLI_OK;
+	}
+#endif
+	/* Run command */
+#if (CLI_ENABLE_TRACE == TRUE)
+	cli_trace_event(&cli->Trace, CLI_TRACE_DISPATCH, argc);
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+	cli->Stats.Commands++;
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	if (mode != CLI_RUN_DIRECT) {
+		cli_flow_start(cli);
+	}
+#endif
+#if (CLI_ENABLE_PLUGINS == TRUE)
+	/* The plugin of the command is not unloaded while the command runs */
+	cli_plugin_t *plugin = cli_plugin_enter(command);
+#endif
+	/* What the command took from the scratch arena is given back at once */
+	size_t mark = cli->Scratch.Top;
+	*ret = command->Function(cli, argc, argv);
+	cli->Scratch.Top = mark;
+#if (CLI_ENABLE_PLUGINS == TRUE)
+	cli_plugin_leave(plugin);
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	if (mode != CLI_RUN_DIRECT) {
+		/* The dropped output ends with the command */
+		cli->Discard = 0;
+	}
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+	cli_trace_event(&cli->Trace, CLI_TRACE_RETURN, *ret);
+#endif
+	if (*ret && (mode != CLI_RUN_DIRECT)) {
+		/* If command return error */
+		cli_print_result(cli, argv[0], *ret, 1);
+	}
+	return CLI_OK;
+}
+
+#if (CLI_ENABLE_ALIASES == TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the commands of the alias.
+* @note 	The commands were found when the alias was defined. The
+*       	arguments of the alias are added to its last command.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	alias The alias.
+* @param	argc Number of arguments, the first one is the name of the alias.
+* @param	argv Array of argument values.
+* @param	ret The value returned by the last command.
+* @param	mode Way to launch the last command (`CLI_RUN_...`).
+* @retval 	`CLI_OK` (0) if the commands were found and launched.
+* @retval   `CLI_ERROR` (!0) if a command was not found.
+*/
+static int cli_execute_alias(cli_t *cli, cli_alias_t *alias, int argc, char *argv[], int *ret, int mode) {
+	if (alias->Running) {
+		/* a -> b -> a: it would run until the depth is used up */
+		cli_printf(cli, "Alias '%s' is recursive\r\n", alias->Text);
+		*ret = CLI_ERROR;
+		return CLI_ERROR;
+	}
+	if (cli->AliasDepth >= CLI_ALIAS_DEPTH) {
+		cli_printf(cli, "Alias '%s' is nested too deep\r\n", alias->Text);
+		*ret = CLI_ERROR;
+		return CLI_ERROR;
+	}
+	if (alias->Generation != cli_alias_generation(cli)) {
+		/* The commands or aliases were changed since the last time */
+		cli_alias_resolve(cli, alias);
+	}
+	cli->AliasDepth++;
+	alias->Running = 1;
+	int status = CLI_OK;
+	size_t mark = cli->Scratch.Top;
+	for (int i = 0; i < alias->Count; i++) {
+		const cli_alias_step_t *step = &alias->Steps[i];
+		int last = (i == alias->Count - 1);
+		int extra = last ? argc - 1 : 0;
+		cli->Scratch.Top = mark;
+		char **args = cli_scratch_alloc(cli, (step->Argc + extra + 1) * sizeof(char*));
+		/* The command can change its arguments: it gets a copy */
+		char *text = cli_scratch_alloc(cli, CLI_BUFFER_SIZE);
+		if ((args == NULL) || (text == NULL)) {
+			/* The scratch arena is used up by the nested aliases */
+			cli_printf(cli, "Alias '%s' is nested too deep\r\n", alias->Text);
+			*ret = CLI_ERROR;
+			status = CLI_ERROR;
+			break;
+		}
+		const char *source = &alias->Text[step->Offset];
+		int length = 0;
+		int size = 0;
+		for (int j = 0; (j < step->Argc) && (size >= 0); j++) {
+			args[j] = &text[length];
+			size = strlen(source);
+#if (CLI_ENABLE_VARIABLES == TRUE)
+			if (step->Expand) {
+				size = cli_variables_expand(&cli->Variables, source, &text[length], CLI_BUFFER_SIZE - length);
+			} else
+#endif
+			if (length + size < CLI_BUFFER_SIZE) {
+				memcpy(&text[length], source, size + 1);
+			} else {
+				size = -1;
+			}
+			length += size + 1;
+			source += strlen(source) + 1;
+		}
+		if (size < 0) {
+			cli_printf(cli, "The line of the alias '%s' is too long.\r\n", alias->Text);
+			*ret = CLI_ERROR;
+			status = CLI_ERROR;
+			break;
+		}
+		args[step->Argc + extra] = NULL;
+		for (int j = 0; j < extra; j++) {
+			args[step->Argc + j] = argv[1 + j];
+		}
+		int launch = last ? mode : ((mode == CLI_RUN_DIRECT) ? CLI_RUN_DIRECT : CLI_RUN_INLINE);
+		if (step->Alias) {
+			status |= cli_execute_alias(cli, &cli->Aliases[step->Alias - 1], step->Argc + extra, args, ret, launch);
+		} else if (step->Command == NULL) {
+			cli_print_result(cli, args[0], CLI_ERROR, 0);
+			*ret = CLI_ERROR;
+			status = CLI_ERROR;
+		} else {
+			status |= cli_dispatch(cli, step->Command, step->Argc + extra - step->Depth, &args[step->Depth], ret, launch);
+		}
+	}
+	cli->Scratch.Top = mark;
+	alias->Running = 0;
+	cli->AliasDepth--;
+	return (status != CLI_OK) ? CLI_ERROR : CLI_OK;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Split the command into arguments, in place.
+* @note 	The arguments are separated by spaces. With
+*       	`CLI_ENABLE_COMMAND_LISTS`, quotes ('...' or "...") keep the
+*       	spaces and ';' inside and are removed, and the command ends at
+*       	';' outside the quotes.
+* @param	line The command, modified in place.
+* @param	argv Array for the arguments.
+* @param	max Size of the array.
+* @param	next Returns the start of the next command of the list or NULL.
+* @return	`int` Number of the arguments.
+*/
+int cli_tokenize(char *line, char *argv[], int max, char **next) {
+	int argc = 0;
+	char *read = line;
+	char *write = line;
+	*next = NULL;
+	while (1) {
+		while (*read == Key_SPACE) read++;
+		if (*read == 0) {
+			break;
+		}
+#if (CLI_ENABLE_COMMAND_LISTS == TRUE)
+		if (*read == ';') {
+			*next = read + 1;
+			break;
+		}
+#endif
+		char *token = write;
+#if (CLI_ENABLE_COMMAND_LISTS == TRUE)
+		char quote = 0;
+		while (*read) {
+			if (quote) {
+				if (*read == quote) {
+					quote = 0;
+					read++;
+					continue;
+				}
+			} else if ((*read == '\'') || (*read == '"')) {
+				quote = *read++;
+				continue;
+			} else if ((*read == Key_SPACE) || (*read == ';')) {
+				break;
+			}
+			*write++ = *read++;
+		}
+#else
+		while (*read && (*read != Key_SPACE)) {
+			*write++ = *read++;
+		}
+#endif
+		/* The argument may end where the separator was */
+		char stop = *read;
+		if (stop) read++;
+		*write++ = 0;
+		if (argc < max) {
+			argv[argc++] = token;
+		}
+		if (stop == ';') {
+			*next = read;
+			break;
+		}
+		if (stop == 0) {
+			break;
+		}
+	}
+	return argc;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the command of the arguments: the groups are walked as
+*       	long as the next argument is their subcommand.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	argc Number of arguments.
+* @param	argv Array of argument values.
+* @param	depth Returns the number of arguments taken by the groups.
+* @return	`cli_command_t*` The command or NULL if not found.
+*/
+const cli_command_t *cli_command_walk(cli_t *cli, int argc, char *argv[], int *depth) {
+	*depth = 0;
+	const cli_command_t *command = cli_command_find(cli, NULL, argv[0], strlen(argv[0]));
+	if (command == NULL) {
+		return NULL;
+	}
+	while ((command->Children != NULL) && (*depth + 1 < argc)) {
+		const cli_command_t *child = cli_command_find(cli, command, argv[*depth + 1], strlen(argv[*depth + 1]));
+		if (child == NULL) break;
+		command = child;
+		(*depth)++;
+	}
+	return command;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the number of places in one level of the tree.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	group The group, or NULL for the top level.
+* @return	`int` Number of places in the level, some of them can be free.
+*/
+static int cli_command_level(cli_t *cli, const cli_command_t *group) {
+	if (group == NULL) {
+#if (CLI_ENABLE_PLUGINS == TRUE)
+		/* The commands of the plugins follow the places of the instance */
+		return CLI_MAX_COUNT_COMMAND + cli_plugin_count();
+#else
+		return CLI_MAX_COUNT_COMMAND;
+#endif
+	}
+	int count = 0;
+	if (group->Children != NULL) {
+		while (group->Children[count].Name != NULL) count++;
+	}
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the command of one level of the tree.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	group The group, or NULL for the top level.
+* @param	index Place in the level, less than `cli_command_level`.
+* @return	`cli_command_t*` The command or NULL if the place is free.
+*/
+static const cli_command_t *cli_command_at(cli_t *cli, const cli_command_t *group, int index) {
+	if (group != NULL) {
+		return &group->Children[index];
+	}
+#if (CLI_ENABLE_PLUGINS == TRUE)
+	if (index >= CLI_MAX_COUNT_COMMAND) {
+		return cli_plugin_at(index - CLI_MAX_COUNT_COMMAND);
+	}
+#endif
+#if (CLI_COMPACT == TRUE)
+	return cli->Commands[index];
+#else
+	return (cli->Commands[index].Name != NULL) ? &cli->Commands[index] : NULL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the command by name in one level of the tree.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	group The group, or NULL for the top level.
+* @param	name Name of the command (not terminated by zero).
+* @param	length Length of the name.
+* @return	`cli_command_t*` The command or NULL if not found.
+*/
+static const cli_command_t *cli_command_find(cli_t *cli, const cli_command_t *group, const char *name, size_t length) {
+	int count = (group == NULL) ? CLI_MAX_COUNT_COMMAND : cli_command_level(cli, group);
+	for (int index = 0; index < count; index++) {
+		const cli_command_t *command = cli_command_at(cli, group, index);
+		if (command == NULL) continue;
+		if (!strncmp(command->Name, name, length) && (command->Name[length] == 0)) {
+			return command;
+		}
+	}
+#if (CLI_ENABLE_PLUGINS == TRUE)
+	if (group == NULL) {
+		/* The registry of the plugins is sorted by the name */
+		return cli_plugin_find(name, length);
+	}
+#endif
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the command by its full path: `group subgroup command`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	argc Number of the names in the path.
+* @param	argv Names from the top level down.
+* @return	`cli_command_t*` The command or NULL if not found.
+*/
+const cli_command_t *cli_command_path(cli_t *cli, int argc, char *argv[]) {
+	const cli_command_t *command = NULL;
+	for (int i = 0; i < argc; i++) {
+		if ((i > 0) && (command->Children == NULL)) {
+			return NULL;
+		}
+		command = cli_command_find(cli, command, argv[i], strlen(argv[i]));
+		if (command == NULL) {
+			return NULL;
+		}
+	}
+	return command;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Report the failed command.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	name Name of the command.
+* @param	ret The value returned by the command.
+* @param	found (0) if the command was not found.
+*
+*/
+static void cli_print_result(cli_t *cli, const char *name, int ret, int found) {
+#if (CLI_ENABLE_EMIT == TRUE)
+	if (cli->Emit.Format != CLI_FORMAT_TEXT) {
+		/* The program reading the output gets the error in the same format */
+		cli_emit_begin_object(cli, NULL);
+		cli_emit_kv_str(cli, "command", name);
+		if (found) {
+			cli_emit_kv_int(cli, "return", ret);
+		} else {
+			cli_emit_kv_str(cli, "error", "not found");
+		}
+		cli_emit_end_object(cli);
+		return;
+	}
+#endif
+	if (found) {
+		cli_printf(cli, "Function '%s' return %d [0x%.8x]\r\n", name, ret, ret);
+	} else {
+		cli_printf(cli, "Command '%s' not found\r\n", name);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the commands of the group with their subgroups.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	group The group, or NULL for the top level only.
+*
+*/
+void cli_print_group(cli_t *cli, const cli_command_t *group) {
+	/* Walk the subtree without recursion: the path from the group */
+	const cli_command_t *path[CLI_COMMAND_DEPTH];
+	int position[CLI_COMMAND_DEPTH];
+	int depth = 0;
+	path[0] = group;
+	position[0] = 0;
+#if (CLI_ENABLE_EMIT == TRUE)
+	/* In JSON and CBOR the commands are the array of objects,
+	 * the subgroup is the array in the object of the group */
+	int structured = (cli->Emit.Format != CLI_FORMAT_TEXT);
+	if (structured) {
+		cli_emit_begin_array(cli, "commands", 0);
+	}
+#endif
+	while (depth >= 0) {
+		int count = cli_command_level(cli, path[depth]);
+		if (position[depth] >= count) {
+#if (CLI_ENABLE_EMIT == TRUE)
+			if (structured && depth) {
+				cli_emit_end_array(cli);
+				cli_emit_end_object(cli);
+			}
+#endif
+			depth--;
+			continue;
+		}
+		const cli_command_t *command = cli_command_at(cli, path[depth], position[depth]++);
+		if (command == NULL) continue;
+		int open = (group != NULL) && (command->Children != NULL) && (depth + 1 < CLI_COMMAND_DEPTH);
+#if (CLI_ENABLE_EMIT == TRUE)
+		if (structured) {
+			cli_emit_begin_object(cli, NULL);
+			cli_emit_kv_str(cli, "name", command->Name);
+			cli_emit_kv_str(cli, "help", command->Help);
+			cli_emit_kv_bool(cli, "group", command->Children != NULL);
+			if (open) {
+				cli_emit_begin_array(cli, "commands", 0);
+			} else {
+				cli_emit_end_object(cli);
+			}
+		} else
+#endif
+		cli_printf(cli, "\t%*s%s%s - %s\r\n", 2 * depth, "", command->Name,
+				(command->Children != NULL) ? " ..." : "", command->Help);
+		if (open) {
+			path[++depth] = command;
+			position[depth] = 0;
+		}
+	}
+#if (CLI_ENABLE_EMIT == TRUE)
+	if (structured) {
+		cli_emit_end_array(cli);
+	}
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the command line from the program, bypassing the terminal.
+* @note 	There is no echo, redraw of the line or entry in the history.
+*       	The buffer and cursor of the interactive session are not
+*       	touched, so the function can also be called from a command.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	line Command line with arguments.
+* @param	out Buffer for the command output. Can be NULL.
+* @param	outlen Size of the `out` buffer. The output is truncated and
+*       	always terminated by zero.
+* @return	`int` The value returned by the command.
+* @retval   `CLI_ERROR` (!0) if the command was not found.
+*/
+int cli_exec(cli_t *cli, const char *line, char *out, size_t outlen) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	assert_cli(line != NULL && "Command line is incorrect!\n");
+	cli_capture_t capture = {
+		.Data = out,
+		.Size = (out != NULL) ? outlen : 0,
+	};
+	int ret = cli_exec_capture(cli, line, &capture);
+	if (capture.Size) {
+		out[capture.Length] = 0;
+	}
+	return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Run the command line from the program with the output
+*       	redirected to the capture buffer or sink.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	line Command line with arguments.
+* @param	capture Output receiver. If `Sink` is set, it gets all the
+*       	output, otherwise it is written to `Data`.
+* @return	`int` The value returned by the command.
+* @retval   `CLI_ERROR` (!0) if the command was not found.
+*/
+int cli_exec_capture(cli_t *cli, const char *line, cli_capture_t *capture) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	assert_cli(capture != NULL && "Capture is incorrect!\n");
+	size_t length = strlen(line);
+	if (length >= CLI_BUFFER_SIZE) {
+		return CLI_ERROR;
+	}
+	size_t mark = cli->Scratch.Top;
+	char *buffer = cli_scratch_alloc(cli, length + 1);
+	if (buffer == NULL) {
+		return CLI_ERROR;
+	}
+	memcpy(buffer, line, length + 1);
+	/* Delete 'Key_Space' at the end of the command */
+	while (length && buffer[length - 1] == Key_SPACE) {
+		buffer[--length] = 0;
+	}
+
+	cli_capture_t *previous = cli->Capture;
+	cli->Capture = capture;
+	int ret = 0;
+	if (cli_execute(cli, buffer, &ret, CLI_RUN_DIRECT) != CLI_OK) {
+		ret = CLI_ERROR;
+	}
+	cli->Capture = previous;
+	cli->Scratch.Top = mark;
+	return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the temporary memory for the running command.
+* @note 	The memory is given back when the command returns: it must
+*       	not be kept after that. The commands run by the workers have
+*       	their own stack and get nothing.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	size Size, bytes.
+* @return	`void*` The memory, aligned for a pointer, or NULL if the
+*       	arena is full.
+*/
+void *cli_scratch_alloc(cli_t *cli, size_t size) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+	cli_scratch_t *scratch = &cli->Scratch;
+#if (CLI_ENABLE_WORKERS == TRUE)
+	if (cli_worker_self(cli)) {
+		return NULL;
+	}
+#endif
+	size_t top = (scratch->Top + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+	if ((top > sizeof(scratch->Data)) || (size > sizeof(scratch->Data) - top)) {
+		scratch->Failed++;
+		return NULL;
+	}
+	scratch->Top = top + size;
+	if (scratch->Top > scratch->Peak) {
+		scratch->Peak = scratch->Top;
+	}
+	return &scratch->Data[top];
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Join the arguments with spaces in the scratch arena.
+* @note 	For the commands that take the rest of the line as one text.
+*       	The arguments need not lie in one buffer: those added to an
+*       	alias lie in the line, the others in the text of the alias.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	argc Number of arguments.
+* @param	argv Array of argument values.
+* @return	`char*` The text, or NULL if the arena is full.
+*/
+char *cli_scratch_join(cli_t *cli, int argc, char *argv[]) {
+	size_t size = 1;
+	for (int i = 0; i < argc; i++) {
+		size += strlen(argv[i]) + 1;
+	}
+	char *text = cli_scratch_alloc(cli, size);
+	if (text == NULL) {
+		return NULL;
+	}
+	size_t length = 0;
+	for (int i = 0; i < argc; i++) {
+		if (i) {
+			text[length++] = ' ';
+		}
+		size_t part = strlen(argv[i]);
+		memcpy(&text[length], argv[i], part);
+		length += part;
+	}
+	text[length] = 0;
+	return text;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the free size of the scratch arena.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`size_t` Size, bytes, after the alignment for a pointer.
+*/
+static size_t cli_scratch_rest(cli_t *cli) {
+	size_t top = (cli->Scratch.Top + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+	return (top < sizeof(cli->Scratch.Data)) ? sizeof(cli->Scratch.Data) - top : 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the RAM taken by the instance, field by field.
+* @note 	`padding` is the rest of `sizeof(cli_t)`: the gaps between the
+*       	fields. The pool of the lines is shared by all the instances
+*       	and is not a part of the instance.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_sizeof_report(cli_t *cli) {
+	assert_cli(cli != NULL && "CLI instance is incorrect!\n");
+#define CLI_SIZEOF(_field) {#_field, sizeof(((cli_t*)0)->_field)}
+	static const struct {
+		const char *Name;
+		unsigned int Size;
+	} fields[] = {
+		CLI_SIZEOF(_io_putchar),
+		CLI_SIZEOF(_io_getchar),
+		CLI_SIZEOF(_io_wait),
+		CLI_SIZEOF(_io_wakeup),
+		CLI_SIZEOF(Buffer),
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+		CLI_SIZEOF(BufferSize),
+		CLI_SIZEOF(Inline),
+#endif
+		CLI_SIZEOF(Point),
+		CLI_SIZEOF(Commands),
+		CLI_SIZEOF(History),
+		CLI_SIZEOF(HistoryPoint),
+		CLI_SIZEOF(HistoryNewPoint),
+#if (CLI_ENABLE_SUGGEST == TRUE)
+		CLI_SIZEOF(HistoryIndex),
+		CLI_SIZEOF(HistoryCount),
+		CLI_SIZEOF(Suggestion),
+#endif
+		CLI_SIZEOF(Capture),
+		CLI_SIZEOF(Idle),
+		CLI_SIZEOF(Escape),
+		CLI_SIZEOF(Sequence),
+#if (CLI_KEY_BINDINGS > 0)
+		CLI_SIZEOF(Bindings),
+		CLI_SIZEOF(BindingCount),
+#endif
+		CLI_SIZEOF(Scratch),
+#if (CLI_ENABLE_COMPLETION == TRUE)
+		CLI_SIZEOF(Completion),
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+		CLI_SIZEOF(Stats),
+#endif
+#if (CLI_USE_RING_BUFFER != TRUE)
+		CLI_SIZEOF(Pending),
+#endif
+#if (CLI_ENABLE_WORKERS == TRUE)
+		CLI_SIZEOF(Waiting),
+		CLI_SIZEOF(Streaming),
+#endif
+#if (CLI_USE_RING_BUFFER == TRUE)
+		CLI_SIZEOF(_io_txstart),
+		CLI_SIZEOF(Rx),
+		CLI_SIZEOF(Tx),
+		CLI_SIZEOF(RxData),
+		CLI_SIZEOF(TxData),
+		CLI_SIZEOF(RxDropped),
+		CLI_SIZEOF(TxStalled),
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+		CLI_SIZEOF(TxXoff),
+		CLI_SIZEOF(TxHeld),
+		CLI_SIZEOF(Page),
+		CLI_SIZEOF(PageSent),
+		CLI_SIZEOF(Pager),
+		CLI_SIZEOF(Discard),
+		CLI_SIZEOF(Raw),
+		CLI_SIZEOF(PageLines),
+		CLI_SIZEOF(PageAhead),
+		CLI_SIZEOF(PageStart),
+		CLI_SIZEOF(PageSeen),
+		CLI_SIZEOF(TxDropped),
+#endif
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+		CLI_SIZEOF(RxLeft),
+		CLI_SIZEOF(TxLeft),
+#endif
+#if (CLI_ENABLE_LOG == TRUE)
+		CLI_SIZEOF(Log),
+#endif
+#if (CLI_ENABLE_VARIABLES == TRUE)
+		CLI_SIZEOF(Variables),
+#endif
+#if (CLI_ENABLE_ALIASES == TRUE)
+		CLI_SIZEOF(Aliases),
+		CLI_SIZEOF(Generation),
+		CLI_SIZEOF(AliasDepth),
+#endif
+#if (CLI_ENABLE_EMIT == TRUE)
+		CLI_SIZEOF(Emit),
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+		CLI_SIZEOF(Trace),
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+		CLI_SIZEOF(Screen),
+#endif
+	};
+#undef CLI_SIZEOF
+	unsigned int used = 0;
+#if (CLI_ENABLE_EMIT == TRUE)
+	cli_emit_begin_object(cli, NULL);
+	for (int i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+		cli_emit_kv_int(cli, fields[i].Name, fields[i].Size);
+		used += fields[i].Size;
+	}
+	cli_emit_kv_int(cli, "padding", sizeof(cli_t) - used);
+	cli_emit_kv_int(cli, "total", sizeof(cli_t));
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	cli_emit_kv_int(cli, "pool", CLI_POOL_BLOCKS * CLI_POOL_BLOCK_SIZE);
+#endif
+	cli_emit_end_object(cli);
+#else
+	for (int i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+		cli_printf(cli, "%s=%u\r\n", fields[i].Name, fields[i].Size);
+		used += fields[i].Size;
+	}
+	cli_printf(cli, "padding=%u\r\ntotal=%u\r\n", (unsigned int)sizeof(cli_t) - used, (unsigned int)sizeof(cli_t));
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	cli_printf(cli, "pool=%u\r\n", CLI_POOL_BLOCKS * CLI_POOL_BLOCK_SIZE);
+#endif
+#endif
+	return CLI_OK;
+}
+
 /*---------------------------------------------------------------------------*/
 /**
-* @brief	Function for processing the Escape key.
-* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-*
-*/
-static int cli_key_handler_esc(cli_t *cli) {
-	char symbol = 0 ;
-	do {
-		symbol = (char)cli->_io_getchar();
-	} while (!symbol);
-	if (symbol == Key_CONTROL) {
-		char symbol = 0;
-		do {
-			symbol = (char)cli->_io_getchar();
-		} while(!symbol);
-
-		switch (symbol) {
-		case Key_A:
-			/* Arrow Up */
-			return cli_key_handler_print_element(cli, -1);
-		case Key_B:
-			/* Arrow Down */
-			return cli_key_handler_print_element(cli, 1);
-		case Key_D:
-			/* Arrow Left */
-			return cli_key_handler_set_point(cli, -1);
-		case Key_C:
-			/* Arrow Rigth */
-			return cli_key_handler_set_point(cli, 1);
-		case Key_3:
-			char s = 0;
-			do {
-				s = (char) cli->_io_getchar();
-			} while (!s);
-			if (s == Key_Tilda) {
-				/* Key Delete */
-				return cli_key_handler_control_delete(cli);
+* @brief	Function for processing the Tab key.
+* @note 	The candidates are the commands of the group or, after the
+*       	command with the function `Complete`, its arguments. Their
+*       	common part is put in the line; if there is nothing to add, they
+*       	are printed in columns. They stay for the next Tab.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_tab(cli_t *cli, int key) {
+	/* Walk the tree over the finished words before the cursor */
+	const cli_command_t *group = NULL;
+	const cli_command_t *command = NULL;
+#if (CLI_ENABLE_COMPLETION == TRUE)
+	int first = 0;
+#endif
+	int start = 0;
+	for (int i = 0; i < cli->Point; i++) {
+#if (CLI_ENABLE_COMMAND_LISTS == TRUE)
+		if (cli->Buffer[i] == ';') {
+			/* Next command of the list */
+			group = NULL;
+			command = NULL;
+			start = i + 1;
+			continue;
+		}
+#endif
+		if (cli->Buffer[i] != Key_SPACE) continue;
+		if ((i > start) && (command == NULL)) {
+			command = cli_command_find(cli, group, &cli->Buffer[start], i - start);
+			if (command == NULL) {
+				return CLI_OK;
 			}
-		default:
-			break;
+			if (command->Children != NULL) {
+				group = command;
+				command = NULL;
+			}
+#if (CLI_ENABLE_COMPLETION == TRUE)
+			else if (command->Complete != NULL) {
+				/* The next words are the arguments of the command */
+				first = start;
+			}
+#endif
+			else {
+				/* Arguments of the command are not completed */
+				return CLI_OK;
+			}
+		}
+		start = i + 1;
+	}
+
+	/* The word under the cursor is the prefix of the candidates */
+#if (CLI_ENABLE_COMPLETION == TRUE)
+	cli_complete_t *complete = cli_complete_make(cli, group, command, first, start);
+	return (complete != NULL) ? cli_complete_apply(cli, complete) : CLI_OK;
+#else
+	/* The names are made for each Tab and given back at once */
+	size_t mark = cli->Scratch.Top;
+	cli_complete_t complete;
+	int status = CLI_OK;
+	if (cli_complete_start(cli, &complete, start) == CLI_OK) {
+		cli_complete_level(cli, &complete, group);
+		cli_scratch_alloc(cli, complete.Length);
+		status = cli_complete_apply(cli, &complete);
+	}
+	cli->Scratch.Top = mark;
+	return status;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Put the common part of the candidates in the line, or print
+*       	them if there is nothing to add.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	complete The candidates.
+*
+*/
+static int cli_complete_apply(cli_t *cli, const cli_complete_t *complete) {
+	const char *name;
+	size_t common;
+	int count = cli_complete_common(complete, &name, &common);
+	/* If there are no matches, exit */
+	if (count == 0) return CLI_OK;
+
+	size_t length = complete->PrefixLength;
+	if ((count > 1) && (common == length)) {
+		/* Nothing to add: write all possible candidates, the listing is
+		 * made in the rest of the scratch arena */
+		size_t mark = cli->Scratch.Top;
+		char local[32];
+		size_t size = cli_scratch_rest(cli);
+		char *buffer = (size > sizeof(local)) ? cli_scratch_alloc(cli, size) : NULL;
+		if (buffer == NULL) {
+			buffer = local;
+			size = sizeof(local);
+		}
+		cli_complete_print(cli, complete, buffer, size);
+		cli->Scratch.Top = mark;
+		cli_print_line(cli);
+		return CLI_OK;
+	}
+	int add = (int)(common - length);
+	/* The only candidate is finished, unless it is a directory which goes on */
+	int space = (count == 1) && !(complete->Separator && common && (name[common - 1] == complete->Separator));
+	/* The candidates stay in the arena: the added text is put after them */
+	size_t mark = cli->Scratch.Top;
+	char *text = cli_scratch_alloc(cli, add + space);
+	int status;
+	if (text == NULL) {
+		status = cli_key_handler_insert(cli, &name[length], add);
+		if (space) {
+			status = cli_key_handler_insert(cli, " ", 1);
+		}
+	} else {
+		memcpy(text, &name[length], add);
+		if (space) {
+			text[add] = Key_SPACE;
+		}
+		status = cli_key_handler_insert(cli, text, add + space);
+	}
+	cli->Scratch.Top = mark;
+	return status;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Start the empty candidates for the word under the cursor in the
+*       	rest of the scratch arena. The arena is not taken.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	complete The candidates.
+* @param	start Start of the word under the cursor.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no room.
+*/
+static int cli_complete_start(cli_t *cli, cli_complete_t *complete, int start) {
+	complete->Data = cli_scratch_alloc(cli, 0);
+	if (complete->Data == NULL) {
+		return CLI_ERROR;
+	}
+	complete->Size = cli_scratch_rest(cli);
+	complete->Length = 0;
+	complete->Count = 0;
+	complete->Prefix = &cli->Buffer[start];
+	complete->PrefixLength = cli->Point - start;
+	complete->Separator = 0;
+	complete->Full = 0;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add the names of the commands of the group to the candidates.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	complete The candidates.
+* @param	group The group, or NULL for the top level and the aliases.
+*
+*/
+static void cli_complete_level(cli_t *cli, cli_complete_t *complete, const cli_command_t *group) {
+	int count = cli_command_level(cli, group);
+	int total = count;
+#if (CLI_ENABLE_ALIASES == TRUE)
+	if (group == NULL) {
+		total += CLI_ALIAS_COUNT;
+	}
+#endif
+	for (int i = 0; i < total; i++) {
+		const char *name = cli_complete_name(cli, group, count, i);
+		if ((name != NULL) && (cli_complete_add(complete, name) != CLI_OK)) break;
+	}
+}
+
+#if (CLI_ENABLE_COMPLETION == TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the candidates for the word under the cursor: the kept ones
+*       	or the new ones.
+* @note 	The new candidates take the rest of the scratch arena and stay
+*       	there until a key other than Tab. The kept ones are good while
+*       	the word starts at the same place and its part up to the last
+*       	separator stays: Tab only adds to it.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	group The group, or NULL for the top level.
+* @param	command The command whose argument is completed, or NULL.
+* @param	first Start of the name of the command in the line.
+* @param	start Start of the word under the cursor.
+* @return	`cli_complete_t*` The candidates or NULL if there is no room.
+*/
+static cli_complete_t *cli_complete_make(cli_t *cli, const cli_command_t *group, const cli_command_t *command, int first, int start) {
+	cli_completion_t *completion = &cli->Completion;
+	cli_complete_t *complete = &completion->Set;
+	const char *prefix = &cli->Buffer[start];
+	size_t length = cli->Point - start;
+	if ((complete->Data != NULL) && (completion->Start == start)) {
+		complete->Prefix = prefix;
+		complete->PrefixLength = length;
+		if (cli_complete_depends(complete) == completion->Depends) {
+			return complete;
+		}
+	}
+	cli_complete_drop(cli);
+	completion->Base = cli->Scratch.Top;
+	if (command == NULL) {
+		if (cli_complete_start(cli, complete, start) != CLI_OK) {
+			return NULL;
 		}
+		cli_complete_level(cli, complete, group);
+	} else {
+		/* The words from the name of the command, then the word under the cursor */
+		size_t size = start - first;
+		char *line = cli_scratch_alloc(cli, size + length + 2);
+		int max = cli_scratch_rest(cli) / sizeof(char*);
+		if ((line == NULL) || (max < 3)) {
+			cli->Scratch.Top = completion->Base;
+			return NULL;
+		}
+		memcpy(line, &cli->Buffer[first], size);
+		line[size] = 0;
+		char *word = &line[size + 1];
+		memcpy(word, prefix, length);
+		word[length] = 0;
+		char *next;
+		char **argv = cli_scratch_alloc(cli, 0);
+		int argc = cli_tokenize(line, argv, max - 2, &next);
+		argv[argc++] = word;
+		argv[argc] = NULL;
+		cli_scratch_alloc(cli, (argc + 1) * sizeof(char*));
+		if (cli_complete_start(cli, complete, start) != CLI_OK) {
+			cli->Scratch.Top = completion->Base;
+			return NULL;
+		}
+		command->Complete(cli, argc, argv, complete);
+	}
+	/* The names are kept: the arena is taken up to their end */
+	cli_scratch_alloc(cli, complete->Length);
+	completion->Start = start;
+	completion->Depends = cli_complete_depends(complete);
+	completion->Made++;
+	return complete;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Forget the candidates of the last Tab and give their memory
+*       	back to the scratch arena.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+static void cli_complete_drop(cli_t *cli) {
+	if (cli->Completion.Set.Data != NULL) {
+		cli->Scratch.Top = cli->Completion.Base;
+		cli->Completion.Set.Data = NULL;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Completion function of the path of a command: `help group sub`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of the words, the last one is under the cursor.
+* @param 	argv[] Array of the words, the first one is the name of the
+*       	command which takes the path.
+* @param	complete The candidates.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_complete_commands(cli_t *cli, int argc, char *argv[], cli_complete_t *complete) {
+	const cli_command_t *group = cli_command_path(cli, argc - 2, &argv[1]);
+	if ((argc > 2) && ((group == NULL) || (group->Children == NULL))) {
+		return CLI_OK;
 	}
+	int count = cli_command_level(cli, group);
+	for (int index = 0; index < count; index++) {
+		const cli_command_t *command = cli_command_at(cli, group, index);
+		if ((command != NULL) && (cli_complete_add(complete, command->Name) != CLI_OK)) break;
+	}
+	return CLI_OK;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Name of the candidate for the completion: the commands of the
+*       	level, then (at the top level) the aliases.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	group The group, or NULL for the top level.
+* @param	count Number of places in the level.
+* @param	index Index of the candidate.
+* @return	`const char*` The name or NULL if the place is free.
+*/
+static const char *cli_complete_name(cli_t *cli, const cli_command_t *group, int count, int index) {
+	if (index < count) {
+		const cli_command_t *command = cli_command_at(cli, group, index);
+		return (command != NULL) ? command->Name : NULL;
+	}
+#if (CLI_ENABLE_ALIASES == TRUE)
+	const char *name = cli->Aliases[index - count].Text;
+	return name[0] ? name : NULL;
+#else
+	return NULL;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Function for processing the Escape key: start of the sequence.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_esc(cli_t *cli, int key) {
+	cli->Escape = 1;
 	return CLI_OK;
 }
 
@@ -512,14 +2776,188 @@ static int cli_key_handler_esc(cli_t *cli) {
 */
 static int cli_history_add(cli_t *cli) {
 	if (strcmp(cli->History[cli_utils_abs(cli->HistoryNewPoint - 1)].Command, cli->Buffer)) {
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+		/* Make room in the pool: the oldest commands go first */
+		int size = strlen(cli->Buffer) + 1;
+		char *command;
+		int oldest = cli_utils_abs(cli->HistoryNewPoint + 1);
+		while (((command = cli_pool_alloc(size)) == NULL) && (oldest != cli->HistoryNewPoint)) {
+			if (cli->History[oldest].Command[0]) {
+				cli_history_drop(cli, oldest);
+			}
+			oldest = cli_utils_abs(oldest + 1);
+		}
+		if (command == NULL) {
+			cli->HistoryPoint = cli->HistoryNewPoint;
+			return CLI_ERROR;
+		}
+		strcpy(command, cli->Buffer);
+		cli->History[cli->HistoryNewPoint].Command = command;
+#else
 		strcpy(cli->History[cli->HistoryNewPoint].Command, cli->Buffer);
+#endif
+#if (CLI_ENABLE_SUGGEST == TRUE)
+		/* Keep the slots sorted by the text */
+		int position = cli_history_index_find(cli, cli->Buffer);
+		memmove(&cli->HistoryIndex[position + 1], &cli->HistoryIndex[position], cli->HistoryCount - position);
+		cli->HistoryIndex[position] = cli->HistoryNewPoint;
+		cli->HistoryCount++;
+#endif
 		cli->HistoryNewPoint = cli_utils_abs(++(cli->HistoryNewPoint));
-		cli->History[cli->HistoryNewPoint].Command[0] = 0;
+		if (cli->History[cli->HistoryNewPoint].Command[0]) {
+			/* The oldest command is dropped */
+			cli_history_drop(cli, cli->HistoryNewPoint);
+		}
 	}
 	cli->HistoryPoint = cli->HistoryNewPoint;
 	return CLI_OK;
 }
 
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the command from the history.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	slot Slot of the history.
+*
+*/
+static void cli_history_drop(cli_t *cli, int slot) {
+#if (CLI_ENABLE_SUGGEST == TRUE)
+	int position = 0;
+	while (cli->HistoryIndex[position] != slot) position++;
+	memmove(&cli->HistoryIndex[position], &cli->HistoryIndex[position + 1], cli->HistoryCount - position - 1);
+	cli->HistoryCount--;
+#endif
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	char *command = cli->History[slot].Command;
+	cli_pool_free(command, strlen(command) + 1);
+	cli->History[slot].Command = (char*)cli_history_empty;
+#else
+	cli->History[slot].Command[0] = 0;
+#endif
+}
+
+#if (CLI_ENABLE_SUGGEST == TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the first command in the history index that is not less
+*       	than the text (binary search).
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	text The text.
+* @return	`int` Position in the index.
+*/
+static int cli_history_index_find(cli_t *cli, const char *text) {
+	int low = 0;
+	int high = cli->HistoryCount;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (strcmp(cli->History[cli->HistoryIndex[middle]].Command, text) < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the latest command of the history that continues the text.
+* @note 	The commands that start with the text lie together in the index.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	text The text.
+* @param	length Length of the text.
+* @return	`int` Slot of the history, (-1) if there is no such command.
+*/
+static int cli_history_suggest(cli_t *cli, const char *text, int length) {
+	int found = -1;
+	int found_age = CLI_SIZE_HISTORY;
+	for (int position = cli_history_index_find(cli, text); position < cli->HistoryCount; position++) {
+		int slot = cli->HistoryIndex[position];
+		const char *command = cli->History[slot].Command;
+		if (strncmp(command, text, length)) break;
+		/* The age: (1) for the latest command */
+		int age = cli_utils_abs(cli->HistoryNewPoint - slot);
+		if (command[length] && (age < found_age)) {
+			found = slot;
+			found_age = age;
+		}
+	}
+	return found;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the suggestion from the screen.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+static void cli_suggest_erase(cli_t *cli) {
+	cli_printf(cli, CONSOLE_CLEAR_STRING);
+	cli->Suggestion = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Show the rest of the latest command that continues the line,
+*       	faded, after the cursor at the end of the line.
+* @note 	Nothing is sent while the same suggestion is on the screen.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+static void cli_suggest_show(cli_t *cli) {
+	if (cli->Escape) {
+		/* The key is not complete yet */
+		return;
+	}
+	int length = strlen(cli->Buffer);
+	int slot = -1;
+	if (length && (cli->Point == length)) {
+		slot = cli_history_suggest(cli, cli->Buffer, length);
+	}
+	if (slot + 1 == cli->Suggestion) {
+		return;
+	}
+	if (cli->Suggestion) {
+		cli_suggest_erase(cli);
+	}
+	if (slot >= 0) {
+		const char *rest = &cli->History[slot].Command[length];
+		cli_printf(cli, "%s%s%s\033[%dD", CONSOLE_FADED, rest, CONSOLE_NORMAL, (int)strlen(rest));
+		cli->Suggestion = slot + 1;
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the suggestion into the line (Right or End).
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_accept(cli_t *cli, int key) {
+	const char *command = cli->History[cli->Suggestion - 1].Command;
+	int length = strlen(cli->Buffer);
+	/* The symbols are drawn over the faded ones */
+	cli->Suggestion = 0;
+	return cli_key_handler_insert(cli, &command[length], strlen(command) - length);
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Handlers of the history keys.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key code.
+*
+*/
+static int cli_key_handler_up(cli_t *cli, int key) {
+	return cli_key_handler_print_element(cli, -1);
+}
+
+static int cli_key_handler_down(cli_t *cli, int key) {
+	return cli_key_handler_print_element(cli, 1);
+}
+
 /*---------------------------------------------------------------------------*/
 /**
 * @brief	Print element from history command.
@@ -531,8 +2969,11 @@ static int cli_key_handler_print_element(cli_t *cli, int inc) {
 	int temp = cli_utils_abs(cli->HistoryPoint + inc);
 	if (cli->History[temp].Command[0] != 0) {
 		cli->HistoryPoint = temp;
-		cli->Point = strlen(cli->History[cli->HistoryPoint].Command);
-		memcpy(cli->Buffer, cli->History[cli->HistoryPoint].Command, sizeof(cli->Buffer));
+		const char *command = cli->History[cli->HistoryPoint].Command;
+		int size = cli_line_reserve(cli, strlen(command) + 1);
+		memset(cli->Buffer, 0, size);
+		strncpy(cli->Buffer, command, size - 1);
+		cli->Point = strlen(cli->Buffer);
 		cli_print_line(cli);
 	}
 	return CLI_OK;
@@ -556,42 +2997,3 @@ static int cli_utils_abs(int id) {
 	return id;
 }
 
-/*---------------------------------------------------------------------------*/
-/**
-* @brief	Function to set the cursor pointer in the console.
-* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-* @param	inc An incrimination regarding an already active Point.
-*
-*/
-static int cli_key_handler_set_point(cli_t *cli, int inc) {
-	if (inc > 0) {
-		/* inc Arrow Rigth */
-		if (cli->Buffer[cli->Point]) {
-			cli->Point++;
-			cli_printf(cli, "%c%c%c", Key_ESC, Key_CONTROL, Key_C);
-		}
-	} else {
-		/* inc Arrow Left */
-		if (cli->Point) {
-			cli->Point--;
-			cli_printf(cli, "%c%c%c", Key_ESC, Key_CONTROL, Key_D);
-		}
-	}
-	return CLI_OK;
-}
-
-/*---------------------------------------------------------------------------*/
-/**
-* @brief	The handler removes the character on the Right.
-* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
-*
-*/
-static int cli_key_handler_control_delete(cli_t *cli) {
-	if (cli->Point) {
-		for (int i = cli->Point; i < strlen(cli->Buffer); i++) {
-			cli->Buffer[i] = cli->Buffer[i + 1];
-		}
-	}
-	cli_print_line(cli);
-	return CLI_OK;
-}
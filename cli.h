@@ -34,12 +34,41 @@ SOFTWARE.
 #define CLI_H_
 
 /* Includes ---------------------------------------------------------------- */
-#include <stdio.h>   /* For 'vsniprintf' and BUFSIZ */
+#include <stdio.h>   /* For 'vsnprintf' and BUFSIZ */
 #include <string.h>  /* For 'strlen' */
 #include <stdarg.h>  /* For 'va_list' */
+#include <stdint.h>  /* For 'uint8_t' */
 
 #include "opt.h"
 #include "console.h"
+#include "complete.h"
+#if (CLI_USE_RING_BUFFER == TRUE)
+#include "ring.h"
+#endif
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+#include "pool.h"
+#endif
+#if (CLI_ENABLE_LOG == TRUE)
+#include "logger.h"
+#endif
+#if (CLI_ENABLE_VARIABLES == TRUE)
+#include "variable.h"
+#endif
+#if (CLI_ENABLE_ALIASES == TRUE)
+#include "alias.h"
+#endif
+#if (CLI_ENABLE_EMIT == TRUE)
+#include "emit.h"
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+#include "trace.h"
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+#include "screen.h"
+#endif
+#if (CLI_ENABLE_PLUGINS == TRUE)
+#include "plugin.h"
+#endif
 /*---------------------------------------------------------------------------*/
 
 
@@ -51,6 +80,49 @@ SOFTWARE.
 
 
 /* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Types of the positions in the line and in the history, of the
+ *      	small counters and flags of the instance
+ */
+#if (CLI_COMPACT == TRUE)
+#if (CLI_BUFFER_SIZE < 256)
+typedef uint8_t cli_point_t;
+#else
+typedef uint16_t cli_point_t;
+#endif
+#if (CLI_SIZE_HISTORY < 256)
+typedef uint8_t cli_history_point_t;
+#else
+typedef uint16_t cli_history_point_t;
+#endif
+typedef uint8_t cli_small_t;
+#else
+typedef int cli_point_t;
+typedef int cli_history_point_t;
+typedef int cli_small_t;
+#endif
+
+/*
+ * @brief	Traffic of the terminal, to see what the line editor costs
+ */
+typedef struct {
+	unsigned int RxBytes;                          // Bytes received by the line editor and commands
+	unsigned int TxBytes;                          // Bytes sent to the terminal
+	unsigned int TxSequences;                      // Escape sequences sent to the terminal
+	unsigned int Commands;                         // Commands run
+} cli_stats_t;
+
+/*
+ * @brief	Scratch arena of the running command: taken from the top,
+ *      	given back at once when the command returns
+ */
+typedef struct {
+	size_t Top;                                    // Bytes in use
+	size_t Peak;                                   // Most bytes ever in use
+	unsigned int Failed;                           // Requests that did not fit
+	uint8_t Data[CLI_SCRATCH_SIZE] __attribute__((aligned(sizeof(void*))));
+} cli_scratch_t;
+
 /*
  * @brief	CLI handle Structure definition
  */
@@ -59,31 +131,170 @@ typedef struct cli_instance cli_t;
 /*
  * @brief	Defining Options and Running Commands
  */
-typedef struct {
+typedef struct cli_command {
 	const char *Name;                      // Name function
 	int (*Function)(cli_t *cli, int argc, char* argv[]); // Pointer to the implementation
 	const char *Help;                      // Help information
+	int Flags;                             // Options 'CLI_COMMAND_...'
+	const struct cli_command *Children;    // Subcommands, the table ends with Name == NULL
+#if (CLI_ENABLE_COMPLETION == TRUE)
+	cli_complete_function_t Complete;      // Candidates of the arguments for Tab, NULL - none
+#endif
 } cli_command_t;
 
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+/* States of the pager: the prompt and its erasure are sent by 'cli_tx_pop' */
+enum {
+	CLI_PAGE_FLOW = 0,                     // The output goes on
+	CLI_PAGE_PROMPT,                       // The page is full, the prompt is sent
+	CLI_PAGE_WAIT,                         // The output waits for the key of the operator
+	CLI_PAGE_ERASE                         // The prompt is erased, then the output goes on
+};
+
+/* Binary data on the port ('cli_raw') */
+#define CLI_RAW_RX                 (1U << 0)   // XON and XOFF are data
+#define CLI_RAW_TX                 (1U << 1)   // The output is not paged
+#endif
+
+/* Command options */
+/* Run the command in a worker thread ('CLI_ENABLE_WORKERS'). The command must
+ * not call 'cli_exec' and must be safe to run along with the main loop. */
+#define CLI_COMMAND_OFFLOAD        (1U << 0)
+
 /*
  * @brief	Defining a Command List
  */
 typedef struct {
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	char *Command;                     // Command line in the pool, "" - free place
+#else
 	char Command[CLI_BUFFER_SIZE];     // Name function
+#endif
 } cli_command_history_t;
 
+/*
+ * @brief	Receiver of the command output for `cli_exec`
+ */
+typedef struct {
+	char  *Data;                                   // Output buffer
+	size_t Size;                                   // Size of the output buffer
+	size_t Length;                                 // Number of bytes written
+	int  (*Sink)(void *context, const char *data, int length); // Optional output function instead of buffer
+	void  *Context;                                // Argument for 'Sink'
+} cli_capture_t;
+
+/*
+ * @brief	Action of the key for `cli_bind`
+ */
+typedef int (*cli_key_function_t)(cli_t *cli, int key);
+
+/*
+ * @brief	Key bound by the application
+ */
+typedef struct {
+	int Key;                                       // Byte or 'CLI_KEY_...'
+	cli_key_function_t Function;                   // Action of the key
+	const char *Command;                           // Command line for 'cli_bind_command'
+} cli_binding_t;
+
 /*
  * @brief	CLI handle Structure definition
  */
 struct cli_instance {
 	int (*_io_putchar)(int ch);                      // Function transmit char
 	int (*_io_getchar)(void);                        // Function receiver char
+	int (*_io_wait)(int timeout);                    // Function sleep until there is work
+	int (*_io_wakeup)(void);                         // Function wake up the sleeping CLI
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	char *Buffer;                                    // Receive buffer: 'Inline' or blocks of the pool
+	cli_point_t BufferSize;                          // Size of the receive buffer
+	char Inline[CLI_LINE_INLINE];                    // Receive buffer for the short lines
+#else
 	char Buffer[CLI_BUFFER_SIZE];                    // Receive buffer
-	int  Point;                                      // Cursor/pointer in Receive Buffer
+#endif
+	cli_point_t Point;                               // Cursor/pointer in Receive Buffer
+#if (CLI_COMPACT == TRUE)
+	const cli_command_t *Commands[CLI_MAX_COUNT_COMMAND]; // All list command for shell: constant descriptors
+#else
 	cli_command_t Commands[CLI_MAX_COUNT_COMMAND];   // All list command for shell
+#endif
 	cli_command_history_t History[CLI_SIZE_HISTORY]; // List history command
-	int  HistoryPoint;                               // Cursor/pointer history command
-	int  HistoryNewPoint;                            // Cursor/pointer new history command
+	cli_history_point_t HistoryPoint;                // Cursor/pointer history command
+	cli_history_point_t HistoryNewPoint;             // Cursor/pointer new history command
+#if (CLI_ENABLE_SUGGEST == TRUE)
+	uint8_t HistoryIndex[CLI_SIZE_HISTORY];          // Slots of the history sorted by the text
+	uint8_t HistoryCount;                            // Number of the commands in the history
+	cli_history_point_t Suggestion;                  // Slot of the suggestion on the screen + 1, 0 - none
+#endif
+	cli_capture_t *Capture;                          // Output redirection for 'cli_exec'
+	cli_small_t Idle;                                // The last call of handler received nothing
+	cli_small_t Escape;                              // Escape sequence is received: length + 1
+	char Sequence[8];                                // Received part of the escape sequence
+#if (CLI_KEY_BINDINGS > 0)
+	cli_binding_t Bindings[CLI_KEY_BINDINGS];        // Keys bound by the application
+	cli_small_t BindingCount;                        // Number of the bound keys
+#endif
+	cli_scratch_t Scratch;                           // Memory of the running command
+#if (CLI_ENABLE_COMPLETION == TRUE)
+	cli_completion_t Completion;                     // Candidates of the last Tab
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+	cli_stats_t Stats;                               // Traffic of the terminal
+#endif
+#if (CLI_USE_RING_BUFFER != TRUE)
+	cli_small_t Pending;                             // Symbol received ahead of time, for the next call
+#endif
+#if (CLI_ENABLE_WORKERS == TRUE)
+	int  Waiting;                                    // Id of the job the instance waits for
+	int  Streaming;                                  // The line is erased for the output of the jobs
+#endif
+#if (CLI_USE_RING_BUFFER == TRUE)
+	int (*_io_txstart)(void);                        // Function start transmit of the TX ring
+	cli_ring_t Rx;                                   // Receive ring (filled by interrupt)
+	cli_ring_t Tx;                                   // Transmit ring (emptied by interrupt)
+	uint8_t RxData[CLI_RX_RING_SIZE];                // Storage of the receive ring
+	uint8_t TxData[CLI_TX_RING_SIZE];                // Storage of the transmit ring
+	unsigned int RxDropped;                          // Bytes lost because the receive ring was full
+	unsigned int TxStalled;                          // Waits for a free place in the transmit ring
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	volatile uint8_t TxXoff;                         // XOFF is received: the output waits for XON
+	volatile uint8_t TxHeld;                         // The port stopped the output: the far end does not read
+	volatile uint8_t Page;                           // State of the pager 'CLI_PAGE_...'
+	uint8_t PageSent;                                // Bytes of the prompt or its erasure sent
+	uint8_t Pager;                                   // The output is paged: 'more on'
+	uint8_t Discard;                                 // The rest of the output of the command is dropped
+	uint8_t Raw;                                     // Binary data on the port 'CLI_RAW_...'
+	int  PageLines;                                  // Lines sent in this page
+	unsigned int PageAhead;                          // Keys received before the page was full
+	unsigned int PageStart;                          // New pages asked by the commands
+	unsigned int PageSeen;                           // New pages taken by 'cli_tx_pop'
+	unsigned int TxDropped;                          // Bytes dropped by the pager or the flow timeout
+#endif
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+	int  RxLeft;                                     // Bytes to take in this turn of 'cli_poll_all', -1 - no limit
+	int  TxLeft;                                     // Bytes to send in this turn of 'cli_poll_all', -1 - no limit
+#endif
+#if (CLI_ENABLE_LOG == TRUE)
+	cli_log_t Log;                                   // Queue of the asynchronous log records
+#endif
+#if (CLI_ENABLE_VARIABLES == TRUE)
+	cli_variables_t Variables;                       // Session variables
+#endif
+#if (CLI_ENABLE_ALIASES == TRUE)
+	cli_alias_t Aliases[CLI_ALIAS_COUNT];            // Aliases of the command lists
+	unsigned int Generation;                         // Number of changes of the commands and aliases
+	int  AliasDepth;                                 // Depth of the running aliases
+#endif
+#if (CLI_ENABLE_EMIT == TRUE)
+	cli_emit_t Emit;                                 // Output format and open levels of the emitter
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+	cli_trace_t Trace;                               // Received and sent bytes and the commands
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+	cli_screen_t *Screen;                            // Live screen of the command, NULL - the line editor
+#endif
 };
 
 /*
@@ -108,8 +319,141 @@ extern int __cli_print_hello(cli_t *cli) __attribute__((weak));
 
 int cli_init(cli_t *cli);
 int cli_printf(cli_t *cli, const char* format, ...);
+int cli_vsnprintf(char *buffer, size_t size, const char *format, va_list args);
+int cli_write(cli_t *cli, const char *data, int length);
+int cli_read(cli_t *cli, uint8_t *data, int length);
+int cli_add_command(cli_t *cli, const cli_command_t *command);
 int cli_add(cli_t *cli, const char *name, int (*function)(cli_t *cli, int argc, char* argv[]), const char *help);
+int cli_add_group(cli_t *cli, const char *name, const cli_command_t *children, const char *help);
+#if (CLI_ENABLE_COMPLETION == TRUE)
+int cli_add_complete(cli_t *cli, const char *name, int (*function)(cli_t *cli, int argc, char* argv[]), const char *help, cli_complete_function_t complete);
+#else
+/* Without the completion of the arguments the function is not kept */
+#define cli_add_complete(cli, name, function, help, complete) cli_add((cli), (name), (function), (help))
+#endif
+/* The same with the descriptor put in the constant data, not copied to the
+ * instance (or to the pool of 'CLI_COMPACT'): the name, the function and the
+ * help must be constants. One call site is one descriptor. */
+#define CLI_DESCRIPTOR_ADD(cli, ...) __extension__({ \
+	static const cli_command_t _cli_command = {__VA_ARGS__}; \
+	cli_add_command((cli), &_cli_command); })
+#define CLI_COMMAND_DEFINE(cli, name, function, help) CLI_DESCRIPTOR_ADD((cli), (name), (function), (help))
+#define CLI_GROUP_DEFINE(cli, name, children, help) CLI_DESCRIPTOR_ADD((cli), (name), NULL, (help), 0, (children))
+#if (CLI_ENABLE_COMPLETION == TRUE)
+#define CLI_COMPLETE_DEFINE(cli, name, function, help, complete) \
+	CLI_DESCRIPTOR_ADD((cli), (name), (function), (help), 0, NULL, (complete))
+#else
+#define CLI_COMPLETE_DEFINE(cli, name, function, help, complete) CLI_COMMAND_DEFINE((cli), (name), (function), (help))
+#endif
 int cli_handler(cli_t *cli);
+int cli_pending(cli_t *cli);
+int cli_wait(cli_t *cli, int timeout);
+int cli_exec(cli_t *cli, const char *line, char *out, size_t outlen);
+int cli_exec_capture(cli_t *cli, const char *line, cli_capture_t *capture);
+#if (CLI_KEY_BINDINGS > 0)
+int cli_bind(cli_t *cli, int key, cli_key_function_t function);
+int cli_bind_command(cli_t *cli, int key, const char *line);
+#endif
+void *cli_scratch_alloc(cli_t *cli, size_t size);
+char *cli_scratch_join(cli_t *cli, int argc, char *argv[]);
+int cli_sizeof_report(cli_t *cli);
+int cli_complete_add(cli_complete_t *complete, const char *name);
+#if (CLI_ENABLE_COMPLETION == TRUE)
+int cli_complete_commands(cli_t *cli, int argc, char *argv[], cli_complete_t *complete);
+#endif
+#if (CLI_COMPLETION_FILES == TRUE)
+int cli_complete_files(cli_t *cli, int argc, char *argv[], cli_complete_t *complete);
+#endif
+
+#if (CLI_USE_RING_BUFFER == TRUE)
+int cli_rx_push(cli_t *cli, const uint8_t *data, int length);
+int cli_tx_pop(cli_t *cli, uint8_t *data, int length);
+#endif
+
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+int cli_tx_hold(cli_t *cli, int hold);
+int cli_raw(cli_t *cli, int mode);
+int cli_tx_room(cli_t *cli);
+#endif
+
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+int cli_register(cli_t *cli);
+int cli_unregister(cli_t *cli);
+int cli_poll_all(void);
+#endif
+
+#if (CLI_ENABLE_LOG == TRUE)
+int cli_log(cli_t *cli, const char *format, ...);
+#endif
+
+#if (CLI_ENABLE_VARIABLES == TRUE)
+int cli_setenv(cli_t *cli, const char *name, const char *value);
+int cli_unsetenv(cli_t *cli, const char *name);
+const char *cli_getenv(cli_t *cli, const char *name);
+#endif
+
+#if (CLI_ENABLE_EMIT == TRUE)
+int cli_emit_set_format(cli_t *cli, cli_format_t format);
+cli_format_t cli_emit_format(cli_t *cli);
+int cli_emit_begin_object(cli_t *cli, const char *key);
+int cli_emit_end_object(cli_t *cli);
+int cli_emit_begin_array(cli_t *cli, const char *key, int first);
+int cli_emit_end_array(cli_t *cli);
+int cli_emit_kv_int(cli_t *cli, const char *key, int64_t value);
+int cli_emit_kv_hex(cli_t *cli, const char *key, uint32_t value, int digits);
+int cli_emit_kv_str(cli_t *cli, const char *key, const char *value);
+int cli_emit_kv_bool(cli_t *cli, const char *key, int value);
+int cli_emit_array(cli_t *cli, const char *key, const int32_t *values, int count);
+#endif
+
+#if (CLI_ENABLE_SCREEN == TRUE)
+cli_screen_t *cli_screen_open(cli_t *cli, int period, cli_screen_refresh_t refresh);
+int cli_screen_close(cli_t *cli);
+void cli_screen_clear(cli_screen_t *screen);
+void cli_screen_attr(cli_screen_t *screen, uint8_t attr);
+void cli_screen_put(cli_screen_t *screen, int row, int col, char symbol);
+int cli_screen_text(cli_screen_t *screen, int row, int col, const char *text);
+int cli_screen_printf(cli_screen_t *screen, int row, int col, const char *format, ...);
+int cli_screen_commit(cli_t *cli);
+#endif
+
+#if (CLI_ENABLE_PLUGINS == TRUE)
+int cli_plugin_allocator(cli_plugin_realloc_t realloc_fn, cli_plugin_free_t free_fn);
+int cli_plugin_load(cli_t *cli, const char *path);
+int cli_plugin_unload(cli_t *cli, const char *name);
+int cli_plugin_lazy(const char *path, const char *name, const char *help);
+int cli_plugin_add(cli_plugin_t *plugin, const cli_command_t *command);
+int cli_plugin_list(cli_t *cli);
+#endif
+
+/* Internal functions */
+void cli_print_line(cli_t *cli);
+void cli_print_group(cli_t *cli, const cli_command_t *group);
+const cli_command_t *cli_command_path(cli_t *cli, int argc, char *argv[]);
+const cli_command_t *cli_command_walk(cli_t *cli, int argc, char *argv[], int *depth);
+int cli_tokenize(char *line, char *argv[], int max, char **next);
+#if (CLI_USE_RING_BUFFER == TRUE)
+void cli_tx_kick(cli_t *cli);
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+int cli_flow_rx(cli_t *cli, const uint8_t *data, int length);
+int cli_flow_pop(cli_t *cli, uint8_t *data, int length);
+int cli_flow_handler(cli_t *cli, int key);
+int cli_flow_wait(cli_t *cli);
+void cli_flow_start(cli_t *cli);
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+int cli_screen_timeout(cli_t *cli);
+int cli_screen_handler(cli_t *cli, int key);
+#endif
+#if (CLI_ENABLE_PLUGINS == TRUE)
+int cli_plugin_count(void);
+const cli_command_t *cli_plugin_at(int index);
+const cli_command_t *cli_plugin_find(const char *name, size_t length);
+unsigned int cli_plugin_generation(void);
+cli_plugin_t *cli_plugin_enter(const cli_command_t *command);
+void cli_plugin_leave(cli_plugin_t *plugin);
+#endif
 
 #if (CLI_ENABLE_DELETE_COMMAND == TRUE)
 int cli_remove_id(cli_t *cli, int index);
@@ -0,0 +1,258 @@
+/*
+*******************************************************************************
+@file	complete.c
+@brief	Candidates of the completion: the names of the commands and the arguments
+		given by the commands, kept between the presses of Tab.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+
+#if (CLI_COMPLETION_FILES == TRUE)
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+/*
+ * @brief	Output of the listing: sent when the buffer is full
+ */
+typedef struct {
+	cli_t *Cli;                            // Instance of the terminal
+	char *Data;                            // Buffer of the listing
+	size_t Size;                           // Size of the buffer
+	size_t Length;                         // Bytes in the buffer
+} cli_complete_out_t;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check that the name begins with the word under the cursor.
+* @param	complete The candidates.
+* @param	name The name.
+* @return	`int` (1) if the name is a candidate.
+*/
+static int cli_complete_match(const cli_complete_t *complete, const char *name) {
+	return !strncmp(name, complete->Prefix, complete->PrefixLength);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add the bytes to the listing.
+* @param	out Output of the listing.
+* @param	data The bytes.
+* @param	length Number of the bytes.
+*/
+static void cli_complete_emit(cli_complete_out_t *out, const char *data, size_t length) {
+	if (out->Length + length > out->Size) {
+		cli_write(out->Cli, out->Data, out->Length);
+		out->Length = 0;
+		if (length > out->Size) {
+			cli_write(out->Cli, data, length);
+			return;
+		}
+	}
+	memcpy(&out->Data[out->Length], data, length);
+	out->Length += length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add the candidate.
+* @note 	Called by the completion function of the command. The name is
+*       	copied; the names which do not begin with the word under the
+*       	cursor are skipped. The function must not take the scratch
+*       	arena: the candidates fill it.
+* @param	complete The candidates given to the completion function.
+* @param	name The name.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no room, the rest can be skipped.
+*/
+int cli_complete_add(cli_complete_t *complete, const char *name) {
+	if (!cli_complete_match(complete, name)) {
+		return CLI_OK;
+	}
+	size_t size = strlen(name) + 1;
+	if (complete->Length + size > complete->Size) {
+		complete->Full = 1;
+		return CLI_ERROR;
+	}
+	memcpy(&complete->Data[complete->Length], name, size);
+	complete->Length += size;
+	complete->Count++;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the part of the word under the cursor the candidates
+*       	depend on: up to its last separator.
+* @param	complete The candidates.
+* @return	`size_t` Length of the part, 0 - the candidates depend only on
+*       	the words before it.
+*/
+size_t cli_complete_depends(const cli_complete_t *complete) {
+	size_t length = complete->PrefixLength;
+	if (complete->Separator) {
+		while (length && (complete->Prefix[length - 1] != complete->Separator)) length--;
+	} else {
+		length = 0;
+	}
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the common part of the candidates.
+* @param	complete The candidates.
+* @param	first Returns the first candidate.
+* @param	common Returns the length of the part common to all of them.
+* @return	`int` Number of the candidates which begin with the word.
+*/
+int cli_complete_common(const cli_complete_t *complete, const char **first, size_t *common) {
+	int count = 0;
+	*first = NULL;
+	*common = 0;
+	for (const char *name = complete->Data; name < complete->Data + complete->Length; name += strlen(name) + 1) {
+		if (!cli_complete_match(complete, name)) continue;
+		if (*first == NULL) {
+			*first = name;
+			*common = strlen(name);
+		} else {
+			size_t j = complete->PrefixLength;
+			while ((j < *common) && ((*first)[j] == name[j])) j++;
+			*common = j;
+		}
+		count++;
+	}
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the candidates in columns with one write.
+* @note 	The names go along the rows, the columns are as wide as the
+*       	longest name and two spaces. The part the candidates depend on
+*       	(the directory) is not repeated. The listing is sent when the
+*       	buffer is full or at the end.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	complete The candidates.
+* @param	buffer Buffer of the listing.
+* @param	size Size of the buffer.
+* @return	`int` Number of the candidates printed.
+*/
+int cli_complete_print(cli_t *cli, const cli_complete_t *complete, char *buffer, size_t size) {
+	static const char spaces[] = "                ";
+	const char *end = complete->Data + complete->Length;
+	size_t skip = cli_complete_depends(complete);
+	size_t width = 0;
+	for (const char *name = complete->Data; name < end; name += strlen(name) + 1) {
+		size_t length = strlen(name) - skip;
+		if (cli_complete_match(complete, name) && (length > width)) {
+			width = length;
+		}
+	}
+	width += 2;
+	int columns = (width < CLI_COMPLETION_WIDTH) ? CLI_COMPLETION_WIDTH / width : 1;
+
+	cli_complete_out_t out = {cli, buffer, size, 0};
+	int count = 0;
+	size_t pad = 0;
+	cli_complete_emit(&out, "\r\n", 2);
+	for (const char *name = complete->Data; name < end; name += strlen(name) + 1) {
+		if (!cli_complete_match(complete, name)) continue;
+		if (count && !(count % columns)) {
+			cli_complete_emit(&out, "\r\n", 2);
+		} else {
+			/* The previous name is followed by the spaces up to this column */
+			while (pad) {
+				size_t part = (pad < sizeof(spaces) - 1) ? pad : sizeof(spaces) - 1;
+				cli_complete_emit(&out, spaces, part);
+				pad -= part;
+			}
+		}
+		size_t length = strlen(name) - skip;
+		cli_complete_emit(&out, name + skip, length);
+		pad = width - length;
+		count++;
+	}
+	if (complete->Full) {
+		cli_complete_emit(&out, "\r\n...", 5);
+	}
+	cli_complete_emit(&out, "\r\n", 2);
+	cli_write(cli, out.Data, out.Length);
+	return count;
+}
+
+#if (CLI_COMPLETION_FILES == TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Completion function of the file names.
+* @note 	The word is completed with the files of its directory, the
+*       	directories end with '/'. The hidden files are given when the
+*       	name begins with '.'. The directory is read again only when the
+*       	part of the word up to the last '/' changes.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of the words, the last one is under the cursor.
+* @param 	argv[] Array of the words.
+* @param	complete The candidates.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the directory cannot be read.
+*/
+int cli_complete_files(cli_t *cli, int argc, char *argv[], cli_complete_t *complete) {
+	const char *word = argv[argc - 1];
+	const char *slash = strrchr(word, '/');
+	size_t part = (slash != NULL) ? (size_t)(slash - word) + 1 : 0;
+	char path[CLI_BUFFER_SIZE + 256];
+	if (part + 1 > sizeof(path)) {
+		return CLI_ERROR;
+	}
+	memcpy(path, word, part);
+	path[part] = 0;
+	complete->Separator = '/';
+	DIR *dir = opendir(part ? path : ".");
+	if (dir == NULL) {
+		return CLI_ERROR;
+	}
+	struct dirent *entry;
+	while ((entry = readdir(dir)) != NULL) {
+		const char *name = entry->d_name;
+		if (!strcmp(name, ".") || !strcmp(name, "..") || ((name[0] == '.') && (word[part] != '.'))) continue;
+		/* Only the candidates are looked at, 'stat' takes the time */
+		if (strncmp(name, &word[part], strlen(&word[part]))) continue;
+		size_t length = strlen(name);
+		if (part + length + 2 > sizeof(path)) continue;
+		memcpy(&path[part], name, length + 1);
+		struct stat status;
+		if (!stat(path, &status) && S_ISDIR(status.st_mode)) {
+			path[part + length] = '/';
+			path[part + length + 1] = 0;
+		}
+		if (cli_complete_add(complete, path) != CLI_OK) break;
+	}
+	closedir(dir);
+	return CLI_OK;
+}
+#endif
@@ -0,0 +1,92 @@
+/*
+*******************************************************************************
+@file	complete.h
+@brief	Candidates of the completion: the names of the commands and the arguments
+		given by the commands, kept between the presses of Tab.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_COMPLETE_H_
+#define CLI_COMPLETE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stddef.h>  /* For 'size_t' */
+#include <stdint.h>  /* For 'uint8_t' */
+
+#include "opt.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ----------------------------------------------------------------- */
+struct cli_instance;
+
+/*
+ * @brief	Candidates of the completion
+ * @note	The names lie one after another in the scratch arena of the
+ *      	instance, each ended by zero. Only the names which begin with
+ *      	the word under the cursor are kept.
+ */
+typedef struct {
+	char *Data;                            // Names
+	size_t Length;                         // Bytes of the names
+	size_t Size;                           // Room for the names
+	int  Count;                            // Number of the names
+	const char *Prefix;                    // Word under the cursor (not ended by zero)
+	size_t PrefixLength;                   // Length of the word
+	char Separator;                        // The names depend on the word up to its last separator ('/'), 0 - not at all
+	uint8_t Full;                          // Some names did not fit
+} cli_complete_t;
+
+/*
+ * @brief	Candidates kept for the next press of Tab
+ * @note	They are taken again while only Tab is pressed, the word starts
+ *      	at the same place and its part up to the last separator stays.
+ */
+typedef struct {
+	cli_complete_t Set;                    // The candidates, 'Data' == NULL - none
+	size_t Base;                           // Top of the scratch arena under the candidates
+	int  Start;                            // Start of the word in the line
+	size_t Depends;                        // Bytes of the word up to the last separator
+	unsigned int Made;                     // Sets of the candidates made, not taken again
+} cli_completion_t;
+
+/*
+ * @brief	Completion of the arguments of the command: `argv[argc - 1]`
+ *      	is the word under the cursor, maybe empty
+ */
+typedef int (*cli_complete_function_t)(struct cli_instance *cli, int argc, char *argv[], cli_complete_t *complete);
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'complete.c'. */
+/* Function instances ------------------------------------------------------ */
+size_t cli_complete_depends(const cli_complete_t *complete);
+int cli_complete_common(const cli_complete_t *complete, const char **first, size_t *common);
+int cli_complete_print(struct cli_instance *cli, const cli_complete_t *complete, char *buffer, size_t size);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_COMPLETE_H_ */
@@ -39,6 +39,7 @@ SOFTWARE.
 #define CONSOLE_ITALIC           "\033[3m"
 #define CONSOLE_UNDERLINE        "\033[4m"
 #define CONSOLE_BLINK            "\033[5m"
+#define CONSOLE_REVERSE          "\033[7m"
 #define CONSOLE_DOUBLE_UNDERLINE "\033[9m"
 
 /* Set Console background color */
@@ -60,6 +61,11 @@ SOFTWARE.
 /* Cleaning  */
 #define CONSOLE_CLEAR_TERMINAL   "\033c"
 #define CONSOLE_CLEAR_STRING     "\033[K"
+#define CONSOLE_CLEAR_SCREEN     "\033[H\033[2J"
+
+/* Cursor */
+#define CONSOLE_CURSOR_HIDE      "\033[?25l"
+#define CONSOLE_CURSOR_SHOW      "\033[?25h"
 
 /** Input **/
 
@@ -117,6 +123,9 @@ enum keyboard {
 
 	Key_CR = 13,
 
+	Key_XON = 17,   /* Ctrl+Q: resume the output */
+	Key_XOFF = 19,  /* Ctrl+S: stop the output */
+
 	Key_ESC = 27,
 
 	Key_SPACE = 32,  /* ' ' */
@@ -134,4 +143,42 @@ enum keyboard {
 	Key_DEL = 127
 };
 
+/*
+*  @brief Key codes of the escape sequences. The codes below 'CLI_KEY_UP'
+*         are the received bytes.
+*/
+enum cli_key {
+	CLI_KEY_UP = 0x100,
+	CLI_KEY_DOWN,
+	CLI_KEY_RIGHT,
+	CLI_KEY_LEFT,
+	CLI_KEY_HOME,
+	CLI_KEY_END,
+	CLI_KEY_INSERT,
+	CLI_KEY_DELETE,
+	CLI_KEY_PAGE_UP,
+	CLI_KEY_PAGE_DOWN,
+	CLI_KEY_CTRL_RIGHT,
+	CLI_KEY_CTRL_LEFT,
+	CLI_KEY_F1,
+	CLI_KEY_F2,
+	CLI_KEY_F3,
+	CLI_KEY_F4,
+	CLI_KEY_F5,
+	CLI_KEY_F6,
+	CLI_KEY_F7,
+	CLI_KEY_F8,
+	CLI_KEY_F9,
+	CLI_KEY_F10,
+	CLI_KEY_F11,
+	CLI_KEY_F12,
+	CLI_KEY_ALT_B,   /* ESC 'b' */
+	CLI_KEY_ALT_D,   /* ESC 'd' */
+	CLI_KEY_ALT_F,   /* ESC 'f' */
+	CLI_KEY_LAST
+};
+
+/* Byte of the key pressed with Ctrl: CLI_KEY_CTRL('A') */
+#define CLI_KEY_CTRL(symbol)     ((symbol) & 0x1F)
+
 #endif /* CLI_CONSOLE_H_ */
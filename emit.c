@@ -0,0 +1,493 @@
+/*
+*******************************************************************************
+@file	emit.c
+@brief	Structured output of the commands: the same calls give text for
+		the operator, compact JSON or CBOR for the programs.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include <stdio.h>   /* For 'snprintf' */
+
+#include "cli.h"
+
+#if (CLI_ENABLE_EMIT == TRUE)
+#if (CLI_ENABLE_WORKERS == TRUE)
+#include "worker.h"
+#endif
+
+/* CBOR major types */
+#define CLI_CBOR_UINT         0
+#define CLI_CBOR_NINT         1
+#define CLI_CBOR_TEXT         3
+#define CLI_CBOR_ARRAY        4
+#define CLI_CBOR_MAP          5
+#define CLI_CBOR_SIMPLE       7
+#define CLI_CBOR_INDEFINITE   31
+#define CLI_CBOR_BREAK        0xFF
+
+static cli_emit_t *cli_emit_state(cli_t *cli);
+static int cli_emit_key(cli_t *cli, const char *key);
+static int cli_emit_begin(cli_t *cli, const char *key, int array, int first);
+static int cli_emit_end(cli_t *cli);
+static void cli_emit_indent(cli_t *cli);
+static void cli_emit_line(cli_t *cli);
+static void cli_emit_cbor_head(cli_t *cli, int major, uint64_t value);
+static void cli_emit_json_string(cli_t *cli, const char *text);
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Set the output format of the session.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	format Format `CLI_FORMAT_...`.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the format is incorrect.
+*/
+int cli_emit_set_format(cli_t *cli, cli_format_t format) {
+	if (format > CLI_FORMAT_CBOR) {
+		return CLI_ERROR;
+	}
+	cli_emit_t *emit = cli_emit_state(cli);
+	emit->Format = format;
+	emit->Depth = 0;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the output format of the session.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`cli_format_t` Format.
+*/
+cli_format_t cli_emit_format(cli_t *cli) {
+	return (cli_format_t)cli_emit_state(cli)->Format;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Open an object. The output of the command is one object.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name of the object in the outer object, NULL at the top
+*       	level and in arrays.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there are too many open levels.
+*/
+int cli_emit_begin_object(cli_t *cli, const char *key) {
+	return cli_emit_begin(cli, key, 0, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Close the object.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_emit_end_object(cli_t *cli) {
+	return cli_emit_end(cli);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Open an array. Its elements are written with the NULL key.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name of the array in the outer object.
+* @param	first Index of the first element, shown in the text: `key[first]=`.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there are too many open levels.
+*/
+int cli_emit_begin_array(cli_t *cli, const char *key, int first) {
+	return cli_emit_begin(cli, key, 1, first);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Close the array.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_emit_end_array(cli_t *cli) {
+	return cli_emit_end(cli);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the integer.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name of the value, NULL in arrays.
+* @param	value The value.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_emit_kv_int(cli_t *cli, const char *key, int64_t value) {
+	cli_emit_key(cli, key);
+	if (cli_emit_state(cli)->Format == CLI_FORMAT_CBOR) {
+		if (value < 0) {
+			cli_emit_cbor_head(cli, CLI_CBOR_NINT, (uint64_t)(-1 - value));
+		} else {
+			cli_emit_cbor_head(cli, CLI_CBOR_UINT, (uint64_t)value);
+		}
+		return CLI_OK;
+	}
+	cli_printf(cli, "%lld", (long long)value);
+	cli_emit_line(cli);
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the unsigned integer, shown in hex in the text.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name of the value, NULL in arrays.
+* @param	value The value.
+* @param	digits Minimum number of hex digits in the text.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_emit_kv_hex(cli_t *cli, const char *key, uint32_t value, int digits) {
+	cli_emit_key(cli, key);
+	switch (cli_emit_state(cli)->Format) {
+	case CLI_FORMAT_CBOR:
+		cli_emit_cbor_head(cli, CLI_CBOR_UINT, value);
+		break;
+	case CLI_FORMAT_JSON:
+		cli_printf(cli, "%lu", (unsigned long)value);
+		cli_emit_line(cli);
+		break;
+	default:
+		cli_printf(cli, "0x%.*lx", digits, (unsigned long)value);
+		cli_emit_line(cli);
+		break;
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the string.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name of the value, NULL in arrays.
+* @param	value The string.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_emit_kv_str(cli_t *cli, const char *key, const char *value) {
+	cli_emit_key(cli, key);
+	switch (cli_emit_state(cli)->Format) {
+	case CLI_FORMAT_CBOR: {
+		int length = strlen(value);
+		cli_emit_cbor_head(cli, CLI_CBOR_TEXT, length);
+		cli_write(cli, value, length);
+		break;
+	}
+	case CLI_FORMAT_JSON:
+		cli_emit_json_string(cli, value);
+		cli_emit_line(cli);
+		break;
+	default:
+		cli_printf(cli, "%s", value);
+		cli_emit_line(cli);
+		break;
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the boolean value.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name of the value, NULL in arrays.
+* @param	value The value: (0) - false, (!0) - true.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_emit_kv_bool(cli_t *cli, const char *key, int value) {
+	cli_emit_key(cli, key);
+	if (cli_emit_state(cli)->Format == CLI_FORMAT_CBOR) {
+		/* Simple values 20 (false) and 21 (true) */
+		cli_emit_cbor_head(cli, CLI_CBOR_SIMPLE, value ? 21 : 20);
+		return CLI_OK;
+	}
+	cli_printf(cli, "%s", value ? "true" : "false");
+	cli_emit_line(cli);
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the array of integers.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name of the array.
+* @param	values The values.
+* @param	count Number of the values.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there are too many open levels.
+*/
+int cli_emit_array(cli_t *cli, const char *key, const int32_t *values, int count) {
+	if (cli_emit_begin_array(cli, key, 0) != CLI_OK) {
+		return CLI_ERROR;
+	}
+	for (int i = 0; i < count; i++) {
+		cli_emit_kv_int(cli, NULL, values[i]);
+	}
+	return cli_emit_end_array(cli);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the emitter of the caller.
+* @note 	A command run by a worker writes with the emitter of its job,
+*       	so its open levels do not mix with those of the main loop.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`cli_emit_t*` The emitter.
+*/
+static cli_emit_t *cli_emit_state(cli_t *cli) {
+#if (CLI_ENABLE_WORKERS == TRUE)
+	cli_emit_t *emit = cli_worker_emit(cli);
+	if (emit != NULL) {
+		return emit;
+	}
+#endif
+	return &cli->Emit;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write what goes before the value: the separator and the key.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name of the value, NULL in arrays.
+* @retval 	`CLI_OK` (0) if success.
+*/
+static int cli_emit_key(cli_t *cli, const char *key) {
+	cli_emit_t *emit = cli_emit_state(cli);
+	cli_emit_level_t *level = emit->Depth ? &emit->Levels[emit->Depth - 1] : NULL;
+	int index = 0;
+	if (level != NULL) {
+		index = level->Index++;
+	}
+	int array = (level != NULL) && level->Array;
+	if ((level == NULL) && (emit->Format != CLI_FORMAT_TEXT)) {
+		/* The top level is the value alone */
+		key = NULL;
+	}
+	switch (emit->Format) {
+	case CLI_FORMAT_CBOR:
+		if (!array && (key != NULL)) {
+			int length = strlen(key);
+			cli_emit_cbor_head(cli, CLI_CBOR_TEXT, length);
+			cli_write(cli, key, length);
+		}
+		break;
+	case CLI_FORMAT_JSON:
+		if (index) {
+			cli_write(cli, ",", 1);
+		}
+		if (!array && (key != NULL)) {
+			cli_emit_json_string(cli, key);
+			cli_write(cli, ":", 1);
+		}
+		break;
+	default:
+		cli_emit_indent(cli);
+		if (array) {
+			cli_printf(cli, "%s[%d]=", (level->Key != NULL) ? level->Key : "", level->First + index);
+		} else if (key != NULL) {
+			cli_printf(cli, "%s=", key);
+		}
+		break;
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Open an object or an array.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key Name in the outer object.
+* @param	array (1) for an array.
+* @param	first Index of the first element of the array, for the text.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there are too many open levels.
+*/
+static int cli_emit_begin(cli_t *cli, const char *key, int array, int first) {
+	cli_emit_t *emit = cli_emit_state(cli);
+	if (emit->Depth == CLI_EMIT_DEPTH) {
+		return CLI_ERROR;
+	}
+	if (emit->Format == CLI_FORMAT_TEXT) {
+		/* The text has no brackets: the members of an inner object go
+		 * under its name, the elements of an array are 'key[i]=' */
+		cli_emit_level_t *outer = emit->Depth ? &emit->Levels[emit->Depth - 1] : NULL;
+		if ((outer != NULL) && !array) {
+			cli_emit_indent(cli);
+			if (outer->Array) {
+				cli_printf(cli, "%s[%d]:\r\n", (outer->Key != NULL) ? outer->Key : "", outer->First + outer->Index);
+			} else {
+				cli_printf(cli, "%s:\r\n", (key != NULL) ? key : "");
+			}
+		}
+		if (outer != NULL) {
+			outer->Index++;
+		}
+		if (array && (outer != NULL) && (key == NULL)) {
+			/* The array in the array is named by its place */
+			key = outer->Key;
+		}
+	} else {
+		cli_emit_key(cli, key);
+		if (emit->Format == CLI_FORMAT_CBOR) {
+			cli_emit_cbor_head(cli, array ? CLI_CBOR_ARRAY : CLI_CBOR_MAP, CLI_CBOR_INDEFINITE);
+		} else {
+			cli_write(cli, array ? "[" : "{", 1);
+		}
+	}
+	cli_emit_level_t *level = &emit->Levels[emit->Depth++];
+	level->Key = key;
+	level->Index = 0;
+	level->First = first;
+	level->Array = array;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Close the object or array.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is nothing to close.
+*/
+static int cli_emit_end(cli_t *cli) {
+	cli_emit_t *emit = cli_emit_state(cli);
+	if (!emit->Depth) {
+		return CLI_ERROR;
+	}
+	int array = emit->Levels[--emit->Depth].Array;
+	switch (emit->Format) {
+	case CLI_FORMAT_CBOR: {
+		char stop = (char)CLI_CBOR_BREAK;
+		cli_write(cli, &stop, 1);
+		break;
+	}
+	case CLI_FORMAT_JSON:
+		cli_write(cli, array ? "]" : "}", 1);
+		cli_emit_line(cli);
+		break;
+	default:
+		break;
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Indent the text line by the number of the open inner objects.
+* @note 	The members of the top object are not indented, the elements of
+*       	an array are at the same place as the array.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+static void cli_emit_indent(cli_t *cli) {
+	cli_emit_t *emit = cli_emit_state(cli);
+	for (int i = 1; i < emit->Depth; i++) {
+		if (!emit->Levels[i].Array) {
+			cli_write(cli, "\t", 1);
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	End the line after the value: each value in the text,
+*       	the whole top-level value in JSON. CBOR has no lines.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*
+*/
+static void cli_emit_line(cli_t *cli) {
+	cli_emit_t *emit = cli_emit_state(cli);
+	if ((emit->Format == CLI_FORMAT_TEXT) || !emit->Depth) {
+		cli_write(cli, "\r\n", 2);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the head of the CBOR item: major type and argument.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	major Major type.
+* @param	value Argument: the value, the length or `CLI_CBOR_INDEFINITE`.
+*
+*/
+static void cli_emit_cbor_head(cli_t *cli, int major, uint64_t value) {
+	char head[9];
+	int length = 1;
+	int info;
+	if ((value < 24) || ((value == CLI_CBOR_INDEFINITE) && (major >= CLI_CBOR_ARRAY) && (major <= CLI_CBOR_MAP))) {
+		info = value;
+	} else if (value <= 0xFF) {
+		info = 24;
+		length += 1;
+	} else if (value <= 0xFFFF) {
+		info = 25;
+		length += 2;
+	} else if (value <= 0xFFFFFFFFU) {
+		info = 26;
+		length += 4;
+	} else {
+		info = 27;
+		length += 8;
+	}
+	head[0] = (major << 5) | info;
+	/* Big-endian argument */
+	for (int i = length - 1; i > 0; i--) {
+		head[i] = value & 0xFF;
+		value >>= 8;
+	}
+	cli_write(cli, head, length);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the JSON string with the quotes and escapes.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	text The string.
+*
+*/
+static void cli_emit_json_string(cli_t *cli, const char *text) {
+	cli_write(cli, "\"", 1);
+	const char *start = text;
+	for (; *text; text++) {
+		uint8_t symbol = *text;
+		if ((symbol >= 0x20) && (symbol != '"') && (symbol != '\\')) continue;
+		/* Write the plain part at once, then the escape */
+		cli_write(cli, start, text - start);
+		start = text + 1;
+		if ((symbol == '"') || (symbol == '\\')) {
+			char escape[2] = {'\\', symbol};
+			cli_write(cli, escape, 2);
+		} else {
+			cli_printf(cli, "\\u%04x", symbol);
+		}
+	}
+	cli_write(cli, start, text - start);
+	cli_write(cli, "\"", 1);
+}
+
+#endif /* CLI_ENABLE_EMIT */
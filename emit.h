@@ -0,0 +1,75 @@
+/*
+*******************************************************************************
+@file	emit.h
+@brief	Structured output of the commands: the same calls give text for
+		the operator, compact JSON or CBOR for the programs.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_EMIT_H_
+#define CLI_EMIT_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdint.h>  /* For 'uint8_t' */
+
+#include "opt.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Output formats of the emitter
+ */
+typedef enum {
+	CLI_FORMAT_TEXT = 0,                   // 'key=value' lines for the operator
+	CLI_FORMAT_JSON,                       // One compact JSON object per line
+	CLI_FORMAT_CBOR                        // CBOR (RFC 8949) with indefinite-length maps and arrays
+} cli_format_t;
+
+/*
+ * @brief	One open object or array
+ */
+typedef struct {
+	const char *Key;                       // Name of the array, for the text
+	int Index;                             // Number of the elements written
+	int First;                             // Index of the first element, for the text
+	uint8_t Array;                         // The level is an array
+} cli_emit_level_t;
+
+/*
+ * @brief	Emitter Structure definition
+ * @note	Nothing is collected: each call writes its part of the output
+ *      	at once. Only the open levels are kept.
+ */
+typedef struct {
+	uint8_t Format;                        // Format of the session 'cli_format_t'
+	uint8_t Depth;                         // Number of the open levels
+	cli_emit_level_t Levels[CLI_EMIT_DEPTH]; // Open objects and arrays
+} cli_emit_t;
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_EMIT_H_ */
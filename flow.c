@@ -0,0 +1,336 @@
+/*
+*******************************************************************************
+@file	flow.c
+@brief	Output flow control: XON/XOFF, the backpressure of the port and
+		the pager of the long output.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+#include "io.h"
+
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+
+/* Sent by 'cli_tx_pop' when the page is full, and to erase it on the key */
+static const char cli_page_prompt[] = CONSOLE_REVERSE "--More--" CONSOLE_NORMAL;
+static const char cli_page_erase[] = "\r" CONSOLE_CLEAR_STRING;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Put the received bytes in the receive ring. XON and XOFF are
+*       	taken by the flow control, unless the port is raw.
+* @note 	Called from `cli_rx_push`, in the UART receive interrupt.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	data Received bytes.
+* @param	length Number of bytes.
+* @return	`int` Number of bytes accepted.
+*/
+int cli_flow_rx(cli_t *cli, const uint8_t *data, int length) {
+	if (cli->Raw & CLI_RAW_RX) {
+		return cli_ring_write(&cli->Rx, data, length);
+	}
+	int accepted = 0;
+	int start = 0;
+	for (int i = 0; i < length; i++) {
+		if ((data[i] != Key_XON) && (data[i] != Key_XOFF)) {
+			continue;
+		}
+		accepted += cli_ring_write(&cli->Rx, &data[start], i - start) + 1;
+		start = i + 1;
+		cli->TxXoff = (data[i] == Key_XOFF);
+		if (!cli->TxXoff && (cli->_io_txstart != NULL)) {
+			cli->_io_txstart();
+		}
+	}
+	return accepted + cli_ring_write(&cli->Rx, &data[start], length - start);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The output is paged: the pager is on and the output is text.
+* @note 	A new line in the binary data (CBOR, the transfer) is not the
+*       	end of a line of the terminal.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` (1) if the lines are counted.
+*/
+static int cli_flow_paged(cli_t *cli) {
+	if (!cli->Pager || (cli->Raw & CLI_RAW_TX)) {
+		return 0;
+	}
+#if (CLI_ENABLE_EMIT == TRUE)
+	if (cli->Emit.Format == CLI_FORMAT_CBOR) {
+		return 0;
+	}
+#endif
+	return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the bytes for transmission unless the output is stopped.
+* @note 	Called from `cli_tx_pop`. With the pager, the lines of the
+*       	text are counted and the prompt is sent when the page is full.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	data Buffer for the bytes.
+* @param	length Size of the buffer.
+* @return	`int` Number of bytes taken.
+*/
+int cli_flow_pop(cli_t *cli, uint8_t *data, int length) {
+	if (cli->PageSeen != cli->PageStart) {
+		/* A command started: its output starts a new page */
+		cli->PageSeen = cli->PageStart;
+		cli->PageLines = 0;
+	}
+	int count = 0;
+	while (count < length) {
+		if ((cli->Page == CLI_PAGE_PROMPT) || (cli->Page == CLI_PAGE_ERASE)) {
+			const char *text = (cli->Page == CLI_PAGE_PROMPT) ? cli_page_prompt : cli_page_erase;
+			if (text[cli->PageSent]) {
+				data[count++] = text[cli->PageSent++];
+				continue;
+			}
+			cli->PageSent = 0;
+			if (cli->Page == CLI_PAGE_PROMPT) {
+				/* The rest waits for the key of the operator */
+				cli->Page = CLI_PAGE_WAIT;
+				break;
+			}
+			cli->Page = CLI_PAGE_FLOW;
+		}
+		if (cli->TxXoff || cli->TxHeld || (cli->Page != CLI_PAGE_FLOW)) {
+			break;
+		}
+		if (!cli_flow_paged(cli)) {
+			count += cli_ring_read(&cli->Tx, &data[count], length - count);
+			break;
+		}
+		if (!cli_ring_read(&cli->Tx, &data[count], 1)) {
+			break;
+		}
+		if ((data[count++] == '\n') && (++cli->PageLines >= CLI_PAGER_ROWS - 1)) {
+			/* The keys received before the prompt are typed ahead */
+			cli->PageAhead = cli_ring_count(&cli->Rx);
+			cli->Page = CLI_PAGE_PROMPT;
+		}
+	}
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The key is for the pager: Space, Enter, 'q' or Ctrl+C.
+*/
+static inline int cli_flow_is_page_key(int key) {
+	return (key == Key_SPACE) || (key == Key_CR) || (key == '\n') || (key == 'q') || (key == CLI_KEY_CTRL('C'));
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Key of the operator for the full page.
+* @note 	Space - the next page, Enter - one more line, 'q' or Ctrl+C -
+*       	drop the rest of the output.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The key.
+* @param	running The command is running: the rest of its output is dropped.
+*/
+static void cli_flow_page_key(cli_t *cli, int key, int running) {
+	int drop = (key == 'q') || (key == CLI_KEY_CTRL('C'));
+	if (key == Key_SPACE) {
+		cli->PageLines = 0;
+	} else if ((key == Key_CR) || (key == '\n')) {
+		cli->PageLines = CLI_PAGER_ROWS - 2;
+	} else if (drop) {
+		/* The transmission is stopped: the ring can be emptied from here */
+		unsigned int count = cli_ring_count(&cli->Tx);
+		cli_ring_skip(&cli->Tx, count);
+		cli->TxDropped += count;
+		cli->PageLines = 0;
+		cli->Discard = running;
+	} else {
+		return;
+	}
+	cli->PageSent = 0;
+	if (drop && !running) {
+		/* The prompt of the line editor was dropped with the output:
+		 * it is printed again over the prompt of the pager */
+		cli->Page = CLI_PAGE_FLOW;
+		cli_print_line(cli);
+		return;
+	}
+	cli->Page = CLI_PAGE_ERASE;
+	cli_tx_kick(cli);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Service of the flow control in `cli_handler`: the keys of the
+*       	pager and the output after XON without the interrupt.
+* @note 	The keys typed ahead and the keys that are not for the pager
+*       	go to the line editor, their echo waits for the page.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The received byte, (0) if none.
+* @return	`int` (1) if the key was taken by the pager.
+*/
+int cli_flow_handler(cli_t *cli, int key) {
+	if (cli->_io_txstart == NULL) {
+		cli_tx_kick(cli);
+	}
+	if (cli->Page != CLI_PAGE_WAIT) {
+		return 0;
+	}
+	if (!key) {
+		return 1;
+	}
+	if (cli->PageAhead) {
+		cli->PageAhead--;
+		return 0;
+	}
+	if (!cli_flow_is_page_key(key)) {
+		return 0;
+	}
+	cli_flow_page_key(cli, key, 0);
+	return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Wait for a free place in the transmit ring while the command
+*       	writes.
+* @note 	The pager takes its keys here. If the far end does not read
+*       	(XOFF or the port) for `CLI_FLOW_TIMEOUT` ms, the rest of the
+*       	output of the command is dropped instead of stalling the system.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	`CLI_OK` (0) if there is a place.
+* @retval   `CLI_ERROR` (!0) if the output of the command is dropped.
+*/
+int cli_flow_wait(cli_t *cli) {
+	uint32_t start = (__io_cli_millis != NULL) ? __io_cli_millis() : 0;
+	while (!cli_ring_space(&cli->Tx)) {
+		if (cli->Page == CLI_PAGE_WAIT) {
+			/* After the keys typed ahead, the first key of the pager is
+			 * taken out, the other keys stay in their order */
+			unsigned int ahead = cli->PageAhead;
+			if (ahead > cli_ring_count(&cli->Rx)) {
+				ahead = cli_ring_count(&cli->Rx);
+			}
+			int key;
+			for (unsigned int i = ahead; (key = cli_ring_peek(&cli->Rx, i)) >= 0; i++) {
+				if (cli_flow_is_page_key(key)) {
+					/* Out of the ring before the next page counts the keys */
+					cli_ring_remove(&cli->Rx, i);
+					cli_flow_page_key(cli, key, 1);
+					break;
+				}
+			}
+			if (__io_cli_millis != NULL) {
+				/* The operator reads: no timeout */
+				start = __io_cli_millis();
+			}
+		} else if (cli->_io_txstart == NULL) {
+			cli_tx_kick(cli);
+		}
+		if (cli->Discard) {
+			return CLI_ERROR;
+		}
+		if ((__io_cli_millis != NULL) && (cli->TxXoff || cli->TxHeld) &&
+				(__io_cli_millis() - start >= CLI_FLOW_TIMEOUT)) {
+			cli->Discard = 1;
+			return CLI_ERROR;
+		}
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	A command starts: its output starts a new page and is sent.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+*/
+void cli_flow_start(cli_t *cli) {
+	cli->PageStart++;
+	cli->Discard = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Stop or resume the output: the backpressure of the port.
+* @note 	For the port whose far end can stop reading (USB CDC, CTS),
+*       	instead of blocking in the transmit. Can be called from the
+*       	interrupts.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	hold Not (0) - stop, (0) - resume.
+* @retval 	`CLI_OK` (0) always.
+*/
+int cli_tx_hold(cli_t *cli, int hold) {
+	cli->TxHeld = (hold != 0);
+	if (!hold && (cli->_io_txstart != NULL)) {
+		cli->_io_txstart();
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Carry the binary data: a file transfer or a link of channels
+*       	owns the port.
+* @note 	With `CLI_RAW_RX` the bytes XON and XOFF go to the receive
+*       	ring, and the output stopped by XOFF goes on. With `CLI_RAW_TX`
+*       	the output is not paged.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	mode 'CLI_RAW_...', (0) - the terminal.
+* @return	`int` The previous mode, to be given back when the data ends.
+*/
+int cli_raw(cli_t *cli, int mode) {
+	int previous = cli->Raw;
+	cli->Raw = (uint8_t)mode;
+	if (mode & CLI_RAW_RX) {
+		cli->TxXoff = 0;
+	}
+	if (cli->_io_txstart != NULL) {
+		cli->_io_txstart();
+	}
+	return previous;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Bytes the command can write now without waiting.
+* @note 	While the output is stopped (XOFF, the port, the full page),
+*       	the ring is not emptied: a long command can check the room
+*       	and pause its work instead of waiting in `cli_write`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` Free place of the transmit ring, (-1) if the rest of
+*       	the output of the command is dropped.
+*/
+int cli_tx_room(cli_t *cli) {
+	if (cli->Discard) {
+		return -1;
+	}
+	return (int)cli_ring_space(&cli->Tx);
+}
+
+#endif /* CLI_ENABLE_FLOW_CONTROL */
@@ -29,6 +29,27 @@ SOFTWARE.
 *******************************************************************************
 */
 #include "function.h"
+#include <stdlib.h>  /* For 'atoi' */
+#if (CLI_ENABLE_WORKERS == TRUE)
+#include "worker.h"
+#endif
+
+#if (CLI_ENABLE_EMIT == TRUE)
+static int cli_function_help_emit(cli_t *cli);
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+static int cli_function_watch_refresh(cli_t *cli, cli_screen_t *screen, int key);
+static int cli_function_watch_sink(void *context, const char *data, int length);
+
+/* The command of 'watch' and the place of its output on the screen */
+static struct {
+	char Line[CLI_BUFFER_SIZE];
+	int Period;
+	int Row;
+	int Col;
+	int Escape;                            // 1 - after ESC, 2 - in the CSI sequence
+} cli_watch;
+#endif
 
 /**
 * @brief 	Command: Print in console all function.
@@ -40,17 +61,104 @@ SOFTWARE.
 * @retval   Error code (!0) if error.
 */
 int cli_function_help(cli_t *cli, int argc, char* argv[]) {
+	if (argc > 1) {
+		/* 'help group ...': only the subtree */
+#if (CLI_ENABLE_ALIASES == TRUE)
+		cli_alias_t *alias = cli_alias_find(cli, argv[1]);
+		if ((alias != NULL) && (argc == 2)) {
+			cli_alias_print(cli, alias);
+			cli_printf(cli, "\r\n");
+			return EXIT_SUCCESS;
+		}
+#endif
+		const cli_command_t *command = cli_command_path(cli, argc - 1, &argv[1]);
+		if (command == NULL) {
+			cli_printf(cli, "Command '%s' not found\r\n", argv[argc - 1]);
+			return EXIT_FAILURE;
+		}
+#if (CLI_ENABLE_EMIT == TRUE)
+		if (cli_emit_format(cli) != CLI_FORMAT_TEXT) {
+			cli_emit_begin_object(cli, NULL);
+			cli_emit_kv_str(cli, "name", command->Name);
+			cli_emit_kv_str(cli, "help", command->Help);
+			if (command->Children != NULL) {
+				cli_print_group(cli, command);
+			}
+			cli_emit_end_object(cli);
+			return EXIT_SUCCESS;
+		}
+#endif
+		cli_printf(cli, "%s - %s\r\n", command->Name, command->Help);
+		if (command->Children != NULL) {
+			cli_print_group(cli, command);
+		}
+		return EXIT_SUCCESS;
+	}
+#if (CLI_ENABLE_EMIT == TRUE)
+	if (cli_emit_format(cli) != CLI_FORMAT_TEXT) {
+		return cli_function_help_emit(cli);
+	}
+#endif
 	cli_printf(cli, "CLI version: v%d.%d\r\n", CLI_VERSION_MAJOR, CLI_VERSION_MINOR);
 	cli_printf(cli, "Data compiling: %s %s\r\n", __DATE__, __TIME__);
-	cli_printf(cli, "Type 'help' to see this list commands.\r\n");
+	cli_printf(cli, "Type 'help' to see this list commands, 'help <group>' for the commands of the group.\r\n");
 	cli_printf(cli, "List command:\r\n");
-	for (int index = 0; index < CLI_MAX_COUNT_COMMAND; index++) {
-		if (cli->Commands[index].Function != NULL) {
-			cli_printf(cli, "\t%s - %s\r\n", cli->Commands[index].Name, cli->Commands[index].Help);
+	cli_print_group(cli, NULL);
+#if (CLI_ENABLE_ALIASES == TRUE)
+	for (int index = 0; index < CLI_ALIAS_COUNT; index++) {
+		if (cli->Aliases[index].Text[0]) {
+			cli_printf(cli, "\t");
+			cli_alias_print(cli, &cli->Aliases[index]);
+			cli_printf(cli, "\r\n");
+		}
+	}
+#endif
+	return EXIT_SUCCESS;
+}
+
+#if (CLI_ENABLE_EMIT == TRUE)
+/**
+* @brief 	Write the list of the commands for the program: JSON or CBOR.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+*/
+static int cli_function_help_emit(cli_t *cli) {
+	cli_emit_begin_object(cli, NULL);
+	cli_emit_begin_object(cli, "version");
+	cli_emit_kv_int(cli, "major", CLI_VERSION_MAJOR);
+	cli_emit_kv_int(cli, "minor", CLI_VERSION_MINOR);
+	cli_emit_end_object(cli);
+	cli_emit_kv_str(cli, "compiled", __DATE__ " " __TIME__);
+	cli_print_group(cli, NULL);
+#if (CLI_ENABLE_ALIASES == TRUE)
+	cli_emit_begin_array(cli, "aliases", 0);
+	for (int index = 0; index < CLI_ALIAS_COUNT; index++) {
+		const cli_alias_t *alias = &cli->Aliases[index];
+		if (!alias->Text[0]) continue;
+		cli_emit_begin_object(cli, NULL);
+		cli_emit_kv_str(cli, "name", alias->Text);
+		/* One string per command of the list: the tokens joined by spaces */
+		cli_emit_begin_array(cli, "commands", 0);
+		char *line = cli_scratch_alloc(cli, CLI_ALIAS_SIZE);
+		for (int i = 0; (line != NULL) && (i < alias->Count); i++) {
+			memcpy(line, &alias->Text[alias->Steps[i].Offset], CLI_ALIAS_SIZE - alias->Steps[i].Offset);
+			char *end = line;
+			for (int j = 0; j < alias->Steps[i].Argc; j++) {
+				end += strlen(end);
+				if (j + 1 < alias->Steps[i].Argc) *end++ = ' ';
+			}
+			cli_emit_kv_str(cli, NULL, line);
 		}
+		cli_emit_end_array(cli);
+		cli_emit_end_object(cli);
 	}
+	cli_emit_end_array(cli);
+#endif
+	cli_emit_end_object(cli);
 	return EXIT_SUCCESS;
 }
+#endif
 
 /**
 * @brief 	Command: Clear console CLI.
@@ -65,3 +173,572 @@ int cli_function_clear(cli_t *cli, int argc, char* argv[]) {
 	cli_printf(cli, CONSOLE_CLEAR_TERMINAL);
 	return EXIT_SUCCESS;
 }
+
+#if (CLI_ENABLE_WORKERS == TRUE)
+/**
+* @brief 	Command: Print the jobs launched by the instance.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_jobs(cli_t *cli, int argc, char* argv[]) {
+	cli_worker_list(cli);
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Command: Wait until all the jobs launched by the instance are done.
+* @note 	Does not block the other instances: the input of this instance
+*       	is not processed until the jobs are done.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_wait(cli_t *cli, int argc, char* argv[]) {
+	cli->Waiting = CLI_WORKER_WAIT_ALL;
+	cli->Streaming = 1;
+	return EXIT_SUCCESS;
+}
+#endif
+
+#if (CLI_ENABLE_PLUGINS == TRUE)
+/**
+* @brief 	Command: Load the plugin, or print the plugins.
+* @note 	`load PATH`: the commands of the plugin are seen by all the
+*       	instances. Without arguments prints the plugins.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_load(cli_t *cli, int argc, char* argv[]) {
+	if (argc < 2) {
+		cli_plugin_list(cli);
+		return EXIT_SUCCESS;
+	}
+	return (cli_plugin_load(cli, argv[1]) == CLI_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+* @brief 	Command: Unload the plugin.
+* @note 	`unload NAME`: the path of the plugin or its file name.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_unload(cli_t *cli, int argc, char* argv[]) {
+	if (argc != 2) {
+		cli_printf(cli, "Usage: %s NAME\r\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	return (cli_plugin_unload(cli, argv[1]) == CLI_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
+
+#if (CLI_ENABLE_VARIABLES == TRUE)
+/**
+* @brief 	Command: Set the session variable.
+* @note 	`set NAME VALUE ...`: the rest of the line is the value.
+*       	Without arguments prints all the variables.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_set(cli_t *cli, int argc, char* argv[]) {
+	if (argc < 2) {
+		return cli_function_env(cli, argc, argv);
+	}
+	/* The value is the rest of the line */
+	char *value = cli_scratch_join(cli, argc - 2, &argv[2]);
+	if (value == NULL) {
+		cli_printf(cli, "The arguments do not fit in the scratch arena. Change the value of CLI_SCRATCH_SIZE in the 'opt.h' file.\r\n");
+		return EXIT_FAILURE;
+	}
+	if (cli_setenv(cli, argv[1], value) != CLI_OK) {
+		cli_printf(cli, "Failed to set '%s'. Check the name or change the value of CLI_VARIABLES_COUNT/CLI_VARIABLES_ARENA in the 'opt.h' file.\r\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Command: Remove the session variables.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_unset(cli_t *cli, int argc, char* argv[]) {
+	int status = EXIT_SUCCESS;
+	for (int i = 1; i < argc; i++) {
+		if (cli_unsetenv(cli, argv[i]) != CLI_OK) {
+			cli_printf(cli, "Variable '%s' not found\r\n", argv[i]);
+			status = EXIT_FAILURE;
+		}
+	}
+	return status;
+}
+
+/**
+* @brief 	Command: Print the session variables.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_env(cli_t *cli, int argc, char* argv[]) {
+	int position = 0;
+	const char *name;
+	const char *value;
+	while (cli_variables_next(&cli->Variables, &position, &name, &value)) {
+		cli_printf(cli, "%s=%s\r\n", name, value);
+	}
+	return EXIT_SUCCESS;
+}
+#endif
+
+#if (CLI_ENABLE_ALIASES == TRUE)
+/**
+* @brief 	Command: Define the alias.
+* @note 	`alias NAME='CMD1 ARGS; CMD2 ARGS'` or `alias NAME CMD1 ARGS`.
+*       	Without arguments prints all the aliases.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_alias(cli_t *cli, int argc, char* argv[]) {
+	if (argc < 2) {
+		for (int index = 0; index < CLI_ALIAS_COUNT; index++) {
+			if (cli->Aliases[index].Text[0]) {
+				cli_alias_print(cli, &cli->Aliases[index]);
+				cli_printf(cli, "\r\n");
+			}
+		}
+		return EXIT_SUCCESS;
+	}
+	/* 'NAME=BODY' or 'NAME BODY' */
+	char *name = cli_scratch_join(cli, argc - 1, &argv[1]);
+	if (name == NULL) {
+		cli_printf(cli, "The arguments do not fit in the scratch arena. Change the value of CLI_SCRATCH_SIZE in the 'opt.h' file.\r\n");
+		return EXIT_FAILURE;
+	}
+	char *body = name + strcspn(name, "= ");
+	if (*body == 0) {
+		cli_alias_t *alias = cli_alias_find(cli, name);
+		if (alias == NULL) {
+			cli_printf(cli, "Alias '%s' not found\r\n", name);
+			return EXIT_FAILURE;
+		}
+		cli_alias_print(cli, alias);
+		cli_printf(cli, "\r\n");
+		return EXIT_SUCCESS;
+	}
+	*body++ = 0;
+	if (cli_alias_set(cli, name, body) != CLI_OK) {
+		cli_printf(cli, "Failed to define '%s'. Change the value of CLI_ALIAS_COUNT/CLI_ALIAS_SIZE/CLI_ALIAS_STEPS in the 'opt.h' file.\r\n", name);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Command: Remove the aliases.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_unalias(cli_t *cli, int argc, char* argv[]) {
+	int status = EXIT_SUCCESS;
+	for (int i = 1; i < argc; i++) {
+		if (cli_alias_remove(cli, argv[i]) != CLI_OK) {
+			cli_printf(cli, "Alias '%s' not found\r\n", argv[i]);
+			status = EXIT_FAILURE;
+		}
+	}
+	return status;
+}
+
+#if (CLI_ENABLE_COMPLETION == TRUE)
+/**
+* @brief 	Completion of the arguments of `unalias`: the names of the aliases.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of the words, the last one is under the cursor.
+* @param 	argv[] Array of the words.
+* @param	complete The candidates.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_complete_unalias(cli_t *cli, int argc, char* argv[], cli_complete_t *complete) {
+	for (int index = 0; (argc == 2) && (index < CLI_ALIAS_COUNT); index++) {
+		if (cli->Aliases[index].Text[0]) {
+			cli_complete_add(complete, cli->Aliases[index].Text);
+		}
+	}
+	return CLI_OK;
+}
+#endif
+#endif
+
+#if (CLI_ENABLE_EMIT == TRUE)
+/**
+* @brief 	Command: Set the output format of the commands.
+* @note 	`format [text|json|cbor]`. Without arguments prints the format.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_format(cli_t *cli, int argc, char* argv[]) {
+	static const char *const names[] = {"text", "json", "cbor"};
+	if (argc < 2) {
+		cli_emit_kv_str(cli, NULL, names[cli_emit_format(cli)]);
+		return EXIT_SUCCESS;
+	}
+	for (int format = CLI_FORMAT_TEXT; format <= CLI_FORMAT_CBOR; format++) {
+		if (!strcmp(argv[1], names[format])) {
+			cli_emit_set_format(cli, format);
+			return EXIT_SUCCESS;
+		}
+	}
+	cli_printf(cli, "Unknown format '%s'. Use: text, json or cbor\r\n", argv[1]);
+	return EXIT_FAILURE;
+}
+
+#if (CLI_ENABLE_COMPLETION == TRUE)
+/**
+* @brief 	Completion of the arguments of `format`: the formats.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of the words, the last one is under the cursor.
+* @param 	argv[] Array of the words.
+* @param	complete The candidates.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_complete_format(cli_t *cli, int argc, char* argv[], cli_complete_t *complete) {
+	if (argc == 2) {
+		cli_complete_add(complete, "text");
+		cli_complete_add(complete, "json");
+		cli_complete_add(complete, "cbor");
+	}
+	return CLI_OK;
+}
+#endif
+#endif
+
+#if (CLI_ENABLE_TRACE == TRUE)
+/**
+* @brief 	Command: Print the trace of the instance or control it.
+* @note 	`trace` prints the events, `trace on|off|clear` controls the
+*       	recording, `trace latency` prints the histogram of the latency
+*       	from the key to the reaction. The output of the command itself
+*       	is not traced.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_trace(cli_t *cli, int argc, char* argv[]) {
+	cli_trace_t *trace = &cli->Trace;
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			trace->Enabled = 1;
+			return EXIT_SUCCESS;
+		}
+		if (!strcmp(argv[1], "off")) {
+			trace->Enabled = 0;
+			return EXIT_SUCCESS;
+		}
+		if (!strcmp(argv[1], "clear")) {
+			trace->Head = 0;
+			return EXIT_SUCCESS;
+		}
+		if (strcmp(argv[1], "latency")) {
+			cli_printf(cli, "Usage: %s [on|off|clear|latency]\r\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	uint8_t enabled = trace->Enabled;
+	trace->Enabled = 0;
+	if (argc > 1) {
+		/* Bin k: [2^k, 2^(k+1)) ticks */
+		unsigned int histogram[32];
+		int measured = cli_trace_latency(trace, histogram, 32);
+		cli_emit_begin_object(cli, NULL);
+		cli_emit_kv_int(cli, "keystrokes", measured);
+		cli_emit_begin_array(cli, "histogram", 0);
+		for (int bin = 0; bin < 32; bin++) {
+			if (!histogram[bin]) continue;
+			cli_emit_begin_object(cli, NULL);
+			cli_emit_kv_int(cli, "from", bin ? (1UL << bin) : 0);
+			cli_emit_kv_int(cli, "count", histogram[bin]);
+			cli_emit_end_object(cli);
+		}
+		cli_emit_end_array(cli);
+		cli_emit_end_object(cli);
+	} else if (cli_emit_format(cli) == CLI_FORMAT_TEXT) {
+		/* One event per line, the lines are read by 'cli_trace_parse' */
+		for (int index = 0; index < cli_trace_count(trace); index++) {
+			const cli_trace_record_t *record = cli_trace_get(trace, index);
+			cli_printf(cli, "%10lu %-8s 0x%.2x\r\n", (unsigned long)record->Time,
+					cli_trace_name(record->Event), record->Value);
+		}
+	} else {
+		cli_emit_begin_array(cli, NULL, 0);
+		for (int index = 0; index < cli_trace_count(trace); index++) {
+			const cli_trace_record_t *record = cli_trace_get(trace, index);
+			cli_emit_begin_object(cli, NULL);
+			cli_emit_kv_int(cli, "time", record->Time);
+			cli_emit_kv_str(cli, "event", cli_trace_name(record->Event));
+			cli_emit_kv_int(cli, "value", record->Value);
+			cli_emit_end_object(cli);
+		}
+		cli_emit_end_array(cli);
+	}
+	trace->Enabled = enabled;
+	return EXIT_SUCCESS;
+}
+#endif
+
+#if (CLI_ENABLE_STATS == TRUE)
+/**
+* @brief 	Command: Print the traffic of the terminal.
+* @note 	`stats clear` starts the count again, so the cost of the keys
+*       	and commands typed after it can be seen: bytes and escape
+*       	sequences sent per received byte.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_stats(cli_t *cli, int argc, char* argv[]) {
+	if (argc > 1) {
+		if (strcmp(argv[1], "clear")) {
+			cli_printf(cli, "Usage: %s [clear]\r\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+		memset(&cli->Stats, 0, sizeof(cli->Stats));
+		cli->Scratch.Peak = cli->Scratch.Top;
+		cli->Scratch.Failed = 0;
+#if (CLI_USE_RING_BUFFER == TRUE)
+		cli->RxDropped = 0;
+		cli->TxStalled = 0;
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+		cli->TxDropped = 0;
+#endif
+		return EXIT_SUCCESS;
+	}
+	/* Taken at once: the output of the command is counted too */
+	cli_stats_t stats = cli->Stats;
+#if (CLI_ENABLE_EMIT == TRUE)
+	cli_emit_begin_object(cli, NULL);
+	cli_emit_kv_int(cli, "rx_bytes", stats.RxBytes);
+	cli_emit_kv_int(cli, "tx_bytes", stats.TxBytes);
+	cli_emit_kv_int(cli, "tx_sequences", stats.TxSequences);
+	cli_emit_kv_int(cli, "commands", stats.Commands);
+#if (CLI_USE_RING_BUFFER == TRUE)
+	cli_emit_kv_int(cli, "rx_dropped", cli->RxDropped);
+	cli_emit_kv_int(cli, "tx_stalled", cli->TxStalled);
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	cli_emit_kv_int(cli, "tx_dropped", cli->TxDropped);
+#endif
+	cli_emit_kv_int(cli, "scratch_size", sizeof(cli->Scratch.Data));
+	cli_emit_kv_int(cli, "scratch_peak", cli->Scratch.Peak);
+	cli_emit_kv_int(cli, "scratch_failed", cli->Scratch.Failed);
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	cli_pool_stats_t pool;
+	cli_pool_stats(&pool);
+	cli_emit_kv_int(cli, "pool_blocks", pool.Blocks);
+	cli_emit_kv_int(cli, "pool_used", pool.Used);
+	cli_emit_kv_int(cli, "pool_peak", pool.Peak);
+	cli_emit_kv_int(cli, "pool_failed", pool.Failed);
+#endif
+	cli_emit_end_object(cli);
+#else
+	cli_printf(cli, "rx_bytes=%u\r\ntx_bytes=%u\r\ntx_sequences=%u\r\ncommands=%u\r\n",
+			stats.RxBytes, stats.TxBytes, stats.TxSequences, stats.Commands);
+#if (CLI_USE_RING_BUFFER == TRUE)
+	cli_printf(cli, "rx_dropped=%u\r\ntx_stalled=%u\r\n", cli->RxDropped, cli->TxStalled);
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	cli_printf(cli, "tx_dropped=%u\r\n", cli->TxDropped);
+#endif
+	cli_printf(cli, "scratch_size=%u\r\nscratch_peak=%u\r\nscratch_failed=%u\r\n",
+			(unsigned int)sizeof(cli->Scratch.Data), (unsigned int)cli->Scratch.Peak, cli->Scratch.Failed);
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+	cli_pool_stats_t pool;
+	cli_pool_stats(&pool);
+	cli_printf(cli, "pool_blocks=%u\r\npool_used=%u\r\npool_peak=%u\r\npool_failed=%u\r\n",
+			pool.Blocks, pool.Used, pool.Peak, pool.Failed);
+#endif
+#endif
+	return EXIT_SUCCESS;
+}
+#endif
+
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+/**
+* @brief 	Command: Turn the pager on or off.
+* @note 	With the pager, the output stops after each page of
+*       	`CLI_PAGER_ROWS` lines: Space - the next page, Enter - one
+*       	more line, 'q' - drop the rest of the output.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_more(cli_t *cli, int argc, char* argv[]) {
+	if (argc < 2) {
+		cli_printf(cli, "%s\r\n", cli->Pager ? "on" : "off");
+		return EXIT_SUCCESS;
+	}
+	if (!strcmp(argv[1], "on") || !strcmp(argv[1], "off")) {
+		cli->Pager = !strcmp(argv[1], "on");
+		return EXIT_SUCCESS;
+	}
+	cli_printf(cli, "Usage: %s [on|off]\r\n", argv[0]);
+	return EXIT_FAILURE;
+}
+
+#if (CLI_ENABLE_COMPLETION == TRUE)
+/**
+* @brief 	Completion of the arguments of `more`: on and off.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of the words, the last one is under the cursor.
+* @param 	argv[] Array of the words.
+* @param	complete The candidates.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_complete_more(cli_t *cli, int argc, char* argv[], cli_complete_t *complete) {
+	if (argc == 2) {
+		cli_complete_add(complete, "on");
+		cli_complete_add(complete, "off");
+	}
+	return CLI_OK;
+}
+#endif
+#endif
+
+#if (CLI_ENABLE_SCREEN == TRUE)
+/**
+* @brief 	Command: Run the command periodically on the live screen.
+* @note 	`watch [-n MS] COMMAND ...`: only the changed cells of the
+*       	output are sent. The header shows the bytes of the last frame
+*       	and of the same frame drawn from a clear screen. 'q' or Ctrl+C
+*       	stops it.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Function success or error code.
+* @retval 	(0) if success.
+* @retval   Error code (!0) if error.
+*/
+int cli_function_watch(cli_t *cli, int argc, char* argv[]) {
+	int first = 1;
+	int period = 1000;
+	if ((argc > 2) && !strcmp(argv[1], "-n")) {
+		period = atoi(argv[2]);
+		first = 3;
+	}
+	if ((argc <= first) || (period <= 0)) {
+		cli_printf(cli, "Usage: %s [-n MS] COMMAND ...\r\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	char *line = cli_scratch_join(cli, argc - first, &argv[first]);
+	if (line == NULL) {
+		cli_printf(cli, "The arguments do not fit in the scratch arena. Change the value of CLI_SCRATCH_SIZE in the 'opt.h' file.\r\n");
+		return EXIT_FAILURE;
+	}
+	if (cli_screen_open(cli, period, cli_function_watch_refresh) == NULL) {
+		cli_printf(cli, "The screen is used by another instance\r\n");
+		return EXIT_FAILURE;
+	}
+	strncpy(cli_watch.Line, line, sizeof(cli_watch.Line) - 1);
+	cli_watch.Period = period;
+	return EXIT_SUCCESS;
+}
+
+/**
+* @brief 	Draw the next frame of 'watch': the header and the output of the command.
+*/
+static int cli_function_watch_refresh(cli_t *cli, cli_screen_t *screen, int key) {
+	if (key) {
+		return 0;
+	}
+	cli_screen_clear(screen);
+	cli_screen_attr(screen, CLI_SCREEN_REVERSE);
+	for (int col = 0; col < CLI_SCREEN_COLS; col++) {
+		cli_screen_put(screen, 0, col, ' ');
+	}
+	cli_screen_printf(screen, 0, 0, "Every %dms: %s", cli_watch.Period, cli_watch.Line);
+	char bytes[24];
+	int length = snprintf(bytes, sizeof(bytes), "%u/%u bytes", screen->FrameBytes, screen->FrameFullBytes);
+	cli_screen_text(screen, 0, CLI_SCREEN_COLS - length, bytes);
+	cli_screen_attr(screen, 0);
+
+	cli_watch.Row = 2;
+	cli_watch.Col = 0;
+	cli_watch.Escape = 0;
+	cli_capture_t capture = {.Sink = cli_function_watch_sink, .Context = screen};
+	cli_exec_capture(cli, cli_watch.Line, &capture);
+	return 0;
+}
+
+/**
+* @brief 	Put the output of the watched command on the screen. The
+*       	escape sequences are skipped.
+*/
+static int cli_function_watch_sink(void *context, const char *data, int length) {
+	cli_screen_t *screen = context;
+	for (int i = 0; i < length; i++) {
+		char symbol = data[i];
+		if (cli_watch.Escape == 1) {
+			cli_watch.Escape = (symbol == Key_CONTROL) ? 2 : 0;
+		} else if (cli_watch.Escape == 2) {
+			cli_watch.Escape = (symbol < 0x40) || (symbol > 0x7E);
+			cli_watch.Escape *= 2;
+		} else if (symbol == Key_ESC) {
+			cli_watch.Escape = 1;
+		} else if (symbol == Key_CR) {
+			cli_watch.Col = 0;
+		} else if (symbol == '\n') {
+			cli_watch.Row++;
+			cli_watch.Col = 0;
+		} else {
+			cli_screen_put(screen, cli_watch.Row, cli_watch.Col++, symbol);
+		}
+	}
+	return length;
+}
+#endif
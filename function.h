@@ -44,5 +44,46 @@ SOFTWARE.
 
 int cli_function_help(cli_t *cli, int argc, char* argv[]);
 int cli_function_clear(cli_t *cli, int argc, char* argv[]);
+#if (CLI_ENABLE_WORKERS == TRUE)
+int cli_function_jobs(cli_t *cli, int argc, char* argv[]);
+int cli_function_wait(cli_t *cli, int argc, char* argv[]);
+#endif
+#if (CLI_ENABLE_PLUGINS == TRUE)
+int cli_function_load(cli_t *cli, int argc, char* argv[]);
+int cli_function_unload(cli_t *cli, int argc, char* argv[]);
+#endif
+#if (CLI_ENABLE_VARIABLES == TRUE)
+int cli_function_set(cli_t *cli, int argc, char* argv[]);
+int cli_function_unset(cli_t *cli, int argc, char* argv[]);
+int cli_function_env(cli_t *cli, int argc, char* argv[]);
+#endif
+#if (CLI_ENABLE_ALIASES == TRUE)
+int cli_function_alias(cli_t *cli, int argc, char* argv[]);
+int cli_function_unalias(cli_t *cli, int argc, char* argv[]);
+#if (CLI_ENABLE_COMPLETION == TRUE)
+int cli_complete_unalias(cli_t *cli, int argc, char* argv[], cli_complete_t *complete);
+#endif
+#endif
+#if (CLI_ENABLE_EMIT == TRUE)
+int cli_function_format(cli_t *cli, int argc, char* argv[]);
+#if (CLI_ENABLE_COMPLETION == TRUE)
+int cli_complete_format(cli_t *cli, int argc, char* argv[], cli_complete_t *complete);
+#endif
+#endif
+#if (CLI_ENABLE_STATS == TRUE)
+int cli_function_stats(cli_t *cli, int argc, char* argv[]);
+#endif
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+int cli_function_more(cli_t *cli, int argc, char* argv[]);
+#if (CLI_ENABLE_COMPLETION == TRUE)
+int cli_complete_more(cli_t *cli, int argc, char* argv[], cli_complete_t *complete);
+#endif
+#endif
+#if (CLI_ENABLE_SCREEN == TRUE)
+int cli_function_watch(cli_t *cli, int argc, char* argv[]);
+#endif
+#if (CLI_ENABLE_TRACE == TRUE)
+int cli_function_trace(cli_t *cli, int argc, char* argv[]);
+#endif
 
 #endif /* CLI_FUNCTION_H_ */
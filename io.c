@@ -31,6 +31,7 @@ SOFTWARE.
 
 #include "io.h"
 #include "opt.h"
+#include "cli.h"
 
 /* For HAL STM32 */
 #if (CLI_FOR_STM32_HAL == TRUE)
@@ -39,6 +40,74 @@ SOFTWARE.
 /* Parameter */	
 #define CLI_UART huart1
 
+#if (CLI_USE_RING_BUFFER == TRUE)
+/* The interrupts feed the rings of 'cli0' */
+static uint8_t cli_rx_byte;
+static uint8_t cli_tx_block[16];
+
+static void cli_uart_transmit(void) {
+	int length = cli_tx_pop(&cli0, cli_tx_block, sizeof(cli_tx_block));
+	if (length) {
+		HAL_UART_Transmit_IT(&CLI_UART, cli_tx_block, length);
+	}
+}
+
+int __io_cli_start(void) {
+	HAL_UART_Receive_IT(&CLI_UART, &cli_rx_byte, 1);
+	return 0;
+}
+
+int __io_cli_txstart(void) {
+	/* The ring has only one consumer: do not race with the interrupt */
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (CLI_UART.gState == HAL_UART_STATE_READY) {
+		cli_uart_transmit();
+	}
+	__set_PRIMASK(primask);
+	return 0;
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
+	if (huart == &CLI_UART) {
+		cli_rx_push(&cli0, &cli_rx_byte, 1);
+		HAL_UART_Receive_IT(&CLI_UART, &cli_rx_byte, 1);
+	}
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+	if (huart == &CLI_UART) {
+		cli_uart_transmit();
+	}
+}
+
+int __io_cli_wait(int timeout) {
+	/* The interrupt wakes up the core even with PRIMASK set */
+	__disable_irq();
+	if (!cli_pending(&cli0)) {
+		__WFI();
+	}
+	__enable_irq();
+	return 0;
+}
+#endif
+
+uint32_t __io_cli_millis(void) {
+	return HAL_GetTick();
+}
+
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+uint32_t __io_cli_cycles(void) {
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+		/* Start the counter at the first use */
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+	return DWT->CYCCNT;
+}
+#endif
+
 int __io_cli_putchar(int ch) {
 	HAL_UART_Transmit(&CLI_UART, (uint8_t*)&ch, 1, 300);
 	return 0;
@@ -77,3 +146,155 @@ int __io_cli_getchar(void) {
 	return (int)RecievedByte;
 }
 #endif
+
+/* For Linux and other POSIX systems */
+#if (CLI_FOR_POSIX == TRUE)
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#else
+#include <fcntl.h>
+#endif
+#if (CLI_USE_RING_BUFFER == TRUE)
+#include <pthread.h>
+#endif
+
+static struct termios cli_termios;
+/* Descriptors for waking up the CLI: eventfd or pipe [read, write] */
+static int cli_wakeup_fd[2] = { -1, -1 };
+
+static void cli_posix_restore(void) {
+	tcsetattr(STDIN_FILENO, TCSANOW, &cli_termios);
+}
+
+#if (CLI_USE_RING_BUFFER == TRUE)
+/* The thread takes the part of the receive interrupt: it reads the standard
+ * input into the receive ring of 'cli0'. It reads no more than the ring has
+ * room for, so the rest waits in the terminal (or the pipe) instead of
+ * being dropped. */
+static void *cli_posix_reader(void *arg) {
+	cli_t *cli = arg;
+	uint8_t block[64];
+	for (;;) {
+		unsigned int space = cli_ring_space(&cli->Rx);
+		if (space == 0) {
+			/* 'cli_handler' makes room */
+			struct timespec pause = { .tv_sec = 0, .tv_nsec = 1000000 };
+			nanosleep(&pause, NULL);
+			continue;
+		}
+		if (space > sizeof(block)) {
+			space = sizeof(block);
+		}
+		ssize_t length = read(STDIN_FILENO, block, space);
+		if (length > 0) {
+			cli_rx_push(cli, block, (int)length);
+		} else if ((length == 0) || (errno != EINTR)) {
+			/* End of the input */
+			return NULL;
+		}
+	}
+}
+#endif
+
+int __io_cli_start(void) {
+	if (cli_wakeup_fd[0] >= 0) return 0;
+	/* The CLI itself does the echo and the line editing */
+	if (tcgetattr(STDIN_FILENO, &cli_termios) == 0) {
+		struct termios raw = cli_termios;
+		raw.c_lflag &= ~(ICANON | ECHO);
+		raw.c_iflag &= ~(ICRNL | IXON);
+		raw.c_cc[VMIN] = 1;
+		raw.c_cc[VTIME] = 0;
+		tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+		atexit(cli_posix_restore);
+	}
+#ifdef __linux__
+	cli_wakeup_fd[0] = cli_wakeup_fd[1] = eventfd(0, EFD_NONBLOCK);
+#else
+	if (pipe(cli_wakeup_fd) != 0) {
+		cli_wakeup_fd[0] = cli_wakeup_fd[1] = -1;
+	}
+	/* A full pipe already wakes the CLI up: the writers must not block */
+	for (int i = 0; i < 2; i++) {
+		fcntl(cli_wakeup_fd[i], F_SETFL, fcntl(cli_wakeup_fd[i], F_GETFL) | O_NONBLOCK);
+	}
+#endif
+#if (CLI_USE_RING_BUFFER == TRUE)
+	pthread_t reader;
+	if (pthread_create(&reader, NULL, cli_posix_reader, &cli0) == 0) {
+		pthread_detach(reader);
+	}
+#endif
+	return 0;
+}
+
+uint32_t __io_cli_millis(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+uint32_t __io_cli_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return (uint32_t)__builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+	uint64_t ticks;
+	__asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+	return (uint32_t)ticks;
+#else
+	/* No counter available to the user: nanoseconds */
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+#endif
+}
+
+int __io_cli_putchar(int ch) {
+	char symbol = (char)ch;
+	return (write(STDOUT_FILENO, &symbol, 1) == 1) ? 0 : -1;
+}
+
+int __io_cli_getchar(void) {
+	unsigned char ch = 0;
+	struct pollfd fd = { .fd = STDIN_FILENO, .events = POLLIN };
+	if ((poll(&fd, 1, 0) > 0) && (read(STDIN_FILENO, &ch, 1) == 1)) {
+		return ch;
+	}
+	return 0;
+}
+
+int __io_cli_wait(int timeout) {
+	struct pollfd fds[] = {
+		{ .fd = cli_wakeup_fd[0], .events = POLLIN },
+#if (CLI_USE_RING_BUFFER != TRUE)
+		/* With the ring the input is taken by the reader, which wakes us up */
+		{ .fd = STDIN_FILENO, .events = POLLIN },
+#endif
+	};
+	if (poll(fds, sizeof(fds) / sizeof(fds[0]), timeout) < 0) {
+		return -1;
+	}
+	if (fds[0].revents & POLLIN) {
+		/* The eventfd is cleared by one read, the pipe is drained */
+		uint64_t value;
+		while (read(cli_wakeup_fd[0], &value, sizeof(value)) > 0);
+	}
+	return 0;
+}
+
+int __io_cli_wakeup(void) {
+	uint64_t value = 1;
+	if ((write(cli_wakeup_fd[1], &value, sizeof(value)) < 0) && (errno != EAGAIN)) {
+		/* EAGAIN: the CLI has been woken up already */
+		return -1;
+	}
+	return 0;
+}
+#endif
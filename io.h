@@ -32,6 +32,8 @@ SOFTWARE.
 #ifndef CLI_IO_H_
 #define CLI_IO_H_
 
+#include <stdint.h>
+
 /**
 * @brief    Writes a character ch to CLI.
 * @param  	ch Number of arguments passed to the function.
@@ -44,4 +46,50 @@ extern int __io_cli_putchar(int ch) __attribute__((weak));
 */
 extern int __io_cli_getchar(void) __attribute__((weak));
 
+/**
+* @brief    Starts the transmission of the CLI transmit ring.
+* @note     Used with `CLI_USE_RING_BUFFER`. Usually enables the "transmit
+*           empty" interrupt, which takes the bytes with `cli_tx_pop`.
+*           If not defined, the ring is emptied through `__io_cli_putchar`.
+*/
+extern int __io_cli_txstart(void) __attribute__((weak));
+
+/**
+* @brief    Prepares the port for work (for example, starts the reception
+*           into the CLI receive ring).
+* @note     Called from `cli_init` for every instance.
+*/
+extern int __io_cli_start(void) __attribute__((weak));
+
+/**
+* @brief    Sleeps until a symbol is received, `__io_cli_wakeup` is called
+*           or the timeout expires.
+* @note     Called from `cli_wait` when the CLI has no work. Must not sleep
+*           if a symbol has arrived since the check (use `cli_pending`
+*           with the interrupts disabled).
+* @param    timeout Maximum time to sleep, ms. (-1) to sleep without limit.
+*/
+extern int __io_cli_wait(int timeout) __attribute__((weak));
+
+/**
+* @brief    Wakes up the CLI sleeping in `__io_cli_wait`.
+* @note     Called from `cli_rx_push` and `cli_log`, so it must be safe to
+*           call from interrupts and other tasks.
+*/
+extern int __io_cli_wakeup(void) __attribute__((weak));
+
+/**
+* @brief    Time source for the timeouts of the CLI.
+* @return   `uint32_t` Milliseconds from any moment, wraps around.
+*/
+extern uint32_t __io_cli_millis(void) __attribute__((weak));
+
+/**
+* @brief    Cycle counter for the timestamps of the trace (`CLI_ENABLE_TRACE`).
+* @note     Called for every traced event, so it must be fast. If not
+*           defined, the trace uses `__io_cli_millis`.
+* @return   `uint32_t` Cycles (or other ticks) from any moment, wraps around.
+*/
+extern uint32_t __io_cli_cycles(void) __attribute__((weak));
+
 #endif /* CLI_IO_H_ */
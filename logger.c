@@ -0,0 +1,162 @@
+/*
+*******************************************************************************
+@file	logger.c
+@brief	Thread-safe asynchronous log of the CLI.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+
+#if (CLI_ENABLE_LOG == TRUE)
+
+#define CLI_LOG_MASK (CLI_LOG_QUEUE_SIZE - 1)
+
+static cli_log_record_t *cli_log_reserve(cli_log_t *queue, unsigned int *position);
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Initial configuration of the log queue.
+* @param 	queue Is a pointer (`cli_log_t`) to the queue to be worked on.
+*
+*/
+void cli_log_init(cli_log_t *queue) {
+	for (unsigned int i = 0; i < CLI_LOG_QUEUE_SIZE; i++) {
+		cli_atomic_store(&queue->Records[i].Sequence, i);
+	}
+	cli_atomic_store(&queue->Enqueue, 0);
+	cli_atomic_store(&queue->Dequeue, 0);
+	cli_atomic_store(&queue->Posted, 0);
+	cli_atomic_store(&queue->Dropped, 0);
+	cli_atomic_store(&queue->Overwritten, 0);
+	queue->Reported = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Put a record in the log queue.
+* @note 	Can be called from any task at the same time. Never blocks: if the
+*       	queue is full, the record is dropped, or, with `CLI_LOG_OVERWRITE`,
+*       	the oldest record is discarded to make room for it.
+* @param 	queue Is a pointer (`cli_log_t`) to the queue to be worked on.
+* @param	format Format string.
+* @param	args Arguments of the format string.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the record was dropped.
+*/
+int cli_log_post(cli_log_t *queue, const char *format, va_list args) {
+	unsigned int position;
+	cli_log_record_t *record = cli_log_reserve(queue, &position);
+#if (CLI_LOG_OVERWRITE == TRUE)
+	if (record == NULL) {
+		/* Discard the oldest record, acting as a consumer */
+		unsigned int oldest;
+		cli_log_record_t *old = cli_log_claim(queue, &oldest);
+		if (old != NULL) {
+			cli_log_release(queue, old, oldest);
+			cli_atomic_add(&queue->Overwritten, 1);
+		}
+		record = cli_log_reserve(queue, &position);
+	}
+#endif
+	if (record == NULL) {
+		cli_atomic_add(&queue->Dropped, 1);
+		return CLI_ERROR;
+	}
+	int nchar = cli_vsnprintf(record->Text, sizeof(record->Text), format, args);
+	if (nchar < 0) {
+		record->Text[0] = 0;
+	}
+	/* Publish the record */
+	cli_atomic_store(&record->Sequence, position + 1);
+	cli_atomic_add(&queue->Posted, 1);
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the oldest record from the queue.
+* @note 	The record stays valid until `cli_log_release`.
+* @param 	queue Is a pointer (`cli_log_t`) to the queue to be worked on.
+* @param	position Position of the record, to be passed to `cli_log_release`.
+* @return	`cli_log_record_t*` The record or NULL if the queue is empty.
+*/
+cli_log_record_t *cli_log_claim(cli_log_t *queue, unsigned int *position) {
+	unsigned int pos = cli_atomic_load(&queue->Dequeue);
+	while (1) {
+		cli_log_record_t *record = &queue->Records[pos & CLI_LOG_MASK];
+		int dif = (int)(cli_atomic_load(&record->Sequence) - (pos + 1));
+		if (dif == 0) {
+			if (cli_atomic_cas(&queue->Dequeue, &pos, pos + 1)) {
+				*position = pos;
+				return record;
+			}
+		} else if (dif < 0) {
+			/* Empty, or the oldest record is still being written */
+			return NULL;
+		} else {
+			pos = cli_atomic_load(&queue->Dequeue);
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Return the cell of the printed record to the producers.
+* @param 	queue Is a pointer (`cli_log_t`) to the queue to be worked on.
+* @param	record The record from `cli_log_claim`.
+* @param	position Position of the record from `cli_log_claim`.
+*
+*/
+void cli_log_release(cli_log_t *queue, cli_log_record_t *record, unsigned int position) {
+	cli_atomic_store(&record->Sequence, position + CLI_LOG_QUEUE_SIZE);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Reserve a free cell for the new record.
+* @param 	queue Is a pointer (`cli_log_t`) to the queue to be worked on.
+* @param	position Position of the reserved cell.
+* @return	`cli_log_record_t*` The cell or NULL if the queue is full.
+*/
+static cli_log_record_t *cli_log_reserve(cli_log_t *queue, unsigned int *position) {
+	unsigned int pos = cli_atomic_load(&queue->Enqueue);
+	while (1) {
+		cli_log_record_t *record = &queue->Records[pos & CLI_LOG_MASK];
+		int dif = (int)(cli_atomic_load(&record->Sequence) - pos);
+		if (dif == 0) {
+			if (cli_atomic_cas(&queue->Enqueue, &pos, pos + 1)) {
+				*position = pos;
+				return record;
+			}
+		} else if (dif < 0) {
+			return NULL;
+		} else {
+			pos = cli_atomic_load(&queue->Enqueue);
+		}
+	}
+}
+#endif
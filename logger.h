@@ -0,0 +1,79 @@
+/*
+*******************************************************************************
+@file	logger.h
+@brief	Thread-safe asynchronous log of the CLI. Records are put into a
+		lock-free multi-producer queue and printed by `cli_handler`.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_LOGGER_H_
+#define CLI_LOGGER_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdarg.h>  /* For 'va_list' */
+
+#include "opt.h"
+#include "atomic.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Log record Structure definition
+ */
+typedef struct {
+	cli_atomic_t Sequence;                 // State of the cell in the queue
+	char Text[CLI_LOG_RECORD_SIZE];        // Zero-terminated text of the record
+} cli_log_record_t;
+
+/*
+ * @brief	Log queue Structure definition
+ * @note	Bounded multi-producer queue (D. Vyukov). Each cell has its own
+ *      	sequence number, so the producers only compete for the `Enqueue`
+ *      	index and never wait for each other or for the CLI task.
+ */
+typedef struct {
+	cli_log_record_t Records[CLI_LOG_QUEUE_SIZE]; // Cells of the queue
+	cli_atomic_t Enqueue;                  // Position of the next record to write
+	cli_atomic_t Dequeue;                  // Position of the next record to print
+	cli_atomic_t Posted;                   // Number of the records accepted
+	cli_atomic_t Dropped;                  // Number of the new records lost because the queue was full
+	cli_atomic_t Overwritten;              // Number of the old records replaced by the new ones
+	unsigned int Reported;                 // Number of the lost records already reported
+} cli_log_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'logger.c'. */
+/* Function instances ------------------------------------------------------ */
+void cli_log_init(cli_log_t *queue);
+int cli_log_post(cli_log_t *queue, const char *format, va_list args);
+cli_log_record_t *cli_log_claim(cli_log_t *queue, unsigned int *position);
+void cli_log_release(cli_log_t *queue, cli_log_record_t *record, unsigned int position);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_LOGGER_H_ */
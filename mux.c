@@ -0,0 +1,394 @@
+/*
+*******************************************************************************
+@file	mux.c
+@brief	Virtual channels over one UART: several instances and log
+		streams in frames with the flow control and priority of each channel.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "mux.h"
+
+#if (CLI_ENABLE_MUX == TRUE)
+
+/*
+ * @brief	Channel of the link
+ */
+typedef struct {
+	cli_t *Cli;                            // Instance of the channel or NULL for the stream
+	cli_mux_receive_t Receive;             // Receiver of the stream
+	cli_ring_t Tx;                         // Output of the stream
+	uint8_t TxData[CLI_MUX_STREAM_SIZE];   // Storage of the output of the stream
+	uint8_t Bound;                         // The channel is in use
+	uint8_t Priority;                      // The higher one is sent first
+	volatile uint8_t Paused;               // The other side asked to stop sending
+	volatile uint8_t Stopped;              // The other side was asked to stop sending
+	volatile uint8_t Control;              // Control frame to send: CLI_MUX_STOP/GO + 1, 0 - none
+} cli_mux_channel_t;
+
+/*
+ * @brief	The link: one per UART.
+ * @note	`cli_mux_receive` and `cli_mux_transmit` can be called from the
+ *      	interrupts of the UART, the rest is called from the main loop.
+ */
+static struct {
+	cli_mux_channel_t Channels[CLI_MUX_CHANNELS];
+	int (*TxStart)(void);                  // Start the transmission of the UART
+	int Channel;                           // Channel of the received frame, -1 - expected, -2 - skipped
+	int Escape;                            // The escape byte is received
+	int Last;                              // Channel of the last data frame
+	int Head;                              // Sent bytes of the frame
+	int Length;                            // Length of the frame
+	uint8_t Frame[4 + 2 * CLI_MUX_FRAME];  // Frame being sent
+} cli_mux;
+
+static int cli_mux_txstart(void);
+static int cli_mux_frame(void);
+static void cli_mux_deliver(int channel, const uint8_t *data, int length);
+static void cli_mux_flow(int channel);
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Start the link with all the channels unbound.
+* @param	txstart Function that starts the transmission of the UART,
+*       	which then takes the bytes with `cli_mux_transmit`. Can be
+*       	NULL if the port calls `cli_mux_transmit` by itself.
+* @retval 	`CLI_OK` (0) if success.
+*/
+int cli_mux_init(int (*txstart)(void)) {
+	memset(&cli_mux, 0, sizeof(cli_mux));
+	cli_mux.TxStart = txstart;
+	cli_mux.Channel = -2;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Bind the instance to the channel: its rings are the data of
+*       	the channel instead of the UART.
+* @param	channel Number of the channel.
+* @param	cli Is a pointer (`cli_t`) to the instance, after `cli_init`.
+* @param	priority Priority of its output, the higher one goes first.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the channel is incorrect.
+*/
+int cli_mux_bind(int channel, cli_t *cli, int priority) {
+	if ((channel < 0) || (channel >= CLI_MUX_CHANNELS) || (cli == NULL)) {
+		return CLI_ERROR;
+	}
+	cli_mux_channel_t *ch = &cli_mux.Channels[channel];
+	ch->Cli = cli;
+	ch->Receive = NULL;
+	ch->Priority = priority;
+	ch->Bound = 1;
+	cli->_io_txstart = cli_mux_txstart;
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+	/* The channel is stopped by the control frames, XON and XOFF are data */
+	cli_raw(cli, CLI_RAW_RX);
+#endif
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Bind the stream to the channel: a log or a machine protocol.
+* @note 	The output is written by `cli_mux_write`. On the host the same
+*       	streams take the channels of the board apart.
+* @param	channel Number of the channel.
+* @param	priority Priority of its output, the higher one goes first.
+* @param	receive Receiver of the data of the channel or NULL.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the channel is incorrect.
+*/
+int cli_mux_bind_stream(int channel, int priority, cli_mux_receive_t receive) {
+	if ((channel < 0) || (channel >= CLI_MUX_CHANNELS)) {
+		return CLI_ERROR;
+	}
+	cli_mux_channel_t *ch = &cli_mux.Channels[channel];
+	ch->Cli = NULL;
+	ch->Receive = receive;
+	ch->Priority = priority;
+	ch->Bound = 1;
+	cli_ring_init(&ch->Tx, ch->TxData, sizeof(ch->TxData));
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Send the data to the stream channel.
+* @note 	Never blocks: what does not fit is dropped, so a fast log
+*       	cannot stop the program.
+* @param	channel Number of the channel.
+* @param	data Bytes.
+* @param	length Number of bytes.
+* @return	`int` Number of bytes taken.
+*/
+int cli_mux_write(int channel, const void *data, int length) {
+	if ((channel < 0) || (channel >= CLI_MUX_CHANNELS) || (cli_mux.Channels[channel].Cli != NULL)) {
+		return 0;
+	}
+	int count = cli_ring_write(&cli_mux.Channels[channel].Tx, data, length);
+	if (count) {
+		cli_mux_txstart();
+	}
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the bytes received by the UART apart into the channels.
+* @note 	Called from the receive interrupt or the main loop. The data of
+*       	the instance goes to its receive ring (`cli_rx_push`).
+* @param	data Received bytes.
+* @param	length Number of bytes.
+* @return	`int` Number of bytes taken.
+*/
+int cli_mux_receive(const uint8_t *data, int length) {
+	uint8_t run[CLI_MUX_FRAME];
+	int count = 0;
+	for (int i = 0; i < length; i++) {
+		uint8_t byte = data[i];
+		if (byte == CLI_MUX_FLAG) {
+			/* The end of the frame and the start of the next one */
+			cli_mux_deliver(cli_mux.Channel, run, count);
+			count = 0;
+			cli_mux.Channel = -1;
+			cli_mux.Escape = 0;
+			continue;
+		}
+		if (byte == CLI_MUX_ESCAPE) {
+			cli_mux.Escape = 1;
+			continue;
+		}
+		if (cli_mux.Escape) {
+			byte ^= 0x20;
+			cli_mux.Escape = 0;
+		}
+		if (cli_mux.Channel == -1) {
+			int channel = byte & ~CLI_MUX_CONTROL;
+			cli_mux.Channel = ((channel < CLI_MUX_CHANNELS) && cli_mux.Channels[channel].Bound) ? byte : -2;
+			continue;
+		}
+		if (cli_mux.Channel < 0) {
+			/* Lost start of the frame or unknown channel */
+			continue;
+		}
+		if (cli_mux.Channel & CLI_MUX_CONTROL) {
+			cli_mux_channel_t *ch = &cli_mux.Channels[cli_mux.Channel & ~CLI_MUX_CONTROL];
+			ch->Paused = (byte == CLI_MUX_STOP);
+			if (!ch->Paused) {
+				cli_mux_txstart();
+			}
+			continue;
+		}
+		run[count++] = byte;
+		if (count == sizeof(run)) {
+			cli_mux_deliver(cli_mux.Channel, run, count);
+			count = 0;
+		}
+	}
+	cli_mux_deliver(cli_mux.Channel, run, count);
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the next bytes to be sent by the UART.
+* @note 	Called from the transmit interrupt or the main loop. The
+*       	control frames go first, then the data of the channel with
+*       	the highest priority; the channels of the same priority take
+*       	turns. A frame is at most `CLI_MUX_FRAME` bytes of data, so the
+*       	echo of the shell waits for at most one frame of a log.
+* @param	data Buffer for the bytes.
+* @param	size Size of the buffer.
+* @return	`int` Number of bytes, (0) if there is nothing to send.
+*/
+int cli_mux_transmit(uint8_t *data, int size) {
+	int count = 0;
+	while (count < size) {
+		if ((cli_mux.Head == cli_mux.Length) && !cli_mux_frame()) {
+			break;
+		}
+		int length = cli_mux.Length - cli_mux.Head;
+		if (length > size - count) {
+			length = size - count;
+		}
+		memcpy(&data[count], &cli_mux.Frame[cli_mux.Head], length);
+		cli_mux.Head += length;
+		count += length;
+	}
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check the receive rings of the instances: the other side is
+*       	asked to stop when a ring is almost full and to go on when it
+*       	is read.
+* @note 	Called from the main loop after `cli_handler` or `cli_poll_all`.
+* @return	`int` (1) if there is data to send, otherwise (0).
+*/
+int cli_mux_poll(void) {
+	int pending = 0;
+	for (int channel = 0; channel < CLI_MUX_CHANNELS; channel++) {
+		cli_mux_channel_t *ch = &cli_mux.Channels[channel];
+		if (!ch->Bound) continue;
+		cli_mux_flow(channel);
+		if (ch->Control || (!ch->Paused && cli_ring_count((ch->Cli != NULL) ? &ch->Cli->Tx : &ch->Tx))) {
+			pending = 1;
+		}
+	}
+	if (pending || (cli_mux.Head != cli_mux.Length)) {
+		cli_mux_txstart();
+		return 1;
+	}
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Start the transmission: `_io_txstart` of the bound instances.
+* @retval 	`CLI_OK` (0) if success.
+*/
+static int cli_mux_txstart(void) {
+	if (cli_mux.TxStart != NULL) {
+		return cli_mux.TxStart();
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Put the next frame in the buffer.
+* @return	`int` (1) if there is a frame, (0) if there is nothing to send.
+*/
+static int cli_mux_frame(void) {
+	uint8_t payload[CLI_MUX_FRAME];
+	int channel = -1;
+	int length = 0;
+	/* The control frames go first: they free the other side */
+	for (int i = 0; (i < CLI_MUX_CHANNELS) && (channel < 0); i++) {
+		cli_mux_channel_t *ch = &cli_mux.Channels[i];
+		if (ch->Control) {
+			payload[length++] = ch->Control - 1;
+			ch->Control = 0;
+			channel = i | CLI_MUX_CONTROL;
+		}
+	}
+	/* The highest priority, the channels of the same one take turns.
+	 * The output of an instance is taken by 'cli_tx_pop': it can be held
+	 * (the pager, 'cli_tx_hold'), then the next channel is tried. */
+	uint64_t tried = 0;
+	while (channel < 0) {
+		int best = -1;
+		for (int i = 1; i <= CLI_MUX_CHANNELS; i++) {
+			int index = (cli_mux.Last + i) % CLI_MUX_CHANNELS;
+			cli_mux_channel_t *ch = &cli_mux.Channels[index];
+			if (!ch->Bound || ch->Paused || (tried & ((uint64_t)1 << index))) continue;
+			if ((ch->Cli == NULL) && !cli_ring_count(&ch->Tx)) continue;
+			if ((best < 0) || (ch->Priority > cli_mux.Channels[best].Priority)) {
+				best = index;
+			}
+		}
+		if (best < 0) {
+			return 0;
+		}
+		cli_mux_channel_t *ch = &cli_mux.Channels[best];
+		if (ch->Cli != NULL) {
+			length = cli_tx_pop(ch->Cli, payload, sizeof(payload));
+		} else {
+			length = cli_ring_read(&ch->Tx, payload, sizeof(payload));
+		}
+		tried |= (uint64_t)1 << best;
+		if (length) {
+			cli_mux.Last = best;
+			channel = best;
+		}
+	}
+	/* The channel is below ESCAPE and FLAG, only the payload is escaped */
+	int size = 0;
+	cli_mux.Frame[size++] = CLI_MUX_FLAG;
+	cli_mux.Frame[size++] = channel;
+	for (int i = 0; i < length; i++) {
+		if ((payload[i] == CLI_MUX_FLAG) || (payload[i] == CLI_MUX_ESCAPE)) {
+			cli_mux.Frame[size++] = CLI_MUX_ESCAPE;
+			cli_mux.Frame[size++] = payload[i] ^ 0x20;
+		} else {
+			cli_mux.Frame[size++] = payload[i];
+		}
+	}
+	cli_mux.Frame[size++] = CLI_MUX_FLAG;
+	cli_mux.Head = 0;
+	cli_mux.Length = size;
+	return 1;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Give the received data to the channel.
+* @param	channel Channel of the frame, control frames and (<0) are skipped.
+* @param	data Bytes.
+* @param	length Number of bytes.
+*
+*/
+static void cli_mux_deliver(int channel, const uint8_t *data, int length) {
+	if ((channel < 0) || (channel & CLI_MUX_CONTROL) || !length) {
+		return;
+	}
+	cli_mux_channel_t *ch = &cli_mux.Channels[channel];
+	if (ch->Cli != NULL) {
+		cli_rx_push(ch->Cli, data, length);
+		cli_mux_flow(channel);
+	} else if (ch->Receive != NULL) {
+		ch->Receive(channel, data, length);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Ask the other side to stop or go on by the free space of the
+*       	receive ring of the instance.
+* @param	channel Number of the channel.
+*
+*/
+static void cli_mux_flow(int channel) {
+	cli_mux_channel_t *ch = &cli_mux.Channels[channel];
+	if (ch->Cli == NULL) {
+		return;
+	}
+	unsigned int space = cli_ring_space(&ch->Cli->Rx);
+	if (!ch->Stopped && (space < CLI_RX_RING_SIZE / 4)) {
+		ch->Stopped = 1;
+		ch->Control = CLI_MUX_STOP + 1;
+		cli_mux_txstart();
+	} else if (ch->Stopped && (space > CLI_RX_RING_SIZE / 2)) {
+		ch->Stopped = 0;
+		ch->Control = CLI_MUX_GO + 1;
+		cli_mux_txstart();
+	}
+}
+
+#endif /* CLI_ENABLE_MUX */
@@ -0,0 +1,74 @@
+/*
+*******************************************************************************
+@file	mux.h
+@brief	Virtual channels over one UART: several instances and log
+		streams in frames with the flow control and priority of each channel.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_MUX_H_
+#define CLI_MUX_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "cli.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Define ------------------------------------------------------------------ */
+/*
+ * Frame: FLAG, channel, payload, FLAG. FLAG and ESCAPE inside the frame are
+ * sent as ESCAPE and the byte XOR 0x20. A channel with the CONTROL bit is a
+ * control frame: the payload is STOP or GO for the data of the channel.
+ */
+#define CLI_MUX_FLAG               0x7E
+#define CLI_MUX_ESCAPE             0x7D
+#define CLI_MUX_CONTROL            0x80
+#define CLI_MUX_GO                 0x00
+#define CLI_MUX_STOP               0x01
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Receiver of the data of the stream channel
+ */
+typedef void (*cli_mux_receive_t)(int channel, const uint8_t *data, int length);
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'mux.c'. */
+/* Function instances ------------------------------------------------------ */
+int cli_mux_init(int (*txstart)(void));
+int cli_mux_bind(int channel, cli_t *cli, int priority);
+int cli_mux_bind_stream(int channel, int priority, cli_mux_receive_t receive);
+int cli_mux_write(int channel, const void *data, int length);
+int cli_mux_receive(const uint8_t *data, int length);
+int cli_mux_transmit(uint8_t *data, int size);
+int cli_mux_poll(void);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_MUX_H_ */
@@ -44,21 +44,79 @@ SOFTWARE.
 /* Prefix reflected on the console screen */
 #define CLI_PREFIX                ">"
 
-/* Buffer size for commands and console */
+/* Visible width of the prefix, for the cursor positioning.
+ * Set it by hand if the prefix contains escape sequences (colors). */
+#define CLI_PREFIX_WIDTH           (sizeof(CLI_PREFIX) - 1)
+
+/* Buffer size for commands and console: the longest line + 1. */
 #define CLI_BUFFER_SIZE            32
 
+/* The line starts in a small buffer of the instance and grows in blocks of
+ * the pool shared by all the instances. The history is kept in the pool too. */
+#define CLI_ENABLE_LINE_POOL       FALSE
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+/* Size of the buffer in the instance, enough for most of the lines. */
+#define CLI_LINE_INLINE            32
+/* Size of one block of the pool. */
+#define CLI_POOL_BLOCK_SIZE        16
+/* Number of the blocks of the pool. Must be a multiple of 32. */
+#define CLI_POOL_BLOCKS            64
+#endif
+
+/* Scratch arena of each instance: the arguments of the running command, the
+ * line after the variables are put in and 'cli_scratch_alloc' of the commands.
+ * It is given back when the command returns. 'stats' shows the peak use. */
+#define CLI_SCRATCH_SIZE           128
+
+/* Compact layout of the instance: the narrowest types for the indexes and the
+ * commands kept by a pointer to their descriptors ('CLI_COMMAND_DEFINE' puts
+ * them in the constant data). */
+#define CLI_COMPACT                FALSE
+#if (CLI_COMPACT == TRUE)
+/* Descriptors of the commands added by 'cli_add', shared by the instances. */
+#define CLI_COMMAND_POOL           8
+#endif
+
+/* Most bytes one instance may take, checked when compiled. 0 - no check. */
+#define CLI_INSTANCE_BUDGET        0
+
 /* Maximum number of possible commands */
 #define CLI_MAX_COUNT_COMMAND      8
 
+/* Maximum depth of the groups of commands ('cli_add_group') shown by 'help'. */
+#define CLI_COMMAND_DEPTH          4
+
 /* Maximum number to write to the command run history.
  * Compilation will create a buffer with the size of
  *   (CLI_MAX_COUNT_COMMAND * CLI_BUFFER_SIZE)
  */
 #define CLI_SIZE_HISTORY           8
 
+/* Show the rest of the latest command from the history that continues
+ * the line, faded. Right or End takes it. */
+#define CLI_ENABLE_SUGGEST         FALSE
+
+/* Width of the terminal for the columns of the candidates of Tab. */
+#define CLI_COMPLETION_WIDTH       80
+
+/* Completion of the arguments by the function 'Complete' of the command
+ * ('cli_add_complete'). The candidates are kept in the scratch arena
+ * between the presses of Tab. */
+#define CLI_ENABLE_COMPLETION      FALSE
+#if (CLI_ENABLE_COMPLETION == TRUE)
+/* Completion of the file names ('cli_complete_files'). Only for POSIX systems. */
+#define CLI_COMPLETION_FILES       FALSE
+#endif
+
+/* Maximum number of keys bound by the application ('cli_bind'). 0 - none. */
+#define CLI_KEY_BINDINGS           0
+
 /* Allow dynamic deletion of commands. */
 #define CLI_ENABLE_DELETE_COMMAND  FALSE
 
+/* Count the received and sent bytes and the escape sequences: 'stats'. */
+#define CLI_ENABLE_STATS           FALSE
+
 /* Use the standard assert or light version. */
 #define CLI_USE_FULL_ASSERT        FALSE
 
@@ -70,17 +128,172 @@ SOFTWARE.
 #if (CLI_FOR_STM32_HAL == FLASE)
 #define CLI_FOR_ZYNQ               FALSe
 #endif
+/* Ready-to-use solution for Linux and other POSIX systems. */
+#define CLI_FOR_POSIX              FALSE
+#endif
+
+/* Use lock-free ring buffers between the UART interrupts and 'cli_handler'.
+ * The port fills the receive ring with 'cli_rx_push' and empties the
+ * transmit ring with 'cli_tx_pop'.
+ */
+#define CLI_USE_RING_BUFFER        FALSE
+#if (CLI_USE_RING_BUFFER == TRUE)
+/* Size of the receive and transmit rings. Must be a power of two. */
+#define CLI_RX_RING_SIZE           64
+#define CLI_TX_RING_SIZE           256
+#endif
+
+/* Output flow control ('flow.c'): XON/XOFF from the terminal, the
+ * backpressure of the port ('cli_tx_hold') and the pager ('more on').
+ * Needs 'CLI_USE_RING_BUFFER': the held output waits in the transmit ring. */
+#define CLI_ENABLE_FLOW_CONTROL    FALSE
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+/* Height of the terminal: the pager stops after this many lines minus one. */
+#define CLI_PAGER_ROWS             24
+/* The output of the command is dropped if the far end does not read for
+ * this long, ms. */
+#define CLI_FLOW_TIMEOUT           1000
+#endif
+
+/* Service all the registered instances in turn with 'cli_poll_all': each one
+ * takes and sends a limited number of bytes per turn. */
+#define CLI_ENABLE_POLL_ALL        FALSE
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+/* Maximum number of the registered instances. */
+#define CLI_POLL_INSTANCES         4
+/* Received bytes one instance may take in one turn. */
+#define CLI_POLL_RX_BUDGET         16
+/* Bytes one instance may send in one turn. A command runs to its end, so the
+ * budget is checked between the keys. With the rings, the instance waits for
+ * the next turn until the transmit ring has this much free space. */
+#define CLI_POLL_TX_BUDGET         64
+#endif
+
+/* Virtual channels over one UART ('mux.c'): the instances and the streams
+ * (log, machine protocol) are sent in frames, each channel with its own flow
+ * control and priority. Needs 'CLI_USE_RING_BUFFER'. */
+#define CLI_ENABLE_MUX             FALSE
+#if (CLI_ENABLE_MUX == TRUE)
+/* Number of the channels. */
+#define CLI_MUX_CHANNELS           4
+/* Most bytes of data in one frame: the longest wait of a higher channel. */
+#define CLI_MUX_FRAME              32
+/* Size of the output of the stream channel. Must be a power of two. */
+#define CLI_MUX_STREAM_SIZE        256
+#endif
+
+/* Live screens of the commands ('screen.c'): the command draws the cells of
+ * a framebuffer and only the changed ones are sent. Also the 'watch' command. */
+#define CLI_ENABLE_SCREEN          FALSE
+#if (CLI_ENABLE_SCREEN == TRUE)
+/* Size of the screen. Two frames of 2 bytes per cell are kept. */
+#define CLI_SCREEN_ROWS            24
+#define CLI_SCREEN_COLS            80
+/* Shortest time between the frames, ms. */
+#define CLI_SCREEN_PERIOD          100
+#endif
+
+/* Thread-safe asynchronous log ('cli_log'). */
+#define CLI_ENABLE_LOG             FALSE
+#if (CLI_ENABLE_LOG == TRUE)
+/* Number of records in the queue. Must be a power of two. */
+#define CLI_LOG_QUEUE_SIZE         16
+/* Maximum length of one record. */
+#define CLI_LOG_RECORD_SIZE        64
+/* When the queue is full, replace the oldest record (TRUE)
+ * or drop the new one (FALSE). */
+#define CLI_LOG_OVERWRITE          FALSE
+#endif
+
+/* Run the commands marked with 'CLI_COMMAND_OFFLOAD' (or launched with '&')
+ * in worker threads. Only for POSIX systems (pthreads). */
+#define CLI_ENABLE_WORKERS         FALSE
+#if (CLI_ENABLE_WORKERS == TRUE)
+/* Number of worker threads. */
+#define CLI_WORKER_THREADS         2
+/* Maximum number of jobs at the same time (for all instances). */
+#define CLI_WORKER_JOBS            8
+/* Size of the output buffer of a job. */
+#define CLI_WORKER_OUTPUT_SIZE     1024
+#endif
+
+/* Commands loaded from the shared objects: 'load', 'unload' and
+ * 'cli_plugin_lazy'. Only for POSIX systems (dlopen, pthreads). */
+#define CLI_ENABLE_PLUGINS         FALSE
+#if (CLI_ENABLE_PLUGINS == TRUE)
+/* Places of the registry of the plugin commands at the start,
+ * it grows twice when they are full. */
+#define CLI_PLUGIN_COMMANDS        8
+#endif
+
+/* Command lists 'cmd1; cmd2' and the quotes ('...' or "...") that keep the
+ * spaces and ';' in the arguments. Without them the arguments are split at
+ * the spaces only. */
+#define CLI_ENABLE_COMMAND_LISTS   FALSE
+
+/* Session variables: 'set', 'unset', 'env' and '$NAME' in the command line. */
+#define CLI_ENABLE_VARIABLES       FALSE
+#if (CLI_ENABLE_VARIABLES == TRUE)
+/* Number of slots of the hash table. Must be a power of two,
+ * up to 3/4 of them can be used. */
+#define CLI_VARIABLES_COUNT        16
+/* Size of the arena for the names and values. */
+#define CLI_VARIABLES_ARENA        256
+#endif
+
+/* Aliases: 'alias name='cmd1; cmd2 args'' and 'unalias'. */
+#define CLI_ENABLE_ALIASES         FALSE
+#if (CLI_ENABLE_ALIASES == TRUE)
+/* Maximum number of aliases. */
+#define CLI_ALIAS_COUNT            4
+/* Size of the name and the commands of one alias (up to 255). */
+#define CLI_ALIAS_SIZE             64
+/* Maximum number of commands in one alias. */
+#define CLI_ALIAS_STEPS            4
+/* Maximum depth of the aliases that run other aliases. */
+#define CLI_ALIAS_DEPTH            4
+#endif
+
+/* Structured output of the commands: 'format text|json|cbor'. */
+#define CLI_ENABLE_EMIT            FALSE
+#if (CLI_ENABLE_EMIT == TRUE)
+/* Maximum depth of the nested objects and arrays. */
+#define CLI_EMIT_DEPTH             8
+#endif
+
+/* Trace of the received and sent bytes and of the commands with the cycle
+ * counter timestamps: the command 'trace' and 'cli_trace_replay()'. */
+#define CLI_ENABLE_TRACE           FALSE
+#if (CLI_ENABLE_TRACE == TRUE)
+/* Number of the events kept (8 bytes each). Must be a power of two. */
+#define CLI_TRACE_SIZE             256
 #endif
 
 /* Enable example function. */
 #define CLI_EXAMPLE_ENABLE         TRUE
 
+/* Enable the memory commands: md, mw, mfill, mcmp.
+ * They give access to any address, enable them only for debugging. */
+#define CLI_MEMORY_ENABLE          FALSE
+
+/* Enable the transfer commands: rx, sx (XMODEM). Needs 'CLI_USE_RING_BUFFER'
+ * and '__io_cli_millis'. */
+#define CLI_TRANSFER_ENABLE        FALSE
+#if (CLI_TRANSFER_ENABLE == TRUE)
+/* Maximum number of the targets for the transfer. */
+#define CLI_TRANSFER_TARGETS       4
+#endif
+
 /*****************************************************************************/
 /* Checking that the parameters are correct. */
 #if CLI_BUFFER_SIZE < 0 
 #error "'CLI_BUFFER_SIZE' must be greater than 0!"
 #endif
 
+#if (CLI_SCRATCH_SIZE < 2 * CLI_BUFFER_SIZE)
+#error "'CLI_SCRATCH_SIZE' must hold the line and its arguments: at least 2 * 'CLI_BUFFER_SIZE'!"
+#endif
+
 #if CLI_MAX_COUNT_COMMAND < 0 
 #error "'CLI_MAX_COUNT_COMMAND' must be greater than 0!"
 #endif
@@ -93,4 +306,102 @@ SOFTWARE.
 #error "'CLI_SIZE_HISTORY' must be greater than 0!"
 #endif
 
+#if (CLI_USE_RING_BUFFER == TRUE)
+#if (CLI_RX_RING_SIZE & (CLI_RX_RING_SIZE - 1)) || (CLI_TX_RING_SIZE & (CLI_TX_RING_SIZE - 1))
+#error "'CLI_RX_RING_SIZE' and 'CLI_TX_RING_SIZE' must be a power of two!"
+#endif
+#endif
+
+#if (CLI_TRANSFER_ENABLE == TRUE) && (CLI_USE_RING_BUFFER != TRUE)
+#error "'CLI_TRANSFER_ENABLE' needs 'CLI_USE_RING_BUFFER' to receive binary data!"
+#endif
+
+#if (CLI_ENABLE_POLL_ALL == TRUE) && (CLI_USE_RING_BUFFER == TRUE)
+#if (CLI_POLL_TX_BUDGET > CLI_TX_RING_SIZE)
+#error "'CLI_POLL_TX_BUDGET' must fit in the transmit ring 'CLI_TX_RING_SIZE'!"
+#endif
+#endif
+
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+#if (CLI_USE_RING_BUFFER != TRUE)
+#error "'CLI_ENABLE_FLOW_CONTROL' needs 'CLI_USE_RING_BUFFER' for the held output!"
+#endif
+#if (CLI_PAGER_ROWS < 3)
+#error "'CLI_PAGER_ROWS' must be at least 3!"
+#endif
+#endif
+
+#if (CLI_ENABLE_MUX == TRUE)
+#if (CLI_USE_RING_BUFFER != TRUE)
+#error "'CLI_ENABLE_MUX' needs 'CLI_USE_RING_BUFFER' for the data of the instances!"
+#endif
+#if (CLI_MUX_CHANNELS > 64)
+#error "'CLI_MUX_CHANNELS' must be at most 64!"
+#endif
+#if (CLI_MUX_STREAM_SIZE & (CLI_MUX_STREAM_SIZE - 1))
+#error "'CLI_MUX_STREAM_SIZE' must be a power of two!"
+#endif
+#endif
+
+#if (CLI_ENABLE_SCREEN == TRUE)
+#if (CLI_SCREEN_ROWS > 255) || (CLI_SCREEN_COLS > 255)
+#error "'CLI_SCREEN_ROWS' and 'CLI_SCREEN_COLS' must be at most 255!"
+#endif
+#endif
+
+#if (CLI_ENABLE_LOG == TRUE)
+#if (CLI_LOG_QUEUE_SIZE & (CLI_LOG_QUEUE_SIZE - 1))
+#error "'CLI_LOG_QUEUE_SIZE' must be a power of two!"
+#endif
+#endif
+
+#if (CLI_ENABLE_PLUGINS == TRUE)
+#if (CLI_PLUGIN_COMMANDS < 1)
+#error "'CLI_PLUGIN_COMMANDS' must be greater than 0!"
+#endif
+#endif
+
+#if (CLI_ENABLE_VARIABLES == TRUE)
+#if (CLI_VARIABLES_COUNT & (CLI_VARIABLES_COUNT - 1))
+#error "'CLI_VARIABLES_COUNT' must be a power of two!"
+#endif
+#if (CLI_VARIABLES_ARENA > 65534)
+#error "'CLI_VARIABLES_ARENA' must be less than 65535!"
+#endif
+#endif
+
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+#if (CLI_POOL_BLOCKS % 32) || (CLI_POOL_BLOCKS < 32)
+#error "'CLI_POOL_BLOCKS' must be a multiple of 32!"
+#endif
+#if (CLI_BUFFER_SIZE > 32 * CLI_POOL_BLOCK_SIZE)
+#error "'CLI_BUFFER_SIZE' must fit in 32 blocks of the pool!"
+#endif
+#endif
+
+#if (CLI_COMPACT == TRUE) && (CLI_ENABLE_LINE_POOL != TRUE)
+#error "'CLI_COMPACT' keeps the line and the history in the pool: set 'CLI_ENABLE_LINE_POOL'!"
+#endif
+
+#if (CLI_ENABLE_SUGGEST == TRUE) && (CLI_SIZE_HISTORY > 255)
+#error "'CLI_SIZE_HISTORY' must be less than 256 for 'CLI_ENABLE_SUGGEST'!"
+#endif
+
+#if (CLI_ENABLE_TRACE == TRUE)
+#if (CLI_TRACE_SIZE & (CLI_TRACE_SIZE - 1))
+#error "'CLI_TRACE_SIZE' must be a power of two!"
+#endif
+#if (CLI_ENABLE_EMIT != TRUE)
+#error "'CLI_ENABLE_TRACE' needs 'CLI_ENABLE_EMIT' to print the trace!"
+#endif
+#endif
+
+#if (CLI_ENABLE_ALIASES == TRUE) && (CLI_ENABLE_COMMAND_LISTS != TRUE)
+#error "'CLI_ENABLE_ALIASES' needs 'CLI_ENABLE_COMMAND_LISTS' for the quoted commands of the alias!"
+#endif
+
+#if (CLI_ENABLE_ALIASES == TRUE) && (CLI_ALIAS_SIZE > 255)
+#error "'CLI_ALIAS_SIZE' must be less than 256!"
+#endif
+
 #endif /* CLI_OPT_H_ */
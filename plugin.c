@@ -0,0 +1,657 @@
+/*
+*******************************************************************************
+@file	plugin.c
+@brief	Commands loaded from the shared objects on the POSIX build.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+
+#if (CLI_ENABLE_PLUGINS == TRUE)
+#include <stdlib.h>
+#include <pthread.h>
+#include <dlfcn.h>
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Plugin Structure definition
+ */
+struct cli_plugin {
+	struct cli_plugin *Next;               // Next plugin of the list
+	void *Handle;                          // Handle of 'dlopen', NULL - not loaded
+	int  Users;                            // Commands of the plugin that run now
+	int  Commands;                         // Places of the plugin in the registry, the stubs too
+	uint8_t Lazy;                          // Declared by 'cli_plugin_lazy': the stubs stay
+	uint8_t Unloading;                     // Closed when the running commands return
+	char Path[];                           // Path of the shared object
+};
+
+/*
+ * @brief	Place of the registry
+ */
+typedef struct {
+	const cli_command_t *Command;          // Command of the plugin or the stub
+	cli_command_t *Stub;                   // Stub of the lazy plugin, NULL - none
+	cli_plugin_t *Plugin;                  // Owner of the command
+} cli_plugin_slot_t;
+
+/*
+ * @brief	Registry Structure definition
+ * @note	It is shared by all the instances. The places are sorted by
+ *      	the name of the command and grow twice when they are full.
+ */
+typedef struct {
+	pthread_mutex_t Lock;                  // Protects the places and the plugins
+	pthread_mutex_t Busy;                  // One load or unload at a time
+	cli_plugin_slot_t *Slots;              // Commands sorted by the name
+	int  Count;                            // Places in use
+	int  Size;                             // Places allocated
+	cli_plugin_t *Plugins;                 // List of the plugins
+	unsigned int Generation;               // Number of changes of the commands
+	cli_plugin_realloc_t Realloc;          // Memory of the registry
+	cli_plugin_free_t Free;
+} cli_plugin_registry_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* Instance Definition ----------------------------------------------------- */
+static cli_plugin_registry_t cli_registry = {
+	.Lock = PTHREAD_MUTEX_INITIALIZER,
+	.Busy = PTHREAD_MUTEX_INITIALIZER,
+	.Realloc = realloc,
+	.Free = free,
+};
+/*---------------------------------------------------------------------------*/
+
+/* Instances of static functions ------------------------------------------- */
+static int cli_plugin_search(const char *name, size_t length, int *index);
+static int cli_plugin_insert(cli_plugin_t *plugin, const cli_command_t *command, cli_command_t *stub);
+static void cli_plugin_drop(cli_plugin_t *plugin);
+static cli_plugin_t *cli_plugin_record(const char *path, int create);
+static void cli_plugin_forget(cli_plugin_t *plugin);
+static int cli_plugin_open(cli_t *cli, cli_plugin_t *plugin);
+static void *cli_plugin_release(cli_plugin_t *plugin);
+static void cli_plugin_close(cli_plugin_t *plugin, void *handle);
+static int cli_plugin_stub(cli_t *cli, int argc, char *argv[]);
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Set the memory functions of the registry.
+* @note 	Must be called before the first plugin is loaded or declared.
+*       	By default `realloc` and `free` are used.
+* @param	realloc_fn Like `realloc`: `realloc_fn(NULL, size)` allocates.
+* @param	free_fn Like `free`.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the registry is already in use.
+*/
+int cli_plugin_allocator(cli_plugin_realloc_t realloc_fn, cli_plugin_free_t free_fn) {
+	if ((realloc_fn == NULL) || (free_fn == NULL)) {
+		return CLI_ERROR;
+	}
+	pthread_mutex_lock(&cli_registry.Lock);
+	int status = CLI_ERROR;
+	if ((cli_registry.Slots == NULL) && (cli_registry.Plugins == NULL)) {
+		cli_registry.Realloc = realloc_fn;
+		cli_registry.Free = free_fn;
+		status = CLI_OK;
+	}
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return status;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Load the shared object and register its commands.
+* @note 	The entry point `cli_plugin_register` of the plugin adds its
+*       	commands with `cli_plugin_add`. The commands are seen by all
+*       	the instances.
+* @param 	cli Is a pointer (`cli_t`) to the instance for the messages.
+* @param	path Path of the shared object.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if error.
+*/
+int cli_plugin_load(cli_t *cli, const char *path) {
+	pthread_mutex_lock(&cli_registry.Busy);
+	pthread_mutex_lock(&cli_registry.Lock);
+	cli_plugin_t *plugin = cli_plugin_record(path, 1);
+	pthread_mutex_unlock(&cli_registry.Lock);
+	int status = CLI_ERROR;
+	if (plugin == NULL) {
+		cli_printf(cli, "No memory for the plugin '%s'.\r\n", path);
+	} else {
+		status = cli_plugin_open(cli, plugin);
+		pthread_mutex_lock(&cli_registry.Lock);
+		cli_plugin_forget(plugin);
+		pthread_mutex_unlock(&cli_registry.Lock);
+	}
+	pthread_mutex_unlock(&cli_registry.Busy);
+	return status;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the commands of the plugin and unload it.
+* @note 	If its commands run now (in the other instances, in the
+*       	workers or the caller itself), the shared object is closed when
+*       	the last of them returns. The commands declared by
+*       	`cli_plugin_lazy` become stubs again.
+* @param 	cli Is a pointer (`cli_t`) to the instance for the messages.
+* @param	name Path of the plugin or its file name.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the plugin is not loaded.
+*/
+int cli_plugin_unload(cli_t *cli, const char *name) {
+	pthread_mutex_lock(&cli_registry.Busy);
+	pthread_mutex_lock(&cli_registry.Lock);
+	cli_plugin_t *plugin = cli_plugin_record(name, 0);
+	if ((plugin == NULL) || (plugin->Handle == NULL) || plugin->Unloading) {
+		pthread_mutex_unlock(&cli_registry.Lock);
+		pthread_mutex_unlock(&cli_registry.Busy);
+		cli_printf(cli, "The plugin '%s' is not loaded.\r\n", name);
+		return CLI_ERROR;
+	}
+	cli_plugin_drop(plugin);
+	int users = plugin->Users;
+	void *handle = NULL;
+	if (users) {
+		plugin->Unloading = 1;
+	} else {
+		handle = cli_plugin_release(plugin);
+	}
+	pthread_mutex_unlock(&cli_registry.Lock);
+	cli_plugin_close(plugin, handle);
+	pthread_mutex_lock(&cli_registry.Lock);
+	cli_plugin_forget(plugin);
+	pthread_mutex_unlock(&cli_registry.Lock);
+	pthread_mutex_unlock(&cli_registry.Busy);
+	if (users) {
+		cli_printf(cli, "The plugin '%s' is unloaded when its %d running commands return.\r\n", name, users);
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Declare the command of the plugin which is not loaded yet.
+* @note 	The stub of the command is put in the registry at once. The
+*       	shared object is loaded the first time one of its commands
+*       	runs, then the command runs as usual. After `unload` the stubs
+*       	come back. The name and the help are not copied.
+* @param	path Path of the shared object.
+* @param	name Name of the command.
+* @param	help Help information.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the name is taken or there is no memory.
+*/
+int cli_plugin_lazy(const char *path, const char *name, const char *help) {
+	pthread_mutex_lock(&cli_registry.Lock);
+	cli_plugin_t *plugin = cli_plugin_record(path, 1);
+	cli_command_t *stub = (plugin != NULL) ? cli_registry.Realloc(NULL, sizeof(cli_command_t)) : NULL;
+	int status = CLI_ERROR;
+	if (stub != NULL) {
+		*stub = (cli_command_t){name, cli_plugin_stub, help};
+		status = cli_plugin_insert(plugin, stub, stub);
+		if (status == CLI_OK) {
+			plugin->Lazy = 1;
+		} else {
+			cli_registry.Free(stub);
+		}
+	}
+	if (plugin != NULL) {
+		cli_plugin_forget(plugin);
+	}
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return status;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add the command of the plugin to the registry.
+* @note 	Called by the entry point of the plugin. The descriptor is not
+*       	copied: it must lie in the plugin, best in the constant data.
+*       	The built-in commands of the instance with the same name go
+*       	first.
+* @param	plugin The plugin given to the entry point.
+* @param	command The command or group (`Children`).
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the name is taken or there is no memory.
+*/
+int cli_plugin_add(cli_plugin_t *plugin, const cli_command_t *command) {
+	if ((plugin == NULL) || (command == NULL) || (command->Name == NULL) || (command->Help == NULL)) {
+		return CLI_ERROR;
+	}
+	pthread_mutex_lock(&cli_registry.Lock);
+	int status = cli_plugin_insert(plugin, command, NULL);
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return status;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the plugins: state, commands and the running commands.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` Number of the plugins.
+*/
+int cli_plugin_list(cli_t *cli) {
+	int count = 0;
+	pthread_mutex_lock(&cli_registry.Lock);
+	for (cli_plugin_t *plugin = cli_registry.Plugins; plugin != NULL; plugin = plugin->Next) {
+		const char *state = plugin->Unloading ? "unloading" : (plugin->Handle != NULL) ? "loaded" : "lazy";
+		cli_printf(cli, "%-10s %2d commands %2d running  %s\r\n", state, plugin->Commands, plugin->Users, plugin->Path);
+		count++;
+	}
+	cli_printf(cli, "Registry: %d of %d places\r\n", cli_registry.Count, cli_registry.Size);
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the number of the commands in the registry.
+* @return	`int` Number of the commands.
+*/
+int cli_plugin_count(void) {
+	pthread_mutex_lock(&cli_registry.Lock);
+	int count = cli_registry.Count;
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the command of the registry.
+* @param	index Place in the registry.
+* @return	`cli_command_t*` The command or NULL if there is no such place.
+*/
+const cli_command_t *cli_plugin_at(int index) {
+	pthread_mutex_lock(&cli_registry.Lock);
+	const cli_command_t *command = (index < cli_registry.Count) ? cli_registry.Slots[index].Command : NULL;
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return command;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the command of the registry by name.
+* @param	name Name of the command (not terminated by zero).
+* @param	length Length of the name.
+* @return	`cli_command_t*` The command or NULL if not found.
+*/
+const cli_command_t *cli_plugin_find(const char *name, size_t length) {
+	pthread_mutex_lock(&cli_registry.Lock);
+	int index;
+	const cli_command_t *command = NULL;
+	if (cli_plugin_search(name, length, &index)) {
+		command = cli_registry.Slots[index].Command;
+	}
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return command;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the number of changes of the registry.
+* @note 	The aliases of all the instances find their commands again
+*       	when it changes.
+* @return	`unsigned int` Number of changes.
+*/
+unsigned int cli_plugin_generation(void) {
+	pthread_mutex_lock(&cli_registry.Lock);
+	unsigned int generation = cli_registry.Generation;
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return generation;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Keep the plugin of the command loaded while the command runs.
+* @param	command The command to run.
+* @return	`cli_plugin_t*` The plugin for `cli_plugin_leave` or NULL if
+*       	the command is not from a plugin.
+*/
+cli_plugin_t *cli_plugin_enter(const cli_command_t *command) {
+	pthread_mutex_lock(&cli_registry.Lock);
+	int index;
+	cli_plugin_t *plugin = NULL;
+	if (cli_plugin_search(command->Name, strlen(command->Name), &index)) {
+		cli_plugin_slot_t *slot = &cli_registry.Slots[index];
+		if ((slot->Command == command) || (slot->Stub == command)) {
+			plugin = slot->Plugin;
+			plugin->Users++;
+		}
+	}
+	pthread_mutex_unlock(&cli_registry.Lock);
+	return plugin;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The command of the plugin returned: close the plugin if it
+*       	waits for it to be unloaded.
+* @param	plugin The plugin from `cli_plugin_enter`, can be NULL.
+*
+*/
+void cli_plugin_leave(cli_plugin_t *plugin) {
+	if (plugin == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&cli_registry.Lock);
+	int last = (--plugin->Users == 0) && plugin->Unloading;
+	pthread_mutex_unlock(&cli_registry.Lock);
+	if (!last) {
+		return;
+	}
+	/* The plugin is closed in the same order of the locks as by 'unload' */
+	pthread_mutex_lock(&cli_registry.Busy);
+	pthread_mutex_lock(&cli_registry.Lock);
+	void *handle = NULL;
+	if ((plugin->Users == 0) && plugin->Unloading) {
+		handle = cli_plugin_release(plugin);
+	}
+	pthread_mutex_unlock(&cli_registry.Lock);
+	cli_plugin_close(plugin, handle);
+	pthread_mutex_lock(&cli_registry.Lock);
+	cli_plugin_forget(plugin);
+	pthread_mutex_unlock(&cli_registry.Lock);
+	pthread_mutex_unlock(&cli_registry.Busy);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the place of the command in the registry.
+* @note 	Must be called with the lock held.
+* @param	name Name of the command (not terminated by zero).
+* @param	length Length of the name.
+* @param	index Returns the place of the command or where to put it.
+* @return	`int` (1) if the command is found.
+*/
+static int cli_plugin_search(const char *name, size_t length, int *index) {
+	int low = 0;
+	int high = cli_registry.Count;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		const char *other = cli_registry.Slots[middle].Command->Name;
+		int order = strncmp(other, name, length);
+		if (!order && other[length]) {
+			order = 1;
+		}
+		if (order < 0) {
+			low = middle + 1;
+		} else if (order > 0) {
+			high = middle;
+		} else {
+			*index = middle;
+			return 1;
+		}
+	}
+	*index = low;
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Put the command in its place of the registry.
+* @note 	Must be called with the lock held. The command of the lazy
+*       	plugin takes the place of its stub.
+* @param	plugin Owner of the command.
+* @param	command The command.
+* @param	stub The stub of the lazy plugin or NULL.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the name is taken or there is no memory.
+*/
+static int cli_plugin_insert(cli_plugin_t *plugin, const cli_command_t *command, cli_command_t *stub) {
+	int index;
+	if (cli_plugin_search(command->Name, strlen(command->Name), &index)) {
+		cli_plugin_slot_t *slot = &cli_registry.Slots[index];
+		if ((stub != NULL) || (slot->Plugin != plugin) || (slot->Command != slot->Stub)) {
+			return CLI_ERROR;
+		}
+		slot->Command = command;
+		cli_registry.Generation++;
+		return CLI_OK;
+	}
+	if (cli_registry.Count == cli_registry.Size) {
+		int size = cli_registry.Size ? 2 * cli_registry.Size : CLI_PLUGIN_COMMANDS;
+		cli_plugin_slot_t *slots = cli_registry.Realloc(cli_registry.Slots, size * sizeof(cli_plugin_slot_t));
+		if (slots == NULL) {
+			return CLI_ERROR;
+		}
+		cli_registry.Slots = slots;
+		cli_registry.Size = size;
+	}
+	cli_plugin_slot_t *slot = &cli_registry.Slots[index];
+	memmove(slot + 1, slot, (cli_registry.Count - index) * sizeof(cli_plugin_slot_t));
+	slot->Command = command;
+	slot->Stub = stub;
+	slot->Plugin = plugin;
+	cli_registry.Count++;
+	cli_registry.Generation++;
+	plugin->Commands++;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the commands of the plugin from the registry, the stubs
+*       	of the lazy plugin stay.
+* @note 	Must be called with the lock held.
+* @param	plugin The plugin.
+*
+*/
+static void cli_plugin_drop(cli_plugin_t *plugin) {
+	int count = 0;
+	for (int index = 0; index < cli_registry.Count; index++) {
+		cli_plugin_slot_t *slot = &cli_registry.Slots[index];
+		if (slot->Plugin == plugin) {
+			if (slot->Stub == NULL) {
+				plugin->Commands--;
+				continue;
+			}
+			slot->Command = slot->Stub;
+		}
+		cli_registry.Slots[count++] = *slot;
+	}
+	cli_registry.Count = count;
+	cli_registry.Generation++;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the plugin by its path or file name.
+* @note 	Must be called with the lock held.
+* @param	path Path of the shared object or its file name.
+* @param	create If (1), the new plugin is made when it is not found.
+* @return	`cli_plugin_t*` The plugin or NULL.
+*/
+static cli_plugin_t *cli_plugin_record(const char *path, int create) {
+	for (cli_plugin_t *plugin = cli_registry.Plugins; plugin != NULL; plugin = plugin->Next) {
+		const char *file = strrchr(plugin->Path, '/');
+		if (!strcmp(plugin->Path, path) || (!create && (file != NULL) && !strcmp(file + 1, path))) {
+			return plugin;
+		}
+	}
+	if (!create) {
+		return NULL;
+	}
+	size_t length = strlen(path) + 1;
+	cli_plugin_t *plugin = cli_registry.Realloc(NULL, sizeof(cli_plugin_t) + length);
+	if (plugin != NULL) {
+		memset(plugin, 0, sizeof(cli_plugin_t));
+		memcpy(plugin->Path, path, length);
+		plugin->Next = cli_registry.Plugins;
+		cli_registry.Plugins = plugin;
+	}
+	return plugin;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Free the plugin if nothing refers to it.
+* @note 	Must be called with the lock held.
+* @param	plugin The plugin.
+*
+*/
+static void cli_plugin_forget(cli_plugin_t *plugin) {
+	if (plugin->Lazy || plugin->Commands || plugin->Users || (plugin->Handle != NULL)) {
+		return;
+	}
+	cli_plugin_t **link = &cli_registry.Plugins;
+	while (*link != plugin) {
+		link = &(*link)->Next;
+	}
+	*link = plugin->Next;
+	cli_registry.Free(plugin);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Open the shared object and call its entry point.
+* @note 	Must be called with 'Busy' held and the lock free: the entry
+*       	point adds the commands.
+* @param 	cli Is a pointer (`cli_t`) to the instance for the messages.
+* @param	plugin The plugin.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if error.
+*/
+static int cli_plugin_open(cli_t *cli, cli_plugin_t *plugin) {
+	if (plugin->Handle != NULL) {
+		cli_printf(cli, plugin->Unloading ? "The plugin '%s' is unloaded when its commands return.\r\n" :
+				"The plugin '%s' is already loaded.\r\n", plugin->Path);
+		return CLI_ERROR;
+	}
+	void *handle = dlopen(plugin->Path, RTLD_NOW | RTLD_LOCAL);
+	if (handle == NULL) {
+		cli_printf(cli, "%s\r\n", dlerror());
+		return CLI_ERROR;
+	}
+	cli_plugin_entry_t entry = (cli_plugin_entry_t)dlsym(handle, CLI_PLUGIN_ENTRY);
+	if (entry == NULL) {
+		cli_printf(cli, "The plugin '%s' has no '%s'.\r\n", plugin->Path, CLI_PLUGIN_ENTRY);
+		dlclose(handle);
+		return CLI_ERROR;
+	}
+	pthread_mutex_lock(&cli_registry.Lock);
+	plugin->Handle = handle;
+	pthread_mutex_unlock(&cli_registry.Lock);
+	if (entry(plugin) == CLI_OK) {
+		return CLI_OK;
+	}
+	cli_printf(cli, "The plugin '%s' failed to add its commands.\r\n", plugin->Path);
+	pthread_mutex_lock(&cli_registry.Lock);
+	cli_plugin_drop(plugin);
+	handle = NULL;
+	if (plugin->Users) {
+		plugin->Unloading = 1;
+	} else {
+		handle = cli_plugin_release(plugin);
+	}
+	pthread_mutex_unlock(&cli_registry.Lock);
+	cli_plugin_close(plugin, handle);
+	return CLI_ERROR;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the handle of the plugin which is no longer used.
+* @note 	Must be called with 'Busy' and the lock held.
+* @param	plugin The plugin.
+* @return	`void*` The handle for `cli_plugin_close`.
+*/
+static void *cli_plugin_release(cli_plugin_t *plugin) {
+	void *handle = plugin->Handle;
+	plugin->Handle = NULL;
+	plugin->Unloading = 0;
+	return handle;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Call the exit of the plugin and close the shared object.
+* @note 	Must be called with 'Busy' held and the lock free.
+* @param	plugin The plugin.
+* @param	handle The handle from `cli_plugin_release` or NULL.
+*
+*/
+static void cli_plugin_close(cli_plugin_t *plugin, void *handle) {
+	if (handle == NULL) {
+		return;
+	}
+	cli_plugin_exit_t exit = (cli_plugin_exit_t)dlsym(handle, CLI_PLUGIN_EXIT);
+	if (exit != NULL) {
+		exit(plugin);
+	}
+	dlclose(handle);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Command of the lazy plugin which is not loaded yet: load the
+*       	plugin, then run the command it added in place of the stub.
+* @note 	The plugin is kept by `cli_plugin_enter` of the stub while the
+*       	command runs.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param  	argc Number of arguments passed to the function.
+* @param 	argv[] Array of argument values.
+* @return 	`int` Value returned by the command.
+*/
+static int cli_plugin_stub(cli_t *cli, int argc, char *argv[]) {
+	pthread_mutex_lock(&cli_registry.Lock);
+	int index;
+	cli_plugin_t *plugin = NULL;
+	const cli_command_t *stub = NULL;
+	if (cli_plugin_search(argv[0], strlen(argv[0]), &index)) {
+		plugin = cli_registry.Slots[index].Plugin;
+		stub = cli_registry.Slots[index].Stub;
+	}
+	pthread_mutex_unlock(&cli_registry.Lock);
+	if (plugin == NULL) {
+		return CLI_ERROR;
+	}
+	/* The other instance could load it first */
+	pthread_mutex_lock(&cli_registry.Busy);
+	int status = CLI_OK;
+	if ((plugin->Handle == NULL) || plugin->Unloading) {
+		status = cli_plugin_open(cli, plugin);
+	}
+	pthread_mutex_unlock(&cli_registry.Busy);
+	if (status != CLI_OK) {
+		return status;
+	}
+	int depth = 0;
+	const cli_command_t *command = cli_command_walk(cli, argc, argv, &depth);
+	if ((command == NULL) || (command == stub)) {
+		cli_printf(cli, "The plugin '%s' has no command '%s'.\r\n", plugin->Path, argv[0]);
+		return CLI_ERROR;
+	}
+	if (command->Function == NULL) {
+		cli_print_group(cli, command);
+		return 0;
+	}
+	return command->Function(cli, argc - depth, &argv[depth]);
+}
+
+#endif
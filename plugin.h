@@ -0,0 +1,72 @@
+/*
+*******************************************************************************
+@file	plugin.h
+@brief	Commands loaded from the shared objects on the POSIX build: the growable
+		registry of the commands, the loader and the lazy stubs.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_PLUGIN_H_
+#define CLI_PLUGIN_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stddef.h>  /* For 'size_t' */
+
+#include "opt.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Define ------------------------------------------------------------------ */
+/* Entry point of the plugin, called after it is loaded:
+ * int cli_plugin_register(cli_plugin_t *plugin) */
+#define CLI_PLUGIN_ENTRY       "cli_plugin_register"
+/* Optional exit of the plugin, called before it is unloaded:
+ * void cli_plugin_unregister(cli_plugin_t *plugin) */
+#define CLI_PLUGIN_EXIT        "cli_plugin_unregister"
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ----------------------------------------------------------------- */
+/*
+ * @brief	Loaded or declared plugin, its fields are known only to 'plugin.c'
+ */
+typedef struct cli_plugin cli_plugin_t;
+
+/*
+ * @brief	Entry point and exit of the plugin
+ */
+typedef int (*cli_plugin_entry_t)(cli_plugin_t *plugin);
+typedef void (*cli_plugin_exit_t)(cli_plugin_t *plugin);
+
+/*
+ * @brief	Memory of the registry: like 'realloc' and 'free'
+ */
+typedef void *(*cli_plugin_realloc_t)(void *pointer, size_t size);
+typedef void (*cli_plugin_free_t)(void *pointer);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_PLUGIN_H_ */
@@ -0,0 +1,136 @@
+/*
+*******************************************************************************
+@file	poll.c
+@brief	Fair servicing of several instances: the registry and the
+		round-robin turns with the limits of the received and sent bytes.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+
+#if (CLI_ENABLE_POLL_ALL == TRUE)
+
+/*
+ * @brief	Registered instances.
+ * @note	Registered and polled from the same main loop: not thread-safe.
+ */
+static struct {
+	cli_t *Instances[CLI_POLL_INSTANCES];  // Instances in the order of registration
+	int Count;                             // Number of the instances
+	int Next;                              // Instance that goes first in the next turn
+} cli_poll;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add the instance to the ones serviced by `cli_poll_all`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	`CLI_OK` (0) if success or it is already registered.
+* @retval   `CLI_ERROR` (!0) if there is no free place.
+*/
+int cli_register(cli_t *cli) {
+	for (int i = 0; i < cli_poll.Count; i++) {
+		if (cli_poll.Instances[i] == cli) {
+			return CLI_OK;
+		}
+	}
+	if (cli_poll.Count == CLI_POLL_INSTANCES) {
+		return CLI_ERROR;
+	}
+	cli_poll.Instances[cli_poll.Count++] = cli;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the instance from the ones serviced by `cli_poll_all`.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if it is not registered.
+*/
+int cli_unregister(cli_t *cli) {
+	for (int i = 0; i < cli_poll.Count; i++) {
+		if (cli_poll.Instances[i] == cli) {
+			memmove(&cli_poll.Instances[i], &cli_poll.Instances[i + 1], (cli_poll.Count - i - 1) * sizeof(cli_t*));
+			cli_poll.Count--;
+			cli_poll.Next = 0;
+			return CLI_OK;
+		}
+	}
+	return CLI_ERROR;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Give one turn to every registered instance, instead of calling
+*       	`cli_handler` of each one.
+* @note 	In its turn the instance takes at most `CLI_POLL_RX_BUDGET`
+*       	received bytes and stops after `CLI_POLL_TX_BUDGET` sent bytes;
+*       	the rest waits for the next turn. With `CLI_USE_RING_BUFFER`
+*       	the instance whose transmit ring has less free space than
+*       	`CLI_POLL_TX_BUDGET` (a slow port) skips the turn, so it does
+*       	not wait for its port while the others are waiting for it.
+*       	The instances go first in turn.
+* @return	`int` (1) if some instance has more work, otherwise (0): the
+*       	caller can sleep.
+*/
+int cli_poll_all(void) {
+	int pending = 0;
+	int count = cli_poll.Count;
+	for (int i = 0; i < count; i++) {
+		cli_t *cli = cli_poll.Instances[(cli_poll.Next + i) % count];
+#if (CLI_USE_RING_BUFFER == TRUE)
+		if ((cli_ring_space(&cli->Tx) < CLI_POLL_TX_BUDGET)
+#if (CLI_ENABLE_FLOW_CONTROL == TRUE)
+				/* The pager waits for the key of the operator */
+				&& (cli->Page != CLI_PAGE_WAIT)
+#endif
+				) {
+			if (cli->_io_txstart != NULL) {
+				cli->_io_txstart();
+			}
+			pending = 1;
+			continue;
+		}
+#endif
+		cli->RxLeft = CLI_POLL_RX_BUDGET;
+		cli->TxLeft = CLI_POLL_TX_BUDGET;
+		/* Every call takes at least one byte or finds nothing to do */
+		for (int call = 0; call < CLI_POLL_RX_BUDGET; call++) {
+			cli_handler(cli);
+			if (!cli->RxLeft || !cli->TxLeft || !cli_pending(cli)) break;
+		}
+		cli->RxLeft = -1;
+		cli->TxLeft = -1;
+		pending |= cli_pending(cli);
+	}
+	if (count) {
+		cli_poll.Next = (cli_poll.Next + 1) % count;
+	}
+	return pending;
+}
+
+#endif /* CLI_ENABLE_POLL_ALL */
@@ -0,0 +1,134 @@
+/*
+*******************************************************************************
+@file	pool.c
+@brief	Pool of the memory blocks shared by all the instances: the long
+		lines and the history.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+
+#if (CLI_ENABLE_LINE_POOL == TRUE)
+
+#define CLI_POOL_WORDS        (CLI_POOL_BLOCKS / 32)
+
+/*
+ * @brief	The pool: the blocks and the map of the used ones.
+ * @note	A piece is a run of the blocks inside one word of the map, so
+ *      	it is taken and given back with one compare-and-swap, and the
+ *      	instances can work in different threads.
+ */
+static struct {
+	cli_atomic_t Map[CLI_POOL_WORDS];      // Bit (1) - the block is used
+	cli_atomic_t Used;                     // Blocks in use now
+	cli_atomic_t Peak;                     // Most blocks ever in use
+	cli_atomic_t Failed;                   // Requests that did not fit
+	uint8_t Data[CLI_POOL_BLOCKS][CLI_POOL_BLOCK_SIZE] __attribute__((aligned(sizeof(void*))));
+} cli_pool;
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the number of the blocks for the size.
+* @param	size Size, bytes.
+* @return	`int` Number of the blocks.
+*/
+static inline int cli_pool_blocks(int size) {
+	return (size + CLI_POOL_BLOCK_SIZE - 1) / CLI_POOL_BLOCK_SIZE;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the piece of the pool.
+* @param	size Size, bytes. Up to 32 blocks.
+* @return	`void*` The piece or NULL if there is no free place.
+*/
+void *cli_pool_alloc(int size) {
+	int count = cli_pool_blocks(size);
+	if ((count < 1) || (count > 32)) {
+		return NULL;
+	}
+	unsigned int mask = (count == 32) ? ~0U : ((1U << count) - 1);
+	for (int word = 0; word < CLI_POOL_WORDS; word++) {
+		unsigned int map = cli_atomic_load(&cli_pool.Map[word]);
+		for (int bit = 0; bit + count <= 32; bit++) {
+			if (map & (mask << bit)) continue;
+			if (!cli_atomic_cas(&cli_pool.Map[word], &map, map | (mask << bit))) {
+				/* Another thread has changed the word: look at it again */
+				bit = -1;
+				continue;
+			}
+			unsigned int used = cli_atomic_add(&cli_pool.Used, count) + count;
+			unsigned int peak = cli_atomic_load(&cli_pool.Peak);
+			while ((used > peak) && !cli_atomic_cas(&cli_pool.Peak, &peak, used));
+			return cli_pool.Data[word * 32 + bit];
+		}
+	}
+	cli_atomic_add(&cli_pool.Failed, 1);
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Give the piece back to the pool.
+* @param	data The piece.
+* @param	size Size of the piece, the same as for `cli_pool_alloc`.
+*
+*/
+void cli_pool_free(void *data, int size) {
+	int count = cli_pool_blocks(size);
+	int block = ((uint8_t*)data - &cli_pool.Data[0][0]) / CLI_POOL_BLOCK_SIZE;
+	unsigned int mask = ((count == 32) ? ~0U : ((1U << count) - 1)) << (block % 32);
+	cli_atomic_t *word = &cli_pool.Map[block / 32];
+	unsigned int map = cli_atomic_load(word);
+	while (!cli_atomic_cas(word, &map, map & ~mask));
+	cli_atomic_add(&cli_pool.Used, -count);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the real size of the piece: whole blocks.
+* @param	size Requested size, bytes.
+* @return	`int` Size, bytes.
+*/
+int cli_pool_capacity(int size) {
+	return cli_pool_blocks(size) * CLI_POOL_BLOCK_SIZE;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the usage of the pool.
+* @param	stats The usage.
+*
+*/
+void cli_pool_stats(cli_pool_stats_t *stats) {
+	stats->Blocks = CLI_POOL_BLOCKS;
+	stats->Used = cli_atomic_load(&cli_pool.Used);
+	stats->Peak = cli_atomic_load(&cli_pool.Peak);
+	stats->Failed = cli_atomic_load(&cli_pool.Failed);
+}
+
+#endif /* CLI_ENABLE_LINE_POOL */
@@ -0,0 +1,63 @@
+/*
+*******************************************************************************
+@file	pool.h
+@brief	Pool of the memory blocks shared by all the instances: the long
+		lines and the history.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_POOL_H_
+#define CLI_POOL_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "opt.h"
+#include "atomic.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Usage of the pool
+ */
+typedef struct {
+	unsigned int Blocks;                   // Number of the blocks
+	unsigned int Used;                     // Blocks in use now
+	unsigned int Peak;                     // Most blocks ever in use
+	unsigned int Failed;                   // Requests that did not fit
+} cli_pool_stats_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'pool.c'. */
+/* Function instances ------------------------------------------------------ */
+void *cli_pool_alloc(int size);
+void cli_pool_free(void *data, int size);
+int cli_pool_capacity(int size);
+void cli_pool_stats(cli_pool_stats_t *stats);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_POOL_H_ */
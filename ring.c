@@ -0,0 +1,176 @@
+/*
+*******************************************************************************
+@file	ring.c
+@brief	Lock-free single-producer/single-consumer ring buffer.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "ring.h"
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Initial configuration of the ring buffer.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @param	data Storage for the ring.
+* @param	size Size of the storage. Must be a power of two.
+*
+*/
+void cli_ring_init(cli_ring_t *ring, uint8_t *data, unsigned int size) {
+	cli_atomic_store(&ring->Head, 0);
+	cli_atomic_store(&ring->Tail, 0);
+	ring->Data = data;
+	ring->Mask = size - 1;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Number of bytes waiting in the ring.
+* @note 	Can be called from either side. The result is exact for the
+*       	consumer and may only grow until the consumer reads.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @return	`unsigned int` Number of bytes.
+*/
+unsigned int cli_ring_count(cli_ring_t *ring) {
+	return cli_atomic_load(&ring->Head) - cli_atomic_load(&ring->Tail);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Number of free bytes in the ring.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @return	`unsigned int` Number of bytes.
+*/
+unsigned int cli_ring_space(cli_ring_t *ring) {
+	return ring->Mask + 1 - cli_ring_count(ring);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Producer: put the data in the ring.
+* @note 	Does not block. What does not fit is not written.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @param	data Data to write.
+* @param	length Number of bytes to write.
+* @return	`unsigned int` Number of bytes written.
+*/
+unsigned int cli_ring_write(cli_ring_t *ring, const uint8_t *data, unsigned int length) {
+	unsigned int head = cli_atomic_load(&ring->Head);
+	unsigned int space = ring->Mask + 1 - (head - cli_atomic_load(&ring->Tail));
+	if (length > space) {
+		length = space;
+	}
+	for (unsigned int i = 0; i < length; i++) {
+		ring->Data[(head + i) & ring->Mask] = data[i];
+	}
+	/* Publish the data */
+	cli_atomic_store(&ring->Head, head + length);
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Consumer: take the data from the ring.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @param	data Buffer for the data.
+* @param	length Size of the buffer.
+* @return	`unsigned int` Number of bytes read.
+*/
+unsigned int cli_ring_read(cli_ring_t *ring, uint8_t *data, unsigned int length) {
+	unsigned int tail = cli_atomic_load(&ring->Tail);
+	unsigned int count = cli_atomic_load(&ring->Head) - tail;
+	if (length > count) {
+		length = count;
+	}
+	for (unsigned int i = 0; i < length; i++) {
+		data[i] = ring->Data[(tail + i) & ring->Mask];
+	}
+	/* Return the slots to the producer */
+	cli_atomic_store(&ring->Tail, tail + length);
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Consumer: get the continuous block of data without copying.
+* @note 	Intended for DMA. After the transfer, release the block
+*       	with `cli_ring_skip`.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @param	data Pointer to the beginning of the block.
+* @return	`unsigned int` Size of the block.
+*/
+unsigned int cli_ring_linear(cli_ring_t *ring, const uint8_t **data) {
+	unsigned int tail = cli_atomic_load(&ring->Tail);
+	unsigned int count = cli_atomic_load(&ring->Head) - tail;
+	unsigned int offset = tail & ring->Mask;
+	unsigned int linear = ring->Mask + 1 - offset;
+	*data = &ring->Data[offset];
+	return (count < linear) ? count : linear;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Consumer: release the bytes that have already been processed.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @param	length Number of bytes.
+*
+*/
+void cli_ring_skip(cli_ring_t *ring, unsigned int length) {
+	unsigned int tail = cli_atomic_load(&ring->Tail);
+	cli_atomic_store(&ring->Tail, tail + length);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Consumer: look at the byte without taking it.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @param	offset Place of the byte from the oldest one.
+* @return	`int` The byte, (-1) if there are fewer bytes in the ring.
+*/
+int cli_ring_peek(cli_ring_t *ring, unsigned int offset) {
+	unsigned int tail = cli_atomic_load(&ring->Tail);
+	if (offset >= cli_atomic_load(&ring->Head) - tail) {
+		return -1;
+	}
+	return ring->Data[(tail + offset) & ring->Mask];
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Consumer: take out the byte, the older bytes keep their order.
+* @note 	The older bytes are moved by one place toward the newer ones:
+*       	these places belong to the consumer until `Tail` is stored.
+* @param 	ring Is a pointer (`cli_ring_t`) to the ring to be worked on.
+* @param	offset Place of the byte from the oldest one, less than
+*       	`cli_ring_count`.
+*/
+void cli_ring_remove(cli_ring_t *ring, unsigned int offset) {
+	unsigned int tail = cli_atomic_load(&ring->Tail);
+	for (unsigned int i = tail + offset; i != tail; i--) {
+		ring->Data[i & ring->Mask] = ring->Data[(i - 1) & ring->Mask];
+	}
+	cli_atomic_store(&ring->Tail, tail + 1);
+}
@@ -0,0 +1,97 @@
+/*
+*******************************************************************************
+@file	ring.h
+@brief	Lock-free single-producer/single-consumer ring buffer. Used to pass
+		bytes between the UART interrupts and `cli_handler`.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_RING_H_
+#define CLI_RING_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+
+#include "opt.h"
+#include "atomic.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Memory ordering --------------------------------------------------------- */
+/*
+ * The ring has exactly one producer and one consumer. The producer owns
+ * `Head`, the consumer owns `Tail`; each side only reads the index of the
+ * other side.
+ *
+ *  - The producer writes the data into the slot and only then publishes it
+ *    by storing `Head` with release semantics.
+ *  - The consumer loads `Head` with acquire semantics, so the data written
+ *    before the publication is visible to it. After reading the data it
+ *    stores `Tail` with release semantics, returning the slot to the producer.
+ *  - The producer loads `Tail` with acquire semantics before reusing a slot.
+ *
+ * The indices are free-running and are reduced modulo the size only when
+ * the data is accessed, so the size must be a power of two.
+ * The producer and the consumer may be an interrupt and the main loop,
+ * or two threads on the host. Two producers (or two consumers) must never
+ * run at the same time.
+ */
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Ring buffer handle Structure definition
+ */
+typedef struct {
+	cli_atomic_t Head;        // Write index (owned by the producer)
+	cli_atomic_t Tail;        // Read index (owned by the consumer)
+	uint8_t *Data;            // Storage
+	unsigned int Mask;        // Size of the storage minus one
+} cli_ring_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'ring.c'. */
+/* Function instances ------------------------------------------------------ */
+void cli_ring_init(cli_ring_t *ring, uint8_t *data, unsigned int size);
+unsigned int cli_ring_count(cli_ring_t *ring);
+unsigned int cli_ring_space(cli_ring_t *ring);
+
+/* Producer side */
+unsigned int cli_ring_write(cli_ring_t *ring, const uint8_t *data, unsigned int length);
+
+/* Consumer side */
+unsigned int cli_ring_read(cli_ring_t *ring, uint8_t *data, unsigned int length);
+unsigned int cli_ring_linear(cli_ring_t *ring, const uint8_t **data);
+void cli_ring_skip(cli_ring_t *ring, unsigned int length);
+int cli_ring_peek(cli_ring_t *ring, unsigned int offset);
+void cli_ring_remove(cli_ring_t *ring, unsigned int offset);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_RING_H_ */
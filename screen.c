@@ -0,0 +1,547 @@
+/*
+*******************************************************************************
+@file	screen.c
+@brief	Live screens of the commands: a framebuffer of cells, only the
+		changed cells are sent to the terminal.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+#include "io.h"
+
+#if (CLI_ENABLE_SCREEN == TRUE)
+
+/* The changed cells to the end of the row, from which the erase is shorter */
+#define CLI_SCREEN_ERASE_FROM      4
+
+/*
+ * @brief	Output of the frame: sent in pieces or only counted
+ */
+typedef struct {
+	cli_t *Cli;                            // Instance of the terminal, NULL - only count
+	int Length;                            // Bytes in 'Data'
+	unsigned int Total;                    // Bytes of the frame
+	char Data[64];                         // Piece of the frame
+} cli_screen_out_t;
+
+/* The framebuffer: one live screen at a time */
+static cli_screen_t cli_screen;
+
+static const cli_cell_t cli_screen_blank = {' ', 0};
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add the bytes to the output of the frame.
+* @param	out Output of the frame.
+* @param	data The bytes.
+* @param	length Number of the bytes.
+*/
+static void cli_screen_emit(cli_screen_out_t *out, const char *data, int length) {
+	out->Total += length;
+	if (out->Cli == NULL) {
+		return;
+	}
+	if (out->Length + length > (int)sizeof(out->Data)) {
+		cli_write(out->Cli, out->Data, out->Length);
+		out->Length = 0;
+	}
+	memcpy(&out->Data[out->Length], data, length);
+	out->Length += length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the decimal number.
+* @param	data Place for the digits.
+* @param	value The number (0 .. 999).
+* @return	`int` Number of the digits.
+*/
+static int cli_screen_number(char *data, int value) {
+	int length = (value >= 100) ? 3 : (value >= 10) ? 2 : 1;
+	for (int i = length - 1; i >= 0; i--) {
+		data[i] = '0' + value % 10;
+		value /= 10;
+	}
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Write the cursor movement "ESC [ n final", n = 1 is omitted.
+* @param	data Place for the sequence.
+* @param	count Number of the steps.
+* @param	final Direction: 'A', 'B', 'C' or 'D'.
+* @return	`int` Length of the sequence.
+*/
+static int cli_screen_step(char *data, int count, char final) {
+	int length = 2;
+	data[0] = Key_ESC;
+	data[1] = Key_CONTROL;
+	if (count != 1) {
+		length += cli_screen_number(&data[length], count);
+	}
+	data[length++] = final;
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The cell on the terminal: the copy of the terminal or, for
+*       	the frame drawn from a clear screen, a blank.
+*/
+static inline cli_cell_t cli_screen_shown(cli_screen_t *screen, int full, int row, int col) {
+	return full ? cli_screen_blank : screen->Front[row][col];
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	The shortest movement of the cursor along the row.
+* @note 	To the right, the cells on the terminal are written again if
+*       	that is shorter and they have the attributes of the terminal.
+* @param	data Place for the bytes, at least 16.
+* @return	`int` Number of the bytes.
+*/
+static int cli_screen_horizontal(cli_screen_t *screen, int full, const cli_screen_cursor_t *cursor,
+		int row, int from, int to, char *data) {
+	if (to == from) {
+		return 0;
+	}
+	if (to > from) {
+		int length = cli_screen_step(data, to - from, Key_C);
+		if (to - from > length) {
+			return length;
+		}
+		for (int col = from; col < to; col++) {
+			if (cli_screen_shown(screen, full, row, col).Attr != cursor->Attr) {
+				return length;
+			}
+		}
+		for (int col = from; col < to; col++) {
+			data[col - from] = cli_screen_shown(screen, full, row, col).Symbol;
+		}
+		return to - from;
+	}
+	int length = cli_screen_step(data, from - to, Key_D);
+	if (from - to < length) {
+		/* The backspace is one byte per step */
+		memset(data, Key_BS, from - to);
+		length = from - to;
+	}
+	char other[16];
+	other[0] = Key_CR;
+	int count = 1 + ((to > 0) ? cli_screen_horizontal(screen, full, cursor, row, 0, to, &other[1]) : 0);
+	if (count < length) {
+		memcpy(data, other, count);
+		length = count;
+	}
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Move the cursor by the shortest sequence: the absolute position,
+*       	the steps up and down, or the new line, with the steps along the row.
+*/
+static void cli_screen_move(cli_screen_t *screen, cli_screen_out_t *out, cli_screen_cursor_t *cursor,
+		int full, int row, int col) {
+	if ((cursor->Row == row) && (cursor->Col == col)) {
+		return;
+	}
+	char best[24];
+	int length = 2;
+	best[0] = Key_ESC;
+	best[1] = Key_CONTROL;
+	if (row || col) {
+		length += cli_screen_number(&best[length], row + 1);
+		if (col) {
+			best[length++] = ';';
+			length += cli_screen_number(&best[length], col + 1);
+		}
+	}
+	best[length++] = 'H';
+
+	if (cursor->Row >= 0) {
+		char other[24];
+		int count = 0;
+		if (row != cursor->Row) {
+			count = cli_screen_step(other, (row > cursor->Row) ? row - cursor->Row : cursor->Row - row,
+					(row > cursor->Row) ? Key_B : Key_A);
+		}
+		count += cli_screen_horizontal(screen, full, cursor, row, cursor->Col, col, &other[count]);
+		if (count < length) {
+			memcpy(best, other, count);
+			length = count;
+		}
+		if (row == cursor->Row + 1) {
+			other[0] = Key_CR;
+			other[1] = '\n';
+			count = 2 + cli_screen_horizontal(screen, full, cursor, row, 0, col, &other[2]);
+			if (count < length) {
+				memcpy(best, other, count);
+				length = count;
+			}
+		}
+	}
+	cli_screen_emit(out, best, length);
+	cursor->Row = row;
+	cursor->Col = col;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add the parameter of the SGR sequence.
+*/
+static int cli_screen_param(char *data, int length, int value) {
+	length += cli_screen_number(&data[length], value);
+	data[length++] = ';';
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Set the attributes of the terminal by the shorter SGR sequence:
+*       	the changes only, or the reset and all the attributes.
+*/
+static void cli_screen_sgr(cli_screen_out_t *out, cli_screen_cursor_t *cursor, uint8_t attr) {
+	static const uint8_t codes[4] = {1, 2, 4, 7};
+	if (cursor->Attr == attr) {
+		return;
+	}
+	char change[32];
+	int length = 2;
+	uint8_t from = cursor->Attr;
+	uint8_t off = from & ~attr;
+	if (off & (CLI_SCREEN_BOLD | CLI_SCREEN_FADED)) {
+		/* One code turns off both */
+		length = cli_screen_param(change, length, 22);
+		from &= ~(CLI_SCREEN_BOLD | CLI_SCREEN_FADED);
+	}
+	if (off & CLI_SCREEN_UNDERLINE) {
+		length = cli_screen_param(change, length, 24);
+	}
+	if (off & CLI_SCREEN_REVERSE) {
+		length = cli_screen_param(change, length, 27);
+	}
+	for (int i = 0; i < 4; i++) {
+		if ((attr & ~from) & (1U << i)) {
+			length = cli_screen_param(change, length, codes[i]);
+		}
+	}
+	if ((attr ^ cursor->Attr) & 0xF0) {
+		length = cli_screen_param(change, length, (attr >> 4) ? 90 + (attr >> 4) - 1 : 39);
+	}
+
+	char reset[32];
+	int count = cli_screen_param(reset, 2, 0);
+	for (int i = 0; i < 4; i++) {
+		if (attr & (1U << i)) {
+			count = cli_screen_param(reset, count, codes[i]);
+		}
+	}
+	if (attr >> 4) {
+		count = cli_screen_param(reset, count, 90 + (attr >> 4) - 1);
+	}
+
+	char *data = (count < length) ? reset : change;
+	length = (count < length) ? count : length;
+	data[0] = Key_ESC;
+	data[1] = Key_CONTROL;
+	data[length - 1] = 'm';
+	cli_screen_emit(out, data, length);
+	cursor->Attr = attr;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Send the cells of 'Back' which differ from the terminal.
+* @param	full Draw from a clear screen: only count, 'Front' is not changed.
+*/
+static void cli_screen_encode(cli_screen_t *screen, cli_screen_out_t *out, cli_screen_cursor_t *cursor, int full) {
+	for (int row = 0; row < CLI_SCREEN_ROWS; row++) {
+		for (int col = 0; col < CLI_SCREEN_COLS; col++) {
+			cli_cell_t cell = screen->Back[row][col];
+			cli_cell_t shown = cli_screen_shown(screen, full, row, col);
+			if ((cell.Symbol == shown.Symbol) && (cell.Attr == shown.Attr)) {
+				continue;
+			}
+			/* The rest of the row is blank: erase it if that is shorter */
+			int changed = 0;
+			int end = col;
+			while ((end < CLI_SCREEN_COLS) &&
+					(screen->Back[row][end].Symbol == ' ') && (screen->Back[row][end].Attr == 0)) {
+				shown = cli_screen_shown(screen, full, row, end);
+				changed += (shown.Symbol != ' ') || (shown.Attr != 0);
+				end++;
+			}
+			cli_screen_move(screen, out, cursor, full, row, col);
+			if ((end == CLI_SCREEN_COLS) && (changed >= CLI_SCREEN_ERASE_FROM)) {
+				cli_screen_sgr(out, cursor, 0);
+				cli_screen_emit(out, CONSOLE_CLEAR_STRING, sizeof(CONSOLE_CLEAR_STRING) - 1);
+				if (!full) {
+					for (; col < CLI_SCREEN_COLS; col++) {
+						screen->Front[row][col] = cli_screen_blank;
+					}
+				}
+				break;
+			}
+			cli_screen_sgr(out, cursor, cell.Attr);
+			cli_screen_emit(out, &cell.Symbol, 1);
+			if (!full) {
+				screen->Front[row][col] = cell;
+			}
+			if (++cursor->Col == CLI_SCREEN_COLS) {
+				/* The terminals differ in the wrap at the last column */
+				cursor->Row = -1;
+			}
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Take the screen for the command.
+* @note 	The terminal is cleared. With `refresh` the screen stays after
+*       	the command returns: `cli_handler` calls `refresh` with the
+*       	keys and when the time of the next frame comes, and commits the
+*       	frame. The keys 'q' and Ctrl+C close it. Without `refresh` the
+*       	command draws and commits itself and closes the screen.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	period Shortest time between the frames, ms, (0) - `CLI_SCREEN_PERIOD`.
+* @param	refresh Drawing of the periodic frames or NULL.
+* @return	`cli_screen_t*` The screen, NULL if it is taken by another instance.
+*/
+cli_screen_t *cli_screen_open(cli_t *cli, int period, cli_screen_refresh_t refresh) {
+	cli_screen_t *screen = &cli_screen;
+	if ((screen->Owner != NULL) && (screen->Owner != cli)) {
+		return NULL;
+	}
+	screen->Owner = cli;
+	screen->Refresh = refresh;
+	screen->Period = (period > 0) ? (uint32_t)period : CLI_SCREEN_PERIOD;
+	screen->Attr = 0;
+	screen->Cursor.Row = 0;
+	screen->Cursor.Col = 0;
+	screen->Cursor.Attr = 0;
+	screen->Frames = 0;
+	screen->Bytes = 0;
+	screen->FullBytes = 0;
+	for (int row = 0; row < CLI_SCREEN_ROWS; row++) {
+		for (int col = 0; col < CLI_SCREEN_COLS; col++) {
+			screen->Back[row][col] = cli_screen_blank;
+			screen->Front[row][col] = cli_screen_blank;
+		}
+	}
+	cli->Screen = screen;
+	cli_printf(cli, "%s%s%s", CONSOLE_NORMAL, CONSOLE_CURSOR_HIDE, CONSOLE_CLEAR_SCREEN);
+	return screen;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Give the screen back to the line editor. The cursor goes to
+*       	the line below the screen.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the instance has no screen.
+*/
+int cli_screen_close(cli_t *cli) {
+	cli_screen_t *screen = cli->Screen;
+	if (screen == NULL) {
+		return CLI_ERROR;
+	}
+	cli_printf(cli, "%s\033[%d;1H\r\n%s", CONSOLE_NORMAL, CLI_SCREEN_ROWS, CONSOLE_CURSOR_SHOW);
+	cli->Screen = NULL;
+	screen->Owner = NULL;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Clear the frame: blanks with no attributes.
+* @param	screen The screen.
+*/
+void cli_screen_clear(cli_screen_t *screen) {
+	for (int row = 0; row < CLI_SCREEN_ROWS; row++) {
+		for (int col = 0; col < CLI_SCREEN_COLS; col++) {
+			screen->Back[row][col] = cli_screen_blank;
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Set the attributes of the text drawn next.
+* @param	screen The screen.
+* @param	attr Attributes 'CLI_SCREEN_...', (0) - normal.
+*/
+void cli_screen_attr(cli_screen_t *screen, uint8_t attr) {
+	if ((attr >> 4) > CLI_SCREEN_WHITE + 1) {
+		/* Not a color of 'CLI_SCREEN_COLOR' */
+		attr &= 0x0F;
+	}
+	screen->Attr = attr;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Draw the symbol. The cells out of the screen are skipped.
+* @param	screen The screen.
+* @param	row Row, from (0).
+* @param	col Column, from (0).
+* @param	symbol Printable symbol.
+*/
+void cli_screen_put(cli_screen_t *screen, int row, int col, char symbol) {
+	if ((row < 0) || (row >= CLI_SCREEN_ROWS) || (col < 0) || (col >= CLI_SCREEN_COLS)) {
+		return;
+	}
+	if ((uint8_t)symbol < Key_SPACE || symbol == Key_DEL) {
+		symbol = ' ';
+	}
+	screen->Back[row][col].Symbol = symbol;
+	screen->Back[row][col].Attr = screen->Attr;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Draw the text. It is cut at the end of the row.
+* @param	screen The screen.
+* @param	row Row, from (0).
+* @param	col Column, from (0).
+* @param	text The text.
+* @return	`int` Number of the symbols drawn.
+*/
+int cli_screen_text(cli_screen_t *screen, int row, int col, const char *text) {
+	int count = 0;
+	while (text[count] && (col + count < CLI_SCREEN_COLS)) {
+		cli_screen_put(screen, row, col + count, text[count]);
+		count++;
+	}
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Draw the formatted text. It is cut at the end of the row.
+* @param	screen The screen.
+* @param	row Row, from (0).
+* @param	col Column, from (0).
+* @param	format Format as for `printf`.
+* @return	`int` Number of the symbols drawn.
+*/
+int cli_screen_printf(cli_screen_t *screen, int row, int col, const char *format, ...) {
+	va_list args;
+	va_start(args, format);
+	char temp[CLI_SCREEN_COLS + 1];
+	int nchar = cli_vsnprintf(temp, sizeof(temp), format, args);
+	va_end(args);
+
+	if (nchar < 0) return 0;
+	return cli_screen_text(screen, row, col, temp);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Send the changes of the frame to the terminal.
+* @note 	The frame comes no sooner than the period of the screen after
+*       	the last one: earlier changes stay in the frame for the next
+*       	commit. The same frame drawn from a clear screen is counted
+*       	for the comparison.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` Bytes sent, (0) if nothing changed or it is too early.
+*/
+int cli_screen_commit(cli_t *cli) {
+	cli_screen_t *screen = cli->Screen;
+	if (screen == NULL) {
+		return 0;
+	}
+	if (__io_cli_millis != NULL) {
+		uint32_t now = __io_cli_millis();
+		if (screen->Frames && (now - screen->Last < screen->Period)) {
+			return 0;
+		}
+		screen->Last = now;
+	}
+
+	cli_screen_out_t full = {.Cli = NULL, .Total = sizeof(CONSOLE_CLEAR_SCREEN) - 1};
+	cli_screen_cursor_t cursor = {.Row = 0, .Col = 0, .Attr = 0};
+	cli_screen_encode(screen, &full, &cursor, 1);
+
+	cli_screen_out_t out = {.Cli = cli};
+	cli_screen_encode(screen, &out, &screen->Cursor, 0);
+	if (out.Length) {
+		cli_write(cli, out.Data, out.Length);
+	}
+	screen->Frames++;
+	screen->Bytes += out.Total;
+	screen->FullBytes += full.Total;
+	screen->FrameBytes = out.Total;
+	screen->FrameFullBytes = full.Total;
+	return out.Total;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Time to the next frame of the screen.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` Milliseconds, (0) if it is time, (-1) if there is no
+*       	periodic screen.
+*/
+int cli_screen_timeout(cli_t *cli) {
+	cli_screen_t *screen = cli->Screen;
+	if ((screen == NULL) || (screen->Refresh == NULL)) {
+		return -1;
+	}
+	if ((__io_cli_millis == NULL) || (screen->Frames == 0)) {
+		return 0;
+	}
+	uint32_t elapsed = __io_cli_millis() - screen->Last;
+	return (elapsed >= screen->Period) ? 0 : (int)(screen->Period - elapsed);
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Service of the screen instead of the line editor: the keys
+*       	and the periodic frames.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	key The received byte, (0) if none.
+* @retval 	`CLI_OK` (0) always.
+*/
+int cli_screen_handler(cli_t *cli, int key) {
+	cli_screen_t *screen = cli->Screen;
+	int close = (screen->Refresh == NULL) || (key == 'q') || (key == CLI_KEY_CTRL('C'));
+	if (!close && (key || (cli_screen_timeout(cli) == 0))) {
+		close = screen->Refresh(cli, screen, key);
+		cli_screen_commit(cli);
+	}
+	if (close) {
+		cli_screen_close(cli);
+		cli_print_line(cli);
+	}
+	return CLI_OK;
+}
+
+#endif
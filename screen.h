@@ -0,0 +1,113 @@
+/*
+*******************************************************************************
+@file	screen.h
+@brief	Live screens of the commands: a framebuffer of cells, only the
+		changed cells are sent to the terminal.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_SCREEN_H_
+#define CLI_SCREEN_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdint.h>  /* For 'uint8_t' */
+
+#include "opt.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Define ------------------------------------------------------------------ */
+/* Attributes of the cell: the styles in the low bits, the color in the high ones */
+#define CLI_SCREEN_BOLD            0x01
+#define CLI_SCREEN_FADED           0x02
+#define CLI_SCREEN_UNDERLINE       0x04
+#define CLI_SCREEN_REVERSE         0x08
+/* Bright color of the text: CLI_SCREEN_COLOR(CLI_SCREEN_RED) */
+#define CLI_SCREEN_COLOR(color)    ((uint8_t)(((color) + 1) << 4))
+
+/* Colors */
+#define CLI_SCREEN_BLACK           0
+#define CLI_SCREEN_RED             1
+#define CLI_SCREEN_GREEN           2
+#define CLI_SCREEN_YELLOW          3
+#define CLI_SCREEN_BLUE            4
+#define CLI_SCREEN_PURPLE          5
+#define CLI_SCREEN_CYAN            6
+#define CLI_SCREEN_WHITE           7
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+struct cli_instance;
+struct cli_screen;
+
+/*
+ * @brief	Draws the next frame. Called with the key (0 - the time of
+ *      	the frame has come), returns not (0) to close the screen.
+ */
+typedef int (*cli_screen_refresh_t)(struct cli_instance *cli, struct cli_screen *screen, int key);
+
+/*
+ * @brief	Cell of the screen
+ */
+typedef struct {
+	char Symbol;                           // Printable symbol
+	uint8_t Attr;                          // Attributes 'CLI_SCREEN_...'
+} cli_cell_t;
+
+/*
+ * @brief	Position and attributes of the terminal
+ */
+typedef struct {
+	int Row;                               // Row of the cursor, -1 - unknown
+	int Col;                               // Column of the cursor
+	uint8_t Attr;                          // Attributes of the next symbols
+} cli_screen_cursor_t;
+
+/*
+ * @brief	Screen Structure definition
+ * @note	The command draws in 'Back'. The commit sends the cells which
+ *      	differ from 'Front', the copy of the terminal.
+ */
+typedef struct cli_screen {
+	cli_cell_t Back[CLI_SCREEN_ROWS][CLI_SCREEN_COLS];  // Frame drawn by the command
+	cli_cell_t Front[CLI_SCREEN_ROWS][CLI_SCREEN_COLS]; // Frame on the terminal
+	struct cli_instance *Owner;            // Instance of the screen, NULL - free
+	cli_screen_refresh_t Refresh;          // Drawing of the periodic frames, NULL - by the command
+	cli_screen_cursor_t Cursor;            // State of the terminal
+	uint8_t Attr;                          // Attributes of the drawn text
+	uint32_t Last;                         // Time of the last frame, ms
+	uint32_t Period;                       // Shortest time between the frames, ms
+	unsigned int Frames;                   // Frames sent
+	unsigned int Bytes;                    // Bytes of the frames
+	unsigned int FullBytes;                // Bytes of the same frames drawn from a clear screen
+	unsigned int FrameBytes;               // Bytes of the last frame
+	unsigned int FrameFullBytes;           // Bytes of the last frame drawn from a clear screen
+} cli_screen_t;
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_SCREEN_H_ */
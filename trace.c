@@ -0,0 +1,326 @@
+/*
+*******************************************************************************
+@file	trace.c
+@brief	Trace of the input, output and commands of the instance with the
+		cycle counter timestamps, and its replay.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include <stdio.h>   /* For 'sscanf' */
+
+#include "cli.h"
+
+#if (CLI_ENABLE_TRACE == TRUE)
+
+static const char *const cli_trace_names[CLI_TRACE_EVENTS] = {
+	[CLI_TRACE_RX]       = "rx",
+	[CLI_TRACE_TX]       = "tx",
+	[CLI_TRACE_DISPATCH] = "dispatch",
+	[CLI_TRACE_RETURN]   = "return",
+};
+
+/*
+ * @brief	State of the replay: the port functions have no context.
+ */
+static struct {
+	const cli_trace_t *Trace;              // The recorded trace
+	int Input;                             // Next received byte to give
+	int InputEnd;                          // End of the received bytes given at once
+	int Output;                            // Next sent byte to compare
+	int Sent;                              // Number of the sent bytes
+	int Mismatch;                          // First different byte, (-1) - none
+} cli_trace_replay_state;
+
+static int cli_trace_replay_putchar(int ch);
+#if (CLI_USE_RING_BUFFER != TRUE)
+static int cli_trace_replay_getchar(void);
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Initialize the trace. The recording is started.
+* @note 	The timestamps are cycles of `__io_cli_cycles`, or milliseconds
+*       	of `__io_cli_millis` if the port has no cycle counter.
+* @param	trace Is a pointer (`cli_trace_t`) to the trace.
+*
+*/
+void cli_trace_init(cli_trace_t *trace) {
+	trace->Head = 0;
+	trace->Clock = (__io_cli_cycles != NULL) ? __io_cli_cycles : __io_cli_millis;
+	trace->Enabled = 1;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the number of the events kept in the trace.
+* @param	trace Is a pointer (`cli_trace_t`) to the trace.
+* @return	`int` Number of the events.
+*/
+int cli_trace_count(const cli_trace_t *trace) {
+	return (trace->Head < CLI_TRACE_SIZE) ? (int)trace->Head : CLI_TRACE_SIZE;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the event of the trace.
+* @param	trace Is a pointer (`cli_trace_t`) to the trace.
+* @param	index Number of the event from the oldest kept one.
+* @return	`cli_trace_record_t*` The event.
+*/
+const cli_trace_record_t *cli_trace_get(const cli_trace_t *trace, int index) {
+	unsigned int first = trace->Head - cli_trace_count(trace);
+	return &trace->Records[(first + index) & (CLI_TRACE_SIZE - 1)];
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the name of the event.
+* @param	event Event `cli_trace_event_t`.
+* @return	`char*` Name of the event, "?" if unknown.
+*/
+const char *cli_trace_name(int event) {
+	return ((event >= 0) && (event < CLI_TRACE_EVENTS)) ? cli_trace_names[event] : "?";
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Parse the line printed by the 'trace' command.
+* @note 	`<time> <event> <value>`, for example "1234567 rx 0x41".
+* @param	line The line.
+* @param	record The parsed event.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the line is not an event.
+*/
+int cli_trace_parse(const char *line, cli_trace_record_t *record) {
+	unsigned long time;
+	char name[16];
+	int value;
+	if (sscanf(line, "%lu %15s %i", &time, name, &value) != 3) {
+		return CLI_ERROR;
+	}
+	for (int event = 0; event < CLI_TRACE_EVENTS; event++) {
+		if (!strcmp(name, cli_trace_names[event])) {
+			record->Time = time;
+			record->Event = event;
+			record->Value = value;
+			return CLI_OK;
+		}
+	}
+	return CLI_ERROR;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Add the event with its own timestamp, for loading a saved trace.
+* @param	trace Is a pointer (`cli_trace_t`) to the trace.
+* @param	record The event.
+*
+*/
+void cli_trace_append(cli_trace_t *trace, const cli_trace_record_t *record) {
+	trace->Records[trace->Head++ & (CLI_TRACE_SIZE - 1)] = *record;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Histogram of the latency from the received byte to the next
+*       	sent byte (the echo or the reaction to the key).
+* @note 	The bin `k` counts the latencies of [2^k, 2^(k+1)) ticks, the
+*       	bin (0) also counts (0). The last bin counts all the longer ones.
+*       	The received bytes that come before the reaction are one keystroke.
+* @param	trace Is a pointer (`cli_trace_t`) to the trace.
+* @param	histogram Array of the bins, filled by the function.
+* @param	bins Number of the bins.
+* @return	`int` Number of the keystrokes measured.
+*/
+int cli_trace_latency(const cli_trace_t *trace, unsigned int *histogram, int bins) {
+	memset(histogram, 0, bins * sizeof(histogram[0]));
+	int measured = 0;
+	int waiting = 0;
+	uint32_t start = 0;
+	int count = cli_trace_count(trace);
+	for (int index = 0; index < count; index++) {
+		const cli_trace_record_t *record = cli_trace_get(trace, index);
+		if ((record->Event == CLI_TRACE_RX) && !waiting) {
+			start = record->Time;
+			waiting = 1;
+		} else if ((record->Event == CLI_TRACE_TX) && waiting) {
+			/* The difference is right even when the counter wraps */
+			uint32_t latency = record->Time - start;
+			int bin = 0;
+			while ((latency >>= 1) && (bin < bins - 1)) {
+				bin++;
+			}
+			histogram[bin]++;
+			measured++;
+			waiting = 0;
+		}
+	}
+	return measured;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Feed the recorded input to the instance and compare its output
+*       	with the recorded one.
+* @note 	For the host (Linux): the instance must be initialized and must
+*       	not be used by anything else during the replay. The received
+*       	bytes between two outputs are given at once, as they came. The
+*       	recording starts at the first received byte, the output after
+*       	the end of the trace is not compared. One replay at a time.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	trace Is a pointer (`cli_trace_t`) to the recorded trace.
+*       	Not the trace of the instance itself.
+* @param	mismatch Number of the first different sent byte, (-1) if none.
+*       	Can be NULL.
+* @retval 	`CLI_OK` (0) if the output is the same.
+* @retval   `CLI_ERROR` (!0) if the output differs.
+*/
+int cli_trace_replay(cli_t *cli, const cli_trace_t *trace, int *mismatch) {
+	if (trace == &cli->Trace) {
+		/* The trace would change while it is replayed */
+		return CLI_ERROR;
+	}
+	int count = cli_trace_count(trace);
+	int first = 0;
+	while ((first < count) && (cli_trace_get(trace, first)->Event != CLI_TRACE_RX)) {
+		first++;
+	}
+	cli_trace_replay_state.Trace = trace;
+	cli_trace_replay_state.Input = first;
+	cli_trace_replay_state.InputEnd = first;
+	cli_trace_replay_state.Output = first;
+	cli_trace_replay_state.Sent = 0;
+	cli_trace_replay_state.Mismatch = -1;
+
+	int (*io_putchar)(int) = cli->_io_putchar;
+	int (*io_getchar)(void) = cli->_io_getchar;
+	int (*io_wakeup)(void) = cli->_io_wakeup;
+	cli->_io_putchar = cli_trace_replay_putchar;
+	cli->_io_wakeup = NULL;
+#if (CLI_USE_RING_BUFFER == TRUE)
+	int (*io_txstart)(void) = cli->_io_txstart;
+	/* The instance empties the transmit ring itself */
+	cli->_io_txstart = NULL;
+#else
+	cli->_io_getchar = cli_trace_replay_getchar;
+#endif
+
+	int index = first;
+	while (index < count) {
+		if (cli_trace_get(trace, index)->Event != CLI_TRACE_RX) {
+			index++;
+			continue;
+		}
+		/* The input up to the next output */
+		int end = index;
+		while ((end < count) && (cli_trace_get(trace, end)->Event != CLI_TRACE_TX)) {
+			end++;
+		}
+#if (CLI_USE_RING_BUFFER == TRUE)
+		for (; index < end; index++) {
+			const cli_trace_record_t *record = cli_trace_get(trace, index);
+			if (record->Event != CLI_TRACE_RX) continue;
+			uint8_t byte = record->Value;
+			while (!cli_rx_push(cli, &byte, 1)) {
+				/* The ring is full: let the instance take some */
+				cli_handler(cli);
+			}
+		}
+		do {
+			cli_handler(cli);
+		} while (!cli->Idle || cli_pending(cli));
+#else
+		cli_trace_replay_state.Input = index;
+		cli_trace_replay_state.InputEnd = end;
+		do {
+			cli_handler(cli);
+		} while (!cli->Idle);
+		index = end;
+#endif
+	}
+
+	/* The recorded output that was not sent is a difference too */
+	while ((cli_trace_replay_state.Mismatch < 0) && (cli_trace_replay_state.Output < count)) {
+		if (cli_trace_get(trace, cli_trace_replay_state.Output++)->Event == CLI_TRACE_TX) {
+			cli_trace_replay_state.Mismatch = cli_trace_replay_state.Sent;
+		}
+	}
+
+	cli->_io_putchar = io_putchar;
+	cli->_io_getchar = io_getchar;
+	cli->_io_wakeup = io_wakeup;
+#if (CLI_USE_RING_BUFFER == TRUE)
+	cli->_io_txstart = io_txstart;
+#endif
+	if (mismatch != NULL) {
+		*mismatch = cli_trace_replay_state.Mismatch;
+	}
+	return (cli_trace_replay_state.Mismatch < 0) ? CLI_OK : CLI_ERROR;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Output of the instance during the replay: compare the byte with
+*       	the next recorded one.
+* @param	ch The sent byte.
+* @return	`int` (0).
+*/
+static int cli_trace_replay_putchar(int ch) {
+	const cli_trace_t *trace = cli_trace_replay_state.Trace;
+	int count = cli_trace_count(trace);
+	while (cli_trace_replay_state.Output < count) {
+		const cli_trace_record_t *record = cli_trace_get(trace, cli_trace_replay_state.Output++);
+		if (record->Event != CLI_TRACE_TX) continue;
+		if ((record->Value != (uint8_t)ch) && (cli_trace_replay_state.Mismatch < 0)) {
+			cli_trace_replay_state.Mismatch = cli_trace_replay_state.Sent;
+		}
+		break;
+	}
+	cli_trace_replay_state.Sent++;
+	return 0;
+}
+
+#if (CLI_USE_RING_BUFFER != TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Input of the instance during the replay: the recorded bytes up
+*       	to the next output.
+* @return	`int` The byte or (0) if there is no more.
+*/
+static int cli_trace_replay_getchar(void) {
+	const cli_trace_t *trace = cli_trace_replay_state.Trace;
+	while (cli_trace_replay_state.Input < cli_trace_replay_state.InputEnd) {
+		const cli_trace_record_t *record = cli_trace_get(trace, cli_trace_replay_state.Input++);
+		if (record->Event == CLI_TRACE_RX) {
+			return record->Value;
+		}
+	}
+	return 0;
+}
+#endif
+
+#endif /* CLI_ENABLE_TRACE */
@@ -0,0 +1,130 @@
+/*
+*******************************************************************************
+@file	trace.h
+@brief	Trace of the input, output and commands of the instance with the
+		cycle counter timestamps, and its replay.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_TRACE_H_
+#define CLI_TRACE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdint.h>  /* For 'uint32_t' */
+
+#include "opt.h"
+#include "io.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Events of the trace
+ */
+typedef enum {
+	CLI_TRACE_RX = 0,                      // Received byte, 'Value' - the byte
+	CLI_TRACE_TX,                          // Sent byte, 'Value' - the byte
+	CLI_TRACE_DISPATCH,                    // Command launched, 'Value' - argc
+	CLI_TRACE_RETURN,                      // Command finished, 'Value' - returned code
+	CLI_TRACE_EVENTS
+} cli_trace_event_t;
+
+/*
+ * @brief	One event of the trace
+ */
+typedef struct {
+	uint32_t Time;                         // Timestamp, cycles (wraps around)
+	uint16_t Event;                        // Event 'cli_trace_event_t'
+	uint16_t Value;                        // Byte, argc or code
+} cli_trace_record_t;
+
+/*
+ * @brief	Trace Structure definition
+ * @note	The newest events overwrite the oldest ones. Written only by
+ *      	the thread of `cli_handler`.
+ */
+typedef struct {
+	cli_trace_record_t Records[CLI_TRACE_SIZE]; // Ring of the events
+	unsigned int Head;                     // Number of the events written
+	uint8_t Enabled;                       // The events are recorded
+	uint32_t (*Clock)(void);               // Time source: cycles or milliseconds
+} cli_trace_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* Inline functions -------------------------------------------------------- */
+/**
+* @brief	Record the bytes. All of them get the same timestamp.
+* @param	trace Is a pointer (`cli_trace_t`) to the trace.
+* @param	event Event `CLI_TRACE_RX` or `CLI_TRACE_TX`.
+* @param	data The bytes.
+* @param	length Number of the bytes.
+*
+*/
+static inline void cli_trace_bytes(cli_trace_t *trace, int event, const void *data, int length) {
+	if (!trace->Enabled || (length <= 0)) return;
+	uint32_t time = (trace->Clock != NULL) ? trace->Clock() : 0;
+	const uint8_t *bytes = (const uint8_t*)data;
+	for (int i = 0; i < length; i++) {
+		cli_trace_record_t *record = &trace->Records[trace->Head++ & (CLI_TRACE_SIZE - 1)];
+		record->Time = time;
+		record->Event = event;
+		record->Value = bytes[i];
+	}
+}
+
+/**
+* @brief	Record the event.
+* @param	trace Is a pointer (`cli_trace_t`) to the trace.
+* @param	event Event `cli_trace_event_t`.
+* @param	value Value of the event.
+*
+*/
+static inline void cli_trace_event(cli_trace_t *trace, int event, int value) {
+	if (!trace->Enabled) return;
+	cli_trace_record_t *record = &trace->Records[trace->Head++ & (CLI_TRACE_SIZE - 1)];
+	record->Time = (trace->Clock != NULL) ? trace->Clock() : 0;
+	record->Event = event;
+	record->Value = value;
+}
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'trace.c'. */
+/* Function instances ------------------------------------------------------ */
+struct cli_instance;
+void cli_trace_init(cli_trace_t *trace);
+int cli_trace_count(const cli_trace_t *trace);
+const cli_trace_record_t *cli_trace_get(const cli_trace_t *trace, int index);
+const char *cli_trace_name(int event);
+int cli_trace_parse(const char *line, cli_trace_record_t *record);
+void cli_trace_append(cli_trace_t *trace, const cli_trace_record_t *record);
+int cli_trace_latency(const cli_trace_t *trace, unsigned int *histogram, int bins);
+int cli_trace_replay(struct cli_instance *cli, const cli_trace_t *trace, int *mismatch);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_TRACE_H_ */
@@ -0,0 +1,324 @@
+/*
+*******************************************************************************
+@file	variable.c
+@brief	Session variables of the CLI: a fixed hash table over a per-instance
+		arena, and the expansion of `$NAME` in the command line.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "cli.h"
+
+#if (CLI_ENABLE_VARIABLES == TRUE)
+
+#define CLI_VARIABLE_MASK     (CLI_VARIABLES_COUNT - 1)
+#define CLI_VARIABLE_DELETED  0xFFFF
+#define CLI_VARIABLE_LIVE     '+'
+#define CLI_VARIABLE_DEAD     '-'
+
+static uint32_t cli_variables_hash(const char *name, int length);
+static int cli_variables_name(char symbol);
+static int cli_variables_find(cli_variables_t *vars, const char *name, int length, uint32_t hash);
+static void cli_variables_compact(cli_variables_t *vars);
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Initial configuration of the variable store.
+* @param 	vars Is a pointer (`cli_variables_t`) to the store to be worked on.
+*
+*/
+void cli_variables_init(cli_variables_t *vars) {
+	memset(vars, 0, sizeof(cli_variables_t));
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Set the value of the variable, or add a new one.
+* @note 	The value must not point into the store: the records can be
+*       	moved to make room for the new one.
+* @param 	vars Is a pointer (`cli_variables_t`) to the store to be worked on.
+* @param	name Name of the variable: letters, digits and '_'.
+* @param	value Value of the variable.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if the name is incorrect or there is no place.
+*/
+int cli_variables_set(cli_variables_t *vars, const char *name, const char *value) {
+	int length = strlen(name);
+	if (!length) {
+		return CLI_ERROR;
+	}
+	for (int i = 0; i < length; i++) {
+		if (!cli_variables_name(name[i])) {
+			return CLI_ERROR;
+		}
+	}
+	/* The old record is replaced by a new one at the end of the arena */
+	int size = 1 + length + 1 + strlen(value) + 1;
+	uint32_t hash = cli_variables_hash(name, length);
+	int slot = cli_variables_find(vars, name, length, hash);
+	int count = vars->Count + (slot < 0);
+	if ((count > CLI_VARIABLES_COUNT * 3 / 4) || (size > CLI_VARIABLES_ARENA)) {
+		return CLI_ERROR;
+	}
+	if ((vars->Used + size > CLI_VARIABLES_ARENA) || ((slot < 0) && (count + vars->Deleted > CLI_VARIABLES_COUNT * 3 / 4))) {
+		if (slot >= 0) {
+			/* The old value is not needed, its place is taken back */
+			vars->Arena[vars->Slot[slot] - 1] = CLI_VARIABLE_DEAD;
+			vars->Slot[slot] = CLI_VARIABLE_DELETED;
+			vars->Deleted++;
+			vars->Count--;
+			slot = -1;
+		}
+		cli_variables_compact(vars);
+		if (vars->Used + size > CLI_VARIABLES_ARENA) {
+			return CLI_ERROR;
+		}
+	}
+	char *record = &vars->Arena[vars->Used];
+	record[0] = CLI_VARIABLE_LIVE;
+	memcpy(&record[1], name, length + 1);
+	strcpy(&record[1 + length + 1], value);
+	if (slot >= 0) {
+		vars->Arena[vars->Slot[slot] - 1] = CLI_VARIABLE_DEAD;
+	} else {
+		/* The first free or removed slot */
+		slot = hash & CLI_VARIABLE_MASK;
+		while ((vars->Slot[slot] != 0) && (vars->Slot[slot] != CLI_VARIABLE_DELETED)) {
+			slot = (slot + 1) & CLI_VARIABLE_MASK;
+		}
+		if (vars->Slot[slot] == CLI_VARIABLE_DELETED) {
+			vars->Deleted--;
+		}
+		vars->Count++;
+	}
+	vars->Slot[slot] = vars->Used + 1;
+	vars->Tag[slot] = hash >> 24;
+	vars->Used += size;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Remove the variable.
+* @param 	vars Is a pointer (`cli_variables_t`) to the store to be worked on.
+* @param	name Name of the variable.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no such variable.
+*/
+int cli_variables_unset(cli_variables_t *vars, const char *name) {
+	int length = strlen(name);
+	int slot = cli_variables_find(vars, name, length, cli_variables_hash(name, length));
+	if (slot < 0) {
+		return CLI_ERROR;
+	}
+	vars->Arena[vars->Slot[slot] - 1] = CLI_VARIABLE_DEAD;
+	vars->Slot[slot] = CLI_VARIABLE_DELETED;
+	vars->Deleted++;
+	vars->Count--;
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the value of the variable.
+* @param 	vars Is a pointer (`cli_variables_t`) to the store to be worked on.
+* @param	name Name of the variable (not terminated by zero).
+* @param	length Length of the name.
+* @return	`const char*` The value or NULL if there is no such variable.
+*/
+const char *cli_variables_get(cli_variables_t *vars, const char *name, int length) {
+	int slot = cli_variables_find(vars, name, length, cli_variables_hash(name, length));
+	if (slot < 0) {
+		return NULL;
+	}
+	return &vars->Arena[vars->Slot[slot] + length + 1];
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Walk over the variables in the order they were set.
+* @param 	vars Is a pointer (`cli_variables_t`) to the store to be worked on.
+* @param	position Position of the walk, (0) at the start.
+* @param	name Returns the name of the variable.
+* @param	value Returns the value of the variable.
+* @retval 	(1) if the variable is returned.
+* @retval   (0) at the end.
+*/
+int cli_variables_next(cli_variables_t *vars, int *position, const char **name, const char **value) {
+	while (*position < vars->Used) {
+		const char *record = &vars->Arena[*position];
+		int length = strlen(&record[1]);
+		*position += 1 + length + 1 + strlen(&record[1 + length + 1]) + 1;
+		if (record[0] == CLI_VARIABLE_LIVE) {
+			*name = &record[1];
+			*value = &record[1 + length + 1];
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Copy the command line with `$NAME` and `${NAME}` replaced by
+*       	the values of the variables.
+* @note 	One pass, without allocations. Unknown variables are replaced
+*       	by nothing, '$' without a name and the text in single quotes
+*       	are copied as is.
+* @param 	vars Is a pointer (`cli_variables_t`) to the store to be worked on.
+* @param	line Command line.
+* @param	out Buffer for the result.
+* @param	size Size of the buffer.
+* @return	`int` Length of the result.
+* @retval   (-1) if the result does not fit in the buffer.
+*/
+int cli_variables_expand(cli_variables_t *vars, const char *line, char *out, int size) {
+	int length = 0;
+	char quote = 0;
+	while (*line) {
+		const char *value = NULL;
+		int skip = 0;
+		if ((line[0] == '\'') || (line[0] == '"')) {
+			/* The text in single quotes is not changed */
+			if (!quote) {
+				quote = line[0];
+			} else if (quote == line[0]) {
+				quote = 0;
+			}
+		} else if ((line[0] == '$') && (quote != '\'')) {
+			int braces = (line[1] == '{');
+			const char *name = &line[1 + braces];
+			int count = 0;
+			while (cli_variables_name(name[count])) count++;
+			if (count && (!braces || (name[count] == '}'))) {
+				value = cli_variables_get(vars, name, count);
+				skip = 1 + braces + count + braces;
+				if (value == NULL) value = "";
+			}
+		}
+		if (value == NULL) {
+			/* Usual symbol */
+			if (length + 1 >= size) return -1;
+			out[length++] = *line++;
+			continue;
+		}
+		int count = strlen(value);
+		if (length + count >= size) return -1;
+		memcpy(&out[length], value, count);
+		length += count;
+		line += skip;
+	}
+	out[length] = 0;
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Hash of the name (FNV-1a).
+* @param	name Name of the variable.
+* @param	length Length of the name.
+* @return	`uint32_t` Hash.
+*/
+static uint32_t cli_variables_hash(const char *name, int length) {
+	uint32_t hash = 2166136261U;
+	for (int i = 0; i < length; i++) {
+		hash = (hash ^ (uint8_t)name[i]) * 16777619U;
+	}
+	return hash;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check the symbol of the name: letters, digits and '_'.
+* @param	symbol The symbol.
+* @retval 	(1) if the symbol can be in the name.
+*/
+static int cli_variables_name(char symbol) {
+	return ((symbol >= 'a') && (symbol <= 'z')) || ((symbol >= 'A') && (symbol <= 'Z')) ||
+			((symbol >= '0') && (symbol <= '9')) || (symbol == '_');
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the slot of the variable.
+* @param 	vars Is a pointer (`cli_variables_t`) to the store to be worked on.
+* @param	name Name of the variable (not terminated by zero).
+* @param	length Length of the name.
+* @param	hash Hash of the name.
+* @return	`int` Index of the slot.
+* @retval   (-1) if there is no such variable.
+*/
+static int cli_variables_find(cli_variables_t *vars, const char *name, int length, uint32_t hash) {
+	int slot = hash & CLI_VARIABLE_MASK;
+	for (int i = 0; i < CLI_VARIABLES_COUNT; i++) {
+		uint16_t offset = vars->Slot[slot];
+		if (offset == 0) {
+			break;
+		}
+		if ((offset != CLI_VARIABLE_DELETED) && (vars->Tag[slot] == (uint8_t)(hash >> 24))) {
+			const char *record = &vars->Arena[offset];
+			if (!strncmp(record, name, length) && (record[length] == 0)) {
+				return slot;
+			}
+		}
+		slot = (slot + 1) & CLI_VARIABLE_MASK;
+	}
+	return -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Move the records together over the removed ones and build the
+*       	slots again.
+* @param 	vars Is a pointer (`cli_variables_t`) to the store to be worked on.
+*
+*/
+static void cli_variables_compact(cli_variables_t *vars) {
+	memset(vars->Slot, 0, sizeof(vars->Slot));
+	vars->Deleted = 0;
+	int from = 0;
+	int to = 0;
+	while (from < vars->Used) {
+		char *record = &vars->Arena[from];
+		int length = strlen(&record[1]);
+		int size = 1 + length + 1 + strlen(&record[1 + length + 1]) + 1;
+		if (record[0] == CLI_VARIABLE_LIVE) {
+			memmove(&vars->Arena[to], record, size);
+			uint32_t hash = cli_variables_hash(&vars->Arena[to + 1], length);
+			int slot = hash & CLI_VARIABLE_MASK;
+			while (vars->Slot[slot] != 0) {
+				slot = (slot + 1) & CLI_VARIABLE_MASK;
+			}
+			vars->Slot[slot] = to + 1;
+			vars->Tag[slot] = hash >> 24;
+			to += size;
+		}
+		from += size;
+	}
+	vars->Used = to;
+}
+
+#endif /* CLI_ENABLE_VARIABLES */
@@ -0,0 +1,73 @@
+/*
+*******************************************************************************
+@file	variable.h
+@brief	Session variables of the CLI: a fixed hash table over a per-instance
+		arena, and the expansion of `$NAME` in the command line.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_VARIABLE_H_
+#define CLI_VARIABLE_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include <stdint.h>  /* For 'uint16_t' */
+
+#include "opt.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Variable store Structure definition
+ * @note	The records `<flag><name>\0<value>\0` are placed one after another
+ *      	in the arena. The slots are an open-addressing table (linear
+ *      	probing) with the offset of the record and 8 bits of its hash,
+ *      	so a lookup compares the names only when the bits match.
+ *      	Removed records are compacted when the arena is full.
+ */
+typedef struct {
+	uint16_t Slot[CLI_VARIABLES_COUNT];    // Offset of the record + 1, 0 - free, 'CLI_VARIABLE_DELETED' - removed
+	uint8_t Tag[CLI_VARIABLES_COUNT];      // High bits of the hash of the name
+	char Arena[CLI_VARIABLES_ARENA];       // Records of the variables
+	uint16_t Used;                         // Bytes of the arena in use (with removed records)
+	uint16_t Count;                        // Number of the variables
+	uint16_t Deleted;                      // Number of the removed slots
+} cli_variables_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'variable.c'. */
+/* Function instances ------------------------------------------------------ */
+void cli_variables_init(cli_variables_t *vars);
+int cli_variables_set(cli_variables_t *vars, const char *name, const char *value);
+int cli_variables_unset(cli_variables_t *vars, const char *name);
+const char *cli_variables_get(cli_variables_t *vars, const char *name, int length);
+int cli_variables_next(cli_variables_t *vars, int *position, const char **name, const char **value);
+int cli_variables_expand(cli_variables_t *vars, const char *line, char *out, int size);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_VARIABLE_H_ */
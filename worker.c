@@ -0,0 +1,424 @@
+/*
+*******************************************************************************
+@file	worker.c
+@brief	Worker threads for heavy commands on the POSIX build.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#include "worker.h"
+
+#if (CLI_ENABLE_WORKERS == TRUE)
+#include <pthread.h>
+
+/* Typedef ------------------------------------------------------------------*/
+/*
+ * @brief	Job states
+ */
+typedef enum {
+	CLI_JOB_FREE = 0,
+	CLI_JOB_QUEUED,
+	CLI_JOB_RUNNING,
+	CLI_JOB_DONE
+} cli_job_state_t;
+
+/*
+ * @brief	Job Structure definition
+ */
+typedef struct {
+	cli_job_state_t State;                 // State of the job
+	cli_t *Cli;                            // Instance that launched the job
+	const cli_command_t *Command;          // Command to run
+#if (CLI_ENABLE_PLUGINS == TRUE)
+	cli_plugin_t *Plugin;                  // Plugin of the command, kept until the job is reported
+#endif
+	unsigned int Sequence;                 // Launch order
+	int  Id;                               // Number shown to the user
+	int  Background;                       // Launched with '&'
+	int  Result;                           // Value returned by the command
+	int  Argc;                             // Number of arguments
+	char *Argv[CLI_BUFFER_SIZE / 2 + 1];   // Arguments (point to 'Line')
+	char Line[CLI_BUFFER_SIZE];            // Arguments separated by zeros
+#if (CLI_ENABLE_EMIT == TRUE)
+	cli_emit_t Emit;                       // Emitter of the command, apart from the main loop
+#endif
+	char Output[CLI_WORKER_OUTPUT_SIZE];   // Output ring of the command
+	size_t Head;                           // Write position in 'Output'
+	size_t Tail;                           // Read position in 'Output'
+} cli_job_t;
+
+/*
+ * @brief	Worker pool Structure definition
+ */
+typedef struct {
+	pthread_mutex_t Lock;                  // Protects the jobs
+	pthread_cond_t Work;                   // Signal for the workers: a job is queued
+	pthread_cond_t Space;                  // Signal for the workers: the output is taken
+	pthread_once_t Once;                   // Start of the threads
+	pthread_t Threads[CLI_WORKER_THREADS]; // Worker threads
+	cli_job_t Jobs[CLI_WORKER_JOBS];       // Jobs
+	unsigned int Sequence;                 // Counter of the launched jobs
+} cli_worker_pool_t;
+/*---------------------------------------------------------------------------*/
+
+
+/* Instance Definition ----------------------------------------------------- */
+static cli_worker_pool_t cli_pool = {
+	.Lock = PTHREAD_MUTEX_INITIALIZER,
+	.Work = PTHREAD_COND_INITIALIZER,
+	.Space = PTHREAD_COND_INITIALIZER,
+	.Once = PTHREAD_ONCE_INIT,
+};
+
+/* The job run by the current thread */
+static __thread cli_job_t *cli_worker_job;
+/*---------------------------------------------------------------------------*/
+
+/* Instances of static functions ------------------------------------------- */
+static void cli_worker_start(void);
+static void *cli_worker_thread(void *arg);
+static cli_job_t *cli_worker_oldest(cli_t *cli, cli_job_state_t state);
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Hand the command over to the worker pool.
+* @note 	The arguments are copied to the job, so the line buffer can be
+*       	used again at once.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	command Command to run.
+* @param	argc Number of arguments.
+* @param	argv Array of argument values.
+* @param	background If (0), the instance waits for the job to finish.
+* @retval 	`CLI_OK` (0) if success.
+* @retval   `CLI_ERROR` (!0) if there is no free job.
+*/
+int cli_worker_submit(cli_t *cli, const cli_command_t *command, int argc, char *argv[], int background) {
+	pthread_once(&cli_pool.Once, cli_worker_start);
+	pthread_mutex_lock(&cli_pool.Lock);
+	cli_job_t *job = NULL;
+	for (int i = 0; i < CLI_WORKER_JOBS; i++) {
+		if (cli_pool.Jobs[i].State == CLI_JOB_FREE) {
+			job = &cli_pool.Jobs[i];
+			break;
+		}
+	}
+	if (job == NULL) {
+		pthread_mutex_unlock(&cli_pool.Lock);
+		cli_printf(cli, "No free jobs. Change the value of CLI_WORKER_JOBS in the 'opt.h' file.\r\n");
+		return CLI_ERROR;
+	}
+
+	/* Each argument is copied on its own: they need not lie in one buffer
+	 * (the arguments added to an alias lie in the line) */
+	size_t length = 0;
+	int fits = (argc < (int)(sizeof(job->Argv) / sizeof(job->Argv[0])));
+	for (int i = 0; fits && (i < argc); i++) {
+		size_t size = strlen(argv[i]) + 1;
+		if (size > sizeof(job->Line) - length) {
+			fits = 0;
+			break;
+		}
+		job->Argv[i] = memcpy(&job->Line[length], argv[i], size);
+		length += size;
+	}
+	if (!fits) {
+		pthread_mutex_unlock(&cli_pool.Lock);
+		cli_printf(cli, "The arguments are too long for a job. Change the value of CLI_BUFFER_SIZE in the 'opt.h' file.\r\n");
+		return CLI_ERROR;
+	}
+	job->Argv[argc] = NULL;
+	job->Argc = argc;
+	job->Cli = cli;
+	job->Command = command;
+#if (CLI_ENABLE_PLUGINS == TRUE)
+	job->Plugin = cli_plugin_enter(command);
+#endif
+	job->Sequence = cli_pool.Sequence++;
+	job->Id = (int)(job - cli_pool.Jobs) + 1;
+	job->Background = background;
+	job->Result = 0;
+	job->Head = 0;
+	job->Tail = 0;
+#if (CLI_ENABLE_EMIT == TRUE)
+	job->Emit.Format = cli->Emit.Format;
+	job->Emit.Depth = 0;
+#endif
+	job->State = CLI_JOB_QUEUED;
+	pthread_cond_signal(&cli_pool.Work);
+	pthread_mutex_unlock(&cli_pool.Lock);
+
+	if (background) {
+		cli_printf(cli, "[%d]\r\n", job->Id);
+	} else {
+		/* The prompt is printed when the job is done */
+		cli->Waiting = job->Id;
+		cli->Streaming = 1;
+	}
+	return CLI_OK;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Put the output of the command run by a worker in its job.
+* @note 	Called from `cli_write`. If the output buffer is full, the worker
+*       	waits until `cli_handler` sends it.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @param	data Data to be sent.
+* @param	length Number of bytes to send.
+* @return	`int` Number of bytes written or (-1) if the current thread is
+*       	not a worker of this instance.
+*/
+int cli_worker_write(cli_t *cli, const char *data, int length) {
+	cli_job_t *job = cli_worker_job;
+	if ((job == NULL) || (job->Cli != cli)) {
+		return -1;
+	}
+	pthread_mutex_lock(&cli_pool.Lock);
+	for (int i = 0; i < length; i++) {
+		while (job->Head - job->Tail >= sizeof(job->Output)) {
+			pthread_cond_wait(&cli_pool.Space, &cli_pool.Lock);
+		}
+		job->Output[job->Head++ % sizeof(job->Output)] = data[i];
+	}
+	pthread_mutex_unlock(&cli_pool.Lock);
+	if (cli->_io_wakeup != NULL) {
+		cli->_io_wakeup();
+	}
+	return length;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check that the caller is a job of the instance.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` (1) if it is called by the command run by a worker.
+*/
+int cli_worker_self(cli_t *cli) {
+	cli_job_t *job = cli_worker_job;
+	return (job != NULL) && (job->Cli == cli);
+}
+
+#if (CLI_ENABLE_EMIT == TRUE)
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Get the emitter of the job of the caller.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`cli_emit_t*` The emitter of the job or NULL if the caller is
+*       	not a job of the instance.
+*/
+cli_emit_t *cli_worker_emit(cli_t *cli) {
+	cli_job_t *job = cli_worker_job;
+	return ((job != NULL) && (job->Cli == cli)) ? &job->Emit : NULL;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Send the output of the jobs of the instance to the console.
+* @note 	Called from `cli_handler`. The jobs are reported in the order
+*       	in which they were launched. Never waits for the workers.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	(0) if the instance can process the input.
+* @retval   (!0) if the instance waits for a foreground job.
+*/
+int cli_worker_poll(cli_t *cli) {
+	char chunk[64];
+	int budget = CLI_WORKER_OUTPUT_SIZE;
+	while (budget > 0) {
+		pthread_mutex_lock(&cli_pool.Lock);
+		cli_job_t *job = cli_worker_oldest(cli, CLI_JOB_FREE);
+		if (job == NULL) {
+			pthread_mutex_unlock(&cli_pool.Lock);
+			if (cli->Waiting == CLI_WORKER_WAIT_ALL) {
+				cli->Waiting = 0;
+			}
+			break;
+		}
+		int length = 0;
+		while ((length < (int)sizeof(chunk)) && (job->Tail != job->Head)) {
+			chunk[length++] = job->Output[job->Tail++ % sizeof(job->Output)];
+		}
+		int done = (length == 0) && (job->State == CLI_JOB_DONE);
+		int id = job->Id;
+		int result = job->Result;
+		int background = job->Background;
+		const char *name = job->Command->Name;
+#if (CLI_ENABLE_PLUGINS == TRUE)
+		cli_plugin_t *plugin = done ? job->Plugin : NULL;
+#endif
+		if (length) {
+			pthread_cond_broadcast(&cli_pool.Space);
+		} else if (done) {
+			job->State = CLI_JOB_FREE;
+		}
+		pthread_mutex_unlock(&cli_pool.Lock);
+
+		if (!length && !done) {
+			/* The oldest job is still running */
+			break;
+		}
+		if (!cli->Streaming) {
+			/* Erase the line being edited */
+			cli_printf(cli, "\r%s", CONSOLE_CLEAR_STRING);
+			cli->Streaming = 1;
+		}
+		if (length) {
+			cli_write(cli, chunk, length);
+			cli->Streaming = (chunk[length - 1] == '\n') ? 1 : 2;
+			budget -= length;
+			continue;
+		}
+		if (cli->Streaming == 2) {
+			cli_printf(cli, "\r\n");
+			cli->Streaming = 1;
+		}
+		if (result) {
+			cli_printf(cli, "Function '%s' return %d [0x%.8x]\r\n", name, result, result);
+		}
+		if (background) {
+			cli_printf(cli, "[%d] Done %s\r\n", id, name);
+		}
+#if (CLI_ENABLE_PLUGINS == TRUE)
+		/* The name of the command can lie in the plugin */
+		cli_plugin_leave(plugin);
+#endif
+		if (cli->Waiting == id) {
+			cli->Waiting = 0;
+		}
+	}
+	if (cli->Streaming && !cli->Waiting) {
+		if (cli->Streaming == 2) {
+			cli_printf(cli, "\r\n");
+		}
+		cli->Streaming = 0;
+		cli_print_line(cli);
+	}
+	return cli->Waiting;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Check if there is output or a finished job to report.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @retval 	(0) if there is nothing to report.
+* @retval   (!0) if `cli_worker_poll` has work.
+*/
+int cli_worker_pending(cli_t *cli) {
+	pthread_mutex_lock(&cli_pool.Lock);
+	cli_job_t *job = cli_worker_oldest(cli, CLI_JOB_FREE);
+	int pending = (job != NULL) && ((job->Tail != job->Head) || (job->State == CLI_JOB_DONE));
+	pthread_mutex_unlock(&cli_pool.Lock);
+	return pending;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Print the list of the jobs of the instance.
+* @param 	cli Is a pointer (`cli_t`) to the instance to be worked on.
+* @return	`int` Number of the jobs.
+*/
+int cli_worker_list(cli_t *cli) {
+	static const char *states[] = { "Free", "Queued", "Running", "Done" };
+	int count = 0;
+	pthread_mutex_lock(&cli_pool.Lock);
+	for (int i = 0; i < CLI_WORKER_JOBS; i++) {
+		cli_job_t *job = &cli_pool.Jobs[i];
+		if ((job->State == CLI_JOB_FREE) || (job->Cli != cli)) continue;
+		cli_printf(cli, "[%d] %-8s", job->Id, states[job->State]);
+		for (int j = 0; j < job->Argc; j++) {
+			cli_printf(cli, " %s", job->Argv[j]);
+		}
+		cli_printf(cli, "\r\n");
+		count++;
+	}
+	pthread_mutex_unlock(&cli_pool.Lock);
+	return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Start the worker threads.
+*
+*/
+static void cli_worker_start(void) {
+	for (int i = 0; i < CLI_WORKER_THREADS; i++) {
+		pthread_create(&cli_pool.Threads[i], NULL, cli_worker_thread, NULL);
+	}
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Worker thread: runs the queued jobs in the launch order.
+* @param	arg Not used.
+*
+*/
+static void *cli_worker_thread(void *arg) {
+	pthread_mutex_lock(&cli_pool.Lock);
+	while (1) {
+		cli_job_t *job = cli_worker_oldest(NULL, CLI_JOB_QUEUED);
+		if (job == NULL) {
+			pthread_cond_wait(&cli_pool.Work, &cli_pool.Lock);
+			continue;
+		}
+		job->State = CLI_JOB_RUNNING;
+		pthread_mutex_unlock(&cli_pool.Lock);
+
+		cli_worker_job = job;
+		int result = job->Command->Function(job->Cli, job->Argc, job->Argv);
+		cli_worker_job = NULL;
+
+		pthread_mutex_lock(&cli_pool.Lock);
+		job->Result = result;
+		job->State = CLI_JOB_DONE;
+		if (job->Cli->_io_wakeup != NULL) {
+			job->Cli->_io_wakeup();
+		}
+	}
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+* @brief	Find the oldest job.
+* @note 	Must be called with the lock held.
+* @param 	cli Instance of the job or NULL for any instance.
+* @param	state State of the job. `CLI_JOB_FREE` means any busy job.
+* @return	`cli_job_t*` The job or NULL.
+*/
+static cli_job_t *cli_worker_oldest(cli_t *cli, cli_job_state_t state) {
+	cli_job_t *oldest = NULL;
+	for (int i = 0; i < CLI_WORKER_JOBS; i++) {
+		cli_job_t *job = &cli_pool.Jobs[i];
+		if (job->State == CLI_JOB_FREE) continue;
+		if ((state != CLI_JOB_FREE) && (job->State != state)) continue;
+		if ((cli != NULL) && (job->Cli != cli)) continue;
+		if ((oldest == NULL) || ((int)(job->Sequence - oldest->Sequence) < 0)) {
+			oldest = job;
+		}
+	}
+	return oldest;
+}
+#endif
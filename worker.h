@@ -0,0 +1,60 @@
+/*
+*******************************************************************************
+@file	worker.h
+@brief	Worker threads for heavy commands on the POSIX build. The output of
+		the commands is buffered per job and streamed back to the CLI.
+*******************************************************************************
+@attention
+
+The MIT License
+
+Copyright (c) 2024 Martouf (Kolegov A.A.)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************
+*/
+
+#ifndef CLI_WORKER_H_
+#define CLI_WORKER_H_
+
+/* Includes ---------------------------------------------------------------- */
+#include "cli.h"
+/*---------------------------------------------------------------------------*/
+
+
+/* Define ------------------------------------------------------------------ */
+/* Special value of `cli_t::Waiting`: wait for all the jobs of the instance */
+#define CLI_WORKER_WAIT_ALL   (-1)
+/*---------------------------------------------------------------------------*/
+
+
+/* NOTE A description of the functions is provided in 'worker.c'. */
+/* Function instances ------------------------------------------------------ */
+int cli_worker_submit(cli_t *cli, const cli_command_t *command, int argc, char *argv[], int background);
+int cli_worker_write(cli_t *cli, const char *data, int length);
+int cli_worker_self(cli_t *cli);
+#if (CLI_ENABLE_EMIT == TRUE)
+cli_emit_t *cli_worker_emit(cli_t *cli);
+#endif
+int cli_worker_poll(cli_t *cli);
+int cli_worker_pending(cli_t *cli);
+int cli_worker_list(cli_t *cli);
+/*---------------------------------------------------------------------------*/
+
+#endif /* CLI_WORKER_H_ */